@@ -0,0 +1,195 @@
+#pragma once
+#include <deque>
+#include "FaceAnimation/PackedFormat.h"
+
+namespace Data
+{
+	//Background builder for face animation binaries.
+	//When the cache is cold, or a binary is missing from a warm cache, FaceAnim::Parse only gathers the
+	//frame-based data for the face animation and queues it here under its file name. Once Global::Init has published all data,
+	//a low-priority thread converts each queued animation to runtime data and writes it to the AnimCache.
+	//If an animation is requested before it has been built, Await() moves it to the front of the queue
+	//and blocks until it is available.
+	class AnimBuildQueue
+	{
+	public:
+		static AnimBuildQueue* GetSingleton()
+		{
+			static AnimBuildQueue singleton;
+			return &singleton;
+		}
+
+		~AnimBuildQueue()
+		{
+			Stop();
+		}
+
+		static bool WriteBinary(const std::string& name, const FaceAnimation::FrameBasedAnimData& animData)
+		{
+			return AnimCache::AddFile(name, FaceAnimation::PackedFormat::Encode(animData));
+		}
+
+		//If the name is already queued, the data with the higher load priority is kept, same as Global's IDMaps.
+		//This matters when a warm XML cache maps every definition of a face anim to the same file name.
+		void Enqueue(const std::string& name, FaceAnimation::FrameBasedAnimData data, int32_t loadPriority)
+		{
+			std::unique_lock l{ lock };
+			auto [iter, inserted] = pending.try_emplace(name);
+			if (inserted) {
+				order.push_back(name);
+			} else if (iter->second.loadPriority >= loadPriority) {
+				return;
+			}
+			iter->second.loadPriority = loadPriority;
+			iter->second.data = std::move(data);
+		}
+
+		//Drops any queued builds that aren't in the keep set, i.e. face anims that were overridden by a higher load priority.
+		void Prune(const std::unordered_set<std::string>& keep)
+		{
+			std::unique_lock l{ lock };
+			std::erase_if(pending, [&](const auto& p) { return !keep.contains(p.first); });
+		}
+
+		//Moves the listed file names to the front of the queue, keeping their relative order.
+		void Prioritize(const std::vector<std::string>& names)
+		{
+			std::unique_lock l{ lock };
+			for (auto iter = names.rbegin(); iter != names.rend(); iter++) {
+				if (pending.contains(*iter)) {
+					order.push_front(*iter);
+				}
+			}
+		}
+
+		void Start()
+		{
+			Stop();
+			std::unique_lock l{ lock };
+			if (pending.empty()) {
+				return;
+			}
+
+			threadRunning = true;
+			threadHandle = std::thread(&AnimBuildQueue::MainRoutine, this);
+			SetThreadPriority(threadHandle.native_handle(), THREAD_PRIORITY_LOWEST);
+		}
+
+		void Stop()
+		{
+			std::unique_lock l{ lock };
+			if (threadHandle.joinable()) {
+				threadPendingCancel = true;
+				l.unlock();
+				threadHandle.join();
+				l.lock();
+			}
+			threadPendingCancel = false;
+		}
+
+		void Clear()
+		{
+			Stop();
+			std::unique_lock l{ lock };
+			pending.clear();
+			order.clear();
+			buildFinished.notify_all();
+		}
+
+		//Blocks until the binary for the provided file name has been written to the AnimCache.
+		//Returns immediately if the file isn't queued or being built.
+		void Await(const std::string& name)
+		{
+			std::unique_lock l{ lock };
+			bool prioritized = false;
+			while (pending.contains(name) || building.contains(name)) {
+				if (!threadRunning) {
+					//Nothing is working through the queue, so build it on this thread instead.
+					if (RunJob(l, name)) {
+						continue;
+					}
+				} else if (!prioritized) {
+					order.push_front(name);
+					prioritized = true;
+				}
+
+				buildFinished.wait(l);
+			}
+		}
+
+		size_t QPending()
+		{
+			std::unique_lock l{ lock };
+			return pending.size();
+		}
+
+	private:
+		struct Job
+		{
+			int32_t loadPriority = 0;
+			FaceAnimation::FrameBasedAnimData data;
+		};
+
+		// Takes the named job out of the queue and builds it. lock is released while building.
+		bool RunJob(std::unique_lock<std::mutex>& l, const std::string& name)
+		{
+			auto iter = pending.find(name);
+			if (iter == pending.end()) {
+				return false;
+			}
+
+			auto data = std::move(iter->second.data);
+			pending.erase(iter);
+			building.insert(name);
+			l.unlock();
+
+			if (!WriteBinary(name, data)) {
+				logger::warn("Failed to build face animation binary '{}'.", name);
+			}
+
+			l.lock();
+			building.erase(name);
+			buildFinished.notify_all();
+			return true;
+		}
+
+		void MainRoutine()
+		{
+			logger::trace("Face animation build thread started.");
+			auto timer = Utility::CreatePerfCounter();
+			size_t count = 0;
+			std::unique_lock l{ lock };
+
+			while (!threadPendingCancel) {
+				// Prioritized names are pushed to the front without being removed from their original spot,
+				// so skip over anything that has already been built.
+				while (!order.empty() && !pending.contains(order.front())) {
+					order.pop_front();
+				}
+
+				if (order.empty()) {
+					break;
+				}
+
+				std::string name = std::move(order.front());
+				order.pop_front();
+				if (RunJob(l, name)) {
+					count++;
+				}
+			}
+
+			threadRunning = false;
+			buildFinished.notify_all();
+			logger::info("Built {} face animation binaries in the background in {:.0f}ms", count, Utility::QueryPerfCounterTime(timer));
+		}
+
+		std::mutex lock;
+		std::condition_variable buildFinished;
+		std::thread threadHandle;
+		bool threadRunning = false;
+		std::atomic<bool> threadPendingCancel = false;
+		std::unordered_map<std::string, Job> pending;
+		std::unordered_set<std::string> building;
+		std::deque<std::string> order;
+	};
+}
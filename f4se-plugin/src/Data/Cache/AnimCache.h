@@ -149,12 +149,37 @@ namespace Data
 			fileTable.insert({ filename, { offset, size } });
 			fileHandle.flush();
 
+			if (preloadNames.contains(filename)) {
+				memoryTable[filename] = data;
+			}
+
 			loaded = true;
 			return true;
 		}
 
+		static bool Contains(const std::string& filename) {
+			std::unique_lock l{ lock };
+			return fileTable.contains(filename);
+		}
+
+		//Keeps the provided files in memory, so that GetFile doesn't need to read them from disk.
+		//Files that don't exist yet are kept once they are added.
+		static void Preload(const std::vector<std::string>& filenames) {
+			std::unique_lock l{ lock };
+			for (auto& f : filenames) {
+				preloadNames.insert(f);
+				if (fileTable.contains(f)) {
+					memoryTable[f] = GetFile(f);
+				}
+			}
+		}
+
 		static std::string GetFile(const std::string& filename) {
 			std::unique_lock l{ lock };
+			if (auto iter = memoryTable.find(filename); iter != memoryTable.end()) {
+				return iter->second;
+			}
+
 			std::vector<char> result;
 
 			auto iter = fileTable.find(filename);
@@ -183,6 +208,8 @@ namespace Data
 				fileHandle.close();
 
 			fileTable.clear();
+			memoryTable.clear();
+			preloadNames.clear();
 			loaded = false;
 		}
 
@@ -253,6 +280,8 @@ namespace Data
 		inline static safe_mutex lock;
 		inline static Mode fileMode = kRead;
 		inline static std::unordered_map<std::string, FileTableEntry> fileTable;
+		inline static std::unordered_map<std::string, std::string> memoryTable;
+		inline static std::unordered_set<std::string> preloadNames;
 		inline static bool loaded = false;
 		inline static std::fstream fileHandle;
 	};
@@ -0,0 +1,148 @@
+#pragma once
+#include <list>
+#include "FaceAnimation/PackedFormat.h"
+
+namespace Data
+{
+	//Bounded LRU cache of decoded face animations, keyed by AnimCache file name.
+	//Decoded data is immutable and shared between every actor playing the same animation,
+	//playback state lives in each FaceAnimation instance. Evicted entries stay alive for as
+	//long as an instance still references them.
+	//Total size is limited by iFaceAnimCacheBudgetKB, a budget of 0 disables caching.
+	//If iFaceAnimBakeRate is set, lookup tables are built for each animation as it's decoded.
+	class DecodedAnimCache
+	{
+	public:
+		struct Metrics
+		{
+			uint64_t hits = 0;
+			uint64_t misses = 0;
+			uint64_t evictions = 0;
+			size_t entries = 0;
+			size_t bytes = 0;
+
+			double QHitRate() const
+			{
+				const uint64_t total = hits + misses;
+				return total > 0 ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+			}
+		};
+
+		static std::shared_ptr<const FaceAnimation::AnimationData> Get(const std::string& filename)
+		{
+			if (auto result = Find(filename); result != nullptr) {
+				return result;
+			}
+
+			AnimBuildQueue::GetSingleton()->Await(filename);
+			auto decoded = std::make_shared<FaceAnimation::AnimationData>();
+			if (!FaceAnimation::PackedFormat::Decode(AnimCache::GetFile(filename), *decoded)) {
+				logger::warn("Failed to load AnimationData from '{}', the file is truncated or corrupt.", filename);
+				return nullptr;
+			}
+
+			if (auto rate = Settings::Values.iFaceAnimBakeRate.load(); rate > 0) {
+				auto report = decoded->BakeLUTs(rate, FACEANIM_BAKE_MAX_ERROR);
+				logger::trace("Baked face animation '{}' at {}Hz: {} timelines baked, {} kept exact, {:.1f}KB tables vs {:.1f}KB keys, max error {:.4f}",
+					filename, rate, report.baked, report.rejected, report.lutBytes / 1024.0, report.keyBytes / 1024.0, report.maxError);
+			}
+
+			return Insert(filename, std::move(decoded));
+		}
+
+		static bool Contains(const std::string& filename)
+		{
+			std::unique_lock l{ lock };
+			return entries.contains(filename);
+		}
+
+		static void Clear()
+		{
+			std::unique_lock l{ lock };
+			if (metrics.hits + metrics.misses > 0) {
+				LogMetrics_NonThreadSafe();
+			}
+			entries.clear();
+			lru.clear();
+			metrics = Metrics();
+		}
+
+		static Metrics QMetrics()
+		{
+			std::unique_lock l{ lock };
+			return metrics;
+		}
+
+	private:
+		struct Entry
+		{
+			std::shared_ptr<const FaceAnimation::AnimationData> data;
+			size_t bytes;
+			std::list<std::string>::iterator lruIter;
+		};
+
+		static std::shared_ptr<const FaceAnimation::AnimationData> Find(const std::string& filename)
+		{
+			std::unique_lock l{ lock };
+			auto iter = entries.find(filename);
+			if (iter == entries.end()) {
+				return nullptr;
+			}
+
+			lru.splice(lru.begin(), lru, iter->second.lruIter);
+			metrics.hits++;
+			return iter->second.data;
+		}
+
+		static std::shared_ptr<const FaceAnimation::AnimationData> Insert(const std::string& filename, std::shared_ptr<const FaceAnimation::AnimationData> data)
+		{
+			std::unique_lock l{ lock };
+			metrics.misses++;
+
+			// Another thread may have decoded the same file in the meantime.
+			if (auto iter = entries.find(filename); iter != entries.end()) {
+				lru.splice(lru.begin(), lru, iter->second.lruIter);
+				return iter->second.data;
+			}
+
+			const size_t budget = static_cast<size_t>(Settings::Values.iFaceAnimCacheBudgetKB.load()) * 1024;
+			const size_t bytes = data->QMemoryUsage() + filename.capacity();
+			if (bytes > budget) {
+				return data;
+			}
+
+			while (metrics.bytes + bytes > budget && !lru.empty()) {
+				auto evictIter = entries.find(lru.back());
+				metrics.bytes -= evictIter->second.bytes;
+				entries.erase(evictIter);
+				lru.pop_back();
+				metrics.evictions++;
+			}
+
+			lru.push_front(filename);
+			entries.insert({ filename, { data, bytes, lru.begin() } });
+			metrics.bytes += bytes;
+			metrics.entries = entries.size();
+
+			logger::trace("Decoded face animation '{}' ({} keys, {} bytes).", filename, data->QKeyCount(), bytes);
+			LogMetrics_NonThreadSafe(true);
+			return data;
+		}
+
+		static void LogMetrics_NonThreadSafe(bool trace = false)
+		{
+			auto msg = std::format("Decoded face animation cache: {} entries, {:.1f}KB, {} hits, {} misses ({:.1f}% hit rate), {} evictions",
+				entries.size(), metrics.bytes / 1024.0, metrics.hits, metrics.misses, metrics.QHitRate() * 100.0, metrics.evictions);
+			if (trace) {
+				logger::trace("{}", msg);
+			} else {
+				logger::info("{}", msg);
+			}
+		}
+
+		inline static safe_mutex lock;
+		inline static std::unordered_map<std::string, Entry> entries;
+		inline static std::list<std::string> lru;
+		inline static Metrics metrics;
+	};
+}
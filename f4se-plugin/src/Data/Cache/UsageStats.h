@@ -0,0 +1,183 @@
+#pragma once
+
+namespace Data
+{
+	//Opt-in local log of which positions, animations & face anims are actually played.
+	//Used during data init to build or preload the most used face animation binaries first.
+	//Nothing is read or written unless bRecordUsageStats is enabled.
+	class UsageStats
+	{
+	public:
+		enum Kind : uint8_t
+		{
+			kPosition,
+			kAnimation,
+			kFaceAnim,
+			kKindCount
+		};
+
+		struct Entry
+		{
+			uint32_t count = 0;
+			int64_t lastUsed = 0;
+
+			template <class Archive>
+			void serialize(Archive& ar, const uint32_t)
+			{
+				ar(count, lastUsed);
+			}
+		};
+
+		struct Log
+		{
+			std::array<std::unordered_map<std::string, Entry>, kKindCount> entries;
+
+			template <class Archive>
+			void serialize(Archive& ar, const uint32_t)
+			{
+				ar(entries);
+			}
+		};
+
+		inline static const std::string statsPath{ USERDATA_DIR + "_UsageStats.bin" };
+
+		static bool IsEnabled()
+		{
+			return Settings::Values.bRecordUsageStats;
+		}
+
+		static void Load()
+		{
+			std::unique_lock l{ lock };
+			log = Log();
+			dirty = false;
+			if (!IsEnabled() || !std::filesystem::exists(statsPath))
+				return;
+
+			std::ifstream file(statsPath, std::ios::binary);
+			if (!file.is_open() || !file.good()) {
+				logger::warn("Failed to open {}", statsPath);
+				return;
+			}
+
+			try {
+				cereal::BinaryInputArchive archive(file);
+				archive(log);
+			} catch (std::exception& e) {
+				logger::warn("Failed to load usage stats. Full Message: {}", e.what());
+				log = Log();
+			}
+		}
+
+		//Called from the save callback. Only copies the log, the file is written by a background thread.
+		static void Flush()
+		{
+			std::unique_lock l{ lock };
+			if (!dirty)
+				return;
+
+			pendingWrite = std::make_unique<Log>(log);
+			dirty = false;
+			if (!writerRunning) {
+				writerRunning = true;
+				std::thread(&UsageStats::WriterRoutine).detach();
+			}
+		}
+
+		static void Record(Kind k, const std::string& id)
+		{
+			if (!IsEnabled() || id.empty())
+				return;
+
+			std::unique_lock l{ lock };
+			auto& e = log.entries[k][id];
+			e.count++;
+			e.lastUsed = std::time(nullptr);
+			dirty = true;
+		}
+
+		//Returns up to maxCount IDs of the given kind, hottest first.
+		static std::vector<std::string> GetHottest(Kind k, size_t maxCount)
+		{
+			std::vector<std::pair<double, std::string>> scored;
+			{
+				std::unique_lock l{ lock };
+				auto now = std::time(nullptr);
+				for (auto& iter : log.entries[k]) {
+					scored.push_back({ GetHeat(iter.second, now), iter.first });
+				}
+			}
+
+			std::sort(scored.begin(), scored.end(), [](auto& a, auto& b) { return a.first > b.first; });
+			if (scored.size() > maxCount) {
+				scored.resize(maxCount);
+			}
+
+			std::vector<std::string> result;
+			for (auto& s : scored) {
+				result.push_back(std::move(s.second));
+			}
+			return result;
+		}
+
+	private:
+		//Only one writer runs at a time, so an older snapshot can never overwrite a newer one.
+		//Writes to a temporary file first so that exiting mid-write doesn't leave a truncated log behind.
+		static void WriterRoutine()
+		{
+			std::unique_lock l{ lock };
+			while (pendingWrite) {
+				auto snapshot = std::move(pendingWrite);
+				l.unlock();
+				bool written = Write(*snapshot);
+				l.lock();
+				if (!written && !pendingWrite) {
+					//Try again on the next save.
+					dirty = true;
+				}
+			}
+			writerRunning = false;
+		}
+
+		static bool Write(const Log& snapshot)
+		{
+			const std::string tempPath = statsPath + ".tmp";
+			{
+				std::ofstream file(tempPath, std::ios::binary);
+				if (!file.is_open()) {
+					logger::warn("Failed to open {}", tempPath);
+					return false;
+				}
+
+				try {
+					cereal::BinaryOutputArchive archive(file);
+					archive(snapshot);
+				} catch (std::exception& e) {
+					logger::warn("Failed to save usage stats. Full Message: {}", e.what());
+					return false;
+				}
+			}
+
+			std::error_code ec;
+			std::filesystem::rename(tempPath, statsPath, ec);
+			if (ec) {
+				logger::warn("Failed to replace {}. Full Message: {}", statsPath, ec.message());
+				return false;
+			}
+			return true;
+		}
+
+		// Play count, halved for every 30 days since last use.
+		static double GetHeat(const Entry& e, int64_t now)
+		{
+			double days = static_cast<double>(std::max<int64_t>(now - e.lastUsed, 0)) / 86400.0;
+			return static_cast<double>(e.count) * std::exp2(-days / 30.0);
+		}
+
+		inline static safe_mutex lock;
+		inline static Log log;
+		inline static bool dirty = false;
+		inline static std::unique_ptr<Log> pendingWrite;
+		inline static bool writerRunning = false;
+	};
+}
@@ -42,11 +42,12 @@ namespace Data
 			std::vector<CacheEntry> files;
 			std::unordered_map<std::string, AnimInfoData> animDataMap;
 			uint64_t nextFaceAnimId = 0;
+			uint32_t faceAnimFormat = FACEANIM_FORMAT_VERSION;
 
 			template <class Archive>
 			void serialize(Archive& ar, const uint32_t)
 			{
-				ar(files, animDataMap, nextFaceAnimId);
+				ar(files, animDataMap, nextFaceAnimId, faceAnimFormat);
 			}
 		};
 
@@ -96,6 +97,14 @@ namespace Data
 				return false;
 			}
 
+			// The AnimCache was built with a different face anim binary format.
+			if (primaryCache.faceAnimFormat != FACEANIM_FORMAT_VERSION) {
+				logger::info("Cache format is outdated.");
+				cacheValid = false;
+				primaryCache = Cache();
+				return false;
+			}
+
 			return true;
 		}
 
@@ -119,7 +128,7 @@ namespace Data
 			std::unique_lock l{ lock };
 			auto iter = primaryCache.animDataMap.find(id);
 			if (iter != primaryCache.animDataMap.end() && iter->second.loadPriority < loadPriority) {
-				iter->second.filename = filename;
+				iter->second = { filename, loadPriority };
 			} else if (iter == primaryCache.animDataMap.end()) {
 				primaryCache.animDataMap.insert({ id, { filename, loadPriority } });
 			}
@@ -2,6 +2,22 @@
 
 #define SETTINGS_INI_PATH "Data\\F4SE\\Plugins\\NAF.ini"
 #define USERDATA_DIR "Data\\NAF\\"s
+#define MAX_PRELOADED_FACE_ANIMS 32
+#define FACEANIM_FORMAT_VERSION 2
+#define FACEANIM_MORPH_COUNT 54
+#define FACEANIM_BAKE_MAX_ERROR 0.005f
+#define FACEANIM_BAKE_CHECK_STEPS 16
+#define FACEANIM_LOADER_THREADS 2
+#define FACEANIM_PREFETCH_MIN_WEIGHT 0.05f
+#define FACEANIM_PREEVAL_MAX_DRIFT 0.002
+#define FACEANIM_PREEVAL_MIN_PARALLEL 4
+#define FACEANIM_PREEVAL_SHARE_STEP 0.001
+#define FACEANIM_LOD_WRITE_EPSILON 0.001f
+#define TIMER_COALESCE_WINDOW 0.001
+#define TIMER_EXECUTOR_THREADS 2
+#define FRAME_TIMER_MAX_DELTA 0.25
+#define SCENE_UPDATE_MIN_PARALLEL 8
+#define SCENE_INLINE_ACTORS 6
 
 #define PEVENT_SCENE_START "NAF::SceneStarted"
 #define PEVENT_SCENE_END "NAF::SceneEnded"
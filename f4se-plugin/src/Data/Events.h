@@ -1,5 +1,9 @@
 #pragma once
-#include <any>
+
+namespace Scene
+{
+	enum SyncState : uint8_t;
+}
 
 namespace Data
 {
@@ -32,7 +36,8 @@ namespace Data
 			HUD_Q_KEY_UP,
 			HUD_E_KEY_DOWN,
 			HUD_E_KEY_UP,
-			SETTINGS_CHANGED
+			SETTINGS_CHANGED,
+			EVENT_TYPE_COUNT
 		};
 
 		struct ScenePositionData
@@ -49,47 +54,149 @@ namespace Data
 			bool cancel = false;
 		};
 
-		typedef std::any EventData;
+		//Every payload an event can carry, receivers read theirs with std::get_if.
+		typedef std::variant<
+			std::monostate,
+			uint64_t,
+			std::pair<uint64_t, std::string>,
+			std::pair<uint64_t, float>,
+			std::pair<uint64_t, Scene::SyncState>,
+			ScenePositionData,
+			SceneTreeItemData>
+			EventData;
 		typedef std::function<void(event_type, EventData&)> EventFunctor;
-		typedef std::list<EventFunctor>::iterator EventRegistration;
+
+		struct Subscriber
+		{
+			EventFunctor func;
+			std::atomic<bool> active = true;
+			//Calls to func in progress on any thread. Counted before active is checked, so Unsubscribe can wait them out.
+			std::atomic<uint32_t> running = 0;
+		};
+
+		//Returned by Subscribe, unsubscribing through it doesn't need to search the event's subscribers.
+		struct EventRegistration
+		{
+			std::shared_ptr<Subscriber> sub;
+			event_type evnt = 0;
+		};
 
 		static EventRegistration Subscribe(event_type evnt, EventFunctor receiver) {
+			if (evnt >= EVENT_TYPE_COUNT) {
+				logger::warn("Tried to subscribe to unknown event type {}", evnt);
+				return {};
+			}
+
+			auto sub = std::make_shared<Subscriber>();
+			sub->func = std::move(receiver);
+
 			std::unique_lock l{ lock };
-			registrations[evnt].push_back(receiver);
-			return --registrations[evnt].end();
+			auto& e = events[evnt];
+			auto current = e.subscribers.load(std::memory_order_acquire);
+			auto next = std::make_shared<SubscriberList>(*current);
+			next->push_back(sub);
+			e.subscribers.store(std::move(next), std::memory_order_release);
+			return { sub, evnt };
 		}
 
-		static void Unsubscribe(event_type evnt, EventRegistration reg)
+		//Once this returns, the receiver won't be called again & isn't running on any other thread.
+		//Receivers may unsubscribe themselves while running, but not wait on each other from different threads.
+		static void Unsubscribe(const EventRegistration& reg)
 		{
+			if (!reg.sub) {
+				return;
+			}
+
+			//Sends check active after counting themselves as running, so either they see it cleared or this sees them.
+			//Every caller waits, including a second one for the same registration.
+			const bool wasActive = reg.sub->active.exchange(false);
+			const uint32_t ownCalls = QOwnCalls(reg.sub.get());
+			while (reg.sub->running.load() > ownCalls) {
+				std::this_thread::yield();
+			}
+			if (!wasActive) {
+				return;
+			}
+
+			//Inactive subscribers stay in the list until they outnumber active ones.
 			std::unique_lock l{ lock };
-			if (registrations.contains(evnt)) {
-				for (auto iter = registrations[evnt].begin(); iter != registrations[evnt].end();) {
-					if (std::addressof(*iter) == std::addressof(*reg)) {
-						iter = registrations[evnt].erase(iter);
-						break;
-					} else {
-						iter++;
+			auto& e = events[reg.evnt];
+			e.inactive++;
+			auto current = e.subscribers.load(std::memory_order_acquire);
+			if (e.inactive * 2 > current->size()) {
+				auto next = std::make_shared<SubscriberList>();
+				next->reserve(current->size() - e.inactive);
+				for (auto& s : *current) {
+					if (s->active) {
+						next->push_back(s);
 					}
 				}
+				e.subscribers.store(std::move(next), std::memory_order_release);
+				e.inactive = 0;
 			}
 		}
 
+		//Never locks. Receivers see the subscribers as of the start of the call, minus any unsubscribed since.
 		static void SendMutable(event_type evnt, EventData& data)
 		{
-			std::unique_lock l{ lock };
-			if (registrations.contains(evnt)) {
-				for (auto& f : registrations[evnt]) {
-					f(evnt, data);
+			if (evnt >= EVENT_TYPE_COUNT) {
+				return;
+			}
+
+			const auto subs = events[evnt].subscribers.load(std::memory_order_acquire);
+			for (auto& s : *subs) {
+				if (!s->active.load(std::memory_order_relaxed)) {
+					continue;
 				}
+				s->running.fetch_add(1);
+				if (s->active.load()) {
+					const DispatchFrame frame{ s.get(), dispatchTop };
+					dispatchTop = &frame;
+					s->func(evnt, data);
+					dispatchTop = frame.prev;
+				}
+				s->running.fetch_sub(1, std::memory_order_release);
 			}
 		}
 
-		static void Send(event_type evnt, const EventData& data = false) {
-			EventData e = data;
-			SendMutable(evnt, e);
+		static void Send(event_type evnt, EventData data = {}) {
+			SendMutable(evnt, data);
 		}
 	private:
-		inline static std::unordered_map<event_type, std::list<EventFunctor>> registrations;
+		typedef std::vector<std::shared_ptr<Subscriber>> SubscriberList;
+
+		struct EventSubscribers
+		{
+			EventSubscribers() :
+				subscribers(std::make_shared<SubscriberList>()), inactive(0)
+			{
+			}
+
+			//Copied & swapped on every change, so senders never see it change under them.
+			std::atomic<std::shared_ptr<SubscriberList>> subscribers;
+			//Guarded by lock.
+			size_t inactive;
+		};
+
+		//Receiver calls the current thread is in the middle of, innermost first.
+		struct DispatchFrame
+		{
+			const Subscriber* sub;
+			const DispatchFrame* prev;
+		};
+
+		static uint32_t QOwnCalls(const Subscriber* sub)
+		{
+			uint32_t result = 0;
+			for (auto f = dispatchTop; f != nullptr; f = f->prev) {
+				result += (f->sub == sub);
+			}
+			return result;
+		}
+
+		inline static std::array<EventSubscribers, EVENT_TYPE_COUNT> events;
+		inline static thread_local const DispatchFrame* dispatchTop = nullptr;
+		//Only taken to change subscriber lists.
 		inline static safe_mutex lock;
 	};
 
@@ -100,10 +207,9 @@ namespace Data
 		struct RegContainer
 		{
 			Events::EventRegistration reg;
-			Events::event_type evnt;
 
 			~RegContainer() {
-				Events::Unsubscribe(evnt, reg);
+				Events::Unsubscribe(reg);
 			}
 		};
 
@@ -112,7 +218,6 @@ namespace Data
 		{
 			std::unique_lock l{ eventRegistrationlock };
 			auto container = std::make_unique<RegContainer>();
-			container->evnt = evnt;
 			container->reg = Events::Subscribe(evnt, Events::EventFunctor(std::bind(receiver, static_cast<T*>(this), std::placeholders::_1, std::placeholders::_2)));
 			eventRegistrations[evnt].push_back(std::move(container));
 		}
@@ -37,6 +37,9 @@ namespace Data
 #include "XMLUtil.h"
 #include "Cache/XMLCache.h"
 #include "Cache/AnimCache.h"
+#include "Cache/AnimBuildQueue.h"
+#include "Cache/DecodedAnimCache.h"
+#include "Cache/UsageStats.h"
 #include "Data/Forms.h"
 #include "Data/User/IdentifiableObject.h"
 #include "Data/User/Tag.h"
@@ -218,10 +221,10 @@ namespace Data
 					bool match = true;
 
 					for (size_t i = 0; i < a->slots.size(); i++) {
-						const auto& s = a->slots[i];
-						if (s.gender != Any) {
-							const auto it = filterResult.find(s.rootBehavior);
-							if (it == filterResult.end() || !it->second.SubtractGender(s.gender)) {
+						const ActorGender gender = a->slots.GetGender(i);
+						if (gender != Any) {
+							const auto it = filterResult.find(a->slots.GetRootBehavior(i));
+							if (it == filterResult.end() || !it->second.SubtractGender(gender)) {
 								match = false;
 								break;
 							}
@@ -232,9 +235,8 @@ namespace Data
 
 					if (match) {
 						for (const auto& i : anyIndices) {
-							const auto& s = a->slots[i];
-							const auto it = filterResult.find(s.rootBehavior);
-							if (it == filterResult.end() || !it->second.SubtractGender(s.gender)) {
+							const auto it = filterResult.find(a->slots.GetRootBehavior(i));
+							if (it == filterResult.end() || !it->second.SubtractGender(a->slots.GetGender(i))) {
 								match = false;
 								break;
 							}
@@ -264,6 +266,7 @@ namespace Data
 		static void Init(bool verbose = true)
 		{
 			Settings::Load();
+			UsageStats::Load();
 
 			try {
 				std::filesystem::create_directories(USERDATA_DIR);
@@ -289,7 +292,7 @@ namespace Data
 
 			Utility::StartPerformanceCounter();
 			
-			if (!XMLCache::IsCacheValid(xmlFiles) || !XMLCache::LoadCache() || !AnimCache::Load()) {
+			if (!XMLCache::IsCacheValid(xmlFiles) || !XMLCache::LoadCache()) {
 				AnimCache::Delete();
 				XMLCache::Delete();
 				if (verbose)
@@ -299,6 +302,10 @@ namespace Data
 				}
 			} else {
 				FaceAnim::nextFileId = XMLCache::primaryCache.nextFaceAnimId;
+				// Binaries missing from the AnimCache are queued again by FaceAnim::Parse, the rest of the cache stays.
+				if (!AnimCache::Load()) {
+					AnimCache::Delete();
+				}
 			}
 
 			concurrency::parallel_for_each(XMLCache::primaryCache.files.begin(), XMLCache::primaryCache.files.end(), [&](auto& iter) {
@@ -309,7 +316,32 @@ namespace Data
 			});
 
 			XMLCache::primaryCache.nextFaceAnimId = FaceAnim::nextFileId;
+
+			// Face anims that were overridden by a higher load priority don't need to be built.
+			std::unordered_set<std::string> faceAnimFiles;
+			for (auto& info : XMLCache::primaryCache.animDataMap) {
+				faceAnimFiles.insert(info.second.filename);
+			}
+			AnimBuildQueue::GetSingleton()->Prune(faceAnimFiles);
+			if (verbose && XMLCache::IsCacheValid()) {
+				if (auto missing = AnimBuildQueue::GetSingleton()->QPending(); missing > 0)
+					logger::info("{} face animation binaries are missing from the cache, rebuilding them in the background.", missing);
+			}
+
+			// Build the most used face anims first, and keep them in memory for the first scenes.
+			if (UsageStats::IsEnabled()) {
+				std::vector<std::string> hotFaceAnimFiles;
+				for (auto& id : UsageStats::GetHottest(UsageStats::kFaceAnim, MAX_PRELOADED_FACE_ANIMS)) {
+					if (auto iter = XMLCache::primaryCache.animDataMap.find(id); iter != XMLCache::primaryCache.animDataMap.end()) {
+						hotFaceAnimFiles.push_back(iter->second.filename);
+					}
+				}
+				AnimBuildQueue::GetSingleton()->Prioritize(hotFaceAnimFiles);
+				AnimCache::Preload(hotFaceAnimFiles);
+			}
+
 			XMLCache::Flush();
+			AnimBuildQueue::GetSingleton()->Start();
 
 			if (verbose) {
 				auto performanceSeconds = Utility::GetPerformanceCounter();
@@ -331,6 +363,8 @@ namespace Data
 
 			auto timer = Utility::CreatePerfCounter();
 			logger::info("Rebuilding cache...");
+			AnimBuildQueue::GetSingleton()->Clear();
+			DecodedAnimCache::Clear();
 			if (rebuildFiles) {
 				XMLCache::Delete();
 				AnimCache::Delete();
@@ -517,8 +551,12 @@ namespace Data
 			concurrency::parallel_for_each(Animations.begin(), Animations.end(), [&](const auto& pair) {
 				auto& a = *pair.second.second;
 
-				for (auto it = a.slots.begin(); it != a.slots.end(); it++) {
-					auto& s = *it;
+				for (size_t i = 0; i < a.slots.size(); i++) {
+					if (!a.slots.HasFlag(i, Animation::SlotTable::kIdleRequiresConvert) && !a.slots.HasFlag(i, Animation::SlotTable::kBehaviorRequiresConvert)) {
+						continue;
+					}
+
+					auto s = a.slots.Get(i);
 
 					if (s.idleRequiresConvert) {
 						size_t delimiterPos = s.idle.find(IDLE_DELIMITER);
@@ -546,9 +584,22 @@ namespace Data
 						}
 						s.behaviorRequiresConvert = false;
 					}
+
+					a.slots.Set(i, s);
 				}
 			});
 
+			if (verbose) {
+				size_t numSlots = 0;
+				size_t slotBytes = 0;
+				for (auto& pair : Animations) {
+					numSlots += pair.second.second->slots.size();
+					slotBytes += pair.second.second->slots.QMemoryUsage();
+				}
+				logger::info("Animation slot storage: {} slots in {:.1f}KB, string pool {:.1f}KB ({:.1f}KB as individual slots).", numSlots,
+					slotBytes / 1024.0, Misc::StringPool::QMemoryUsage() / 1024.0, (numSlots * sizeof(Animation::Slot)) / 1024.0);
+			}
+
 			//Check that all Positions refer to a valid base Animation.
 
 			std::vector<std::string> pendingDeletes;
@@ -36,6 +36,8 @@ namespace Data
 
 		struct SettingValues
 		{
+			SettingValues() {}
+
 			std::atomic<bool> bUseLookAtCam = false;
 			ThreadSafeString sLookAtCamTarget = "HEAD";
 
@@ -44,6 +46,16 @@ namespace Data
 			std::atomic<bool> bHeadPartMorphPatch = false;
 			ThreadSafeString sHeadPartPatchType = "";
 			ThreadSafeString sHeadPartPatchTriPath = "";
+
+			std::atomic<bool> bRecordUsageStats = false;
+			std::atomic<uint32_t> iFaceAnimCacheBudgetKB = 16384;
+			std::atomic<uint32_t> iFaceAnimBakeRate = 0;
+			std::atomic<uint32_t> iFacePrefetchBudgetKB = 4096;
+			std::atomic<uint32_t> iFacePreEvalThreads = 3;
+			std::atomic<uint32_t> iFaceLODFullDistance = 1500;
+			std::atomic<uint32_t> iFaceLODFrozenDistance = 6000;
+			std::atomic<uint32_t> iFaceLODReducedInterval = 3;
+			std::atomic<uint32_t> iSceneUpdateThreads = 0;
 		};
 
 		struct UnsafeSettingValues
@@ -105,6 +117,15 @@ namespace Data
 				{ VAR_NAME(Values.sHeadPartPatchType), Values.sHeadPartPatchType.get() },
 				{ VAR_NAME(Values.sHeadPartPatchTriPath), Values.sHeadPartPatchTriPath.get() },
 				{ VAR_NAME(Values.iDefaultSceneDuration), std::format("{}", Values.iDefaultSceneDuration.load()) },
+				{ VAR_NAME(Values.bRecordUsageStats), Values.bRecordUsageStats ? "true" : "false" },
+				{ VAR_NAME(Values.iFaceAnimCacheBudgetKB), std::format("{}", Values.iFaceAnimCacheBudgetKB.load()) },
+				{ VAR_NAME(Values.iFaceAnimBakeRate), std::format("{}", Values.iFaceAnimBakeRate.load()) },
+				{ VAR_NAME(Values.iFacePrefetchBudgetKB), std::format("{}", Values.iFacePrefetchBudgetKB.load()) },
+				{ VAR_NAME(Values.iFacePreEvalThreads), std::format("{}", Values.iFacePreEvalThreads.load()) },
+				{ VAR_NAME(Values.iFaceLODFullDistance), std::format("{}", Values.iFaceLODFullDistance.load()) },
+				{ VAR_NAME(Values.iFaceLODFrozenDistance), std::format("{}", Values.iFaceLODFrozenDistance.load()) },
+				{ VAR_NAME(Values.iFaceLODReducedInterval), std::format("{}", Values.iFaceLODReducedInterval.load()) },
+				{ VAR_NAME(Values.iSceneUpdateThreads), std::format("{}", Values.iSceneUpdateThreads.load()) },
 			};
 
 			WriteINI(file, SaveMap);
@@ -140,6 +161,15 @@ namespace Data
 			{ VAR_NAME(Values.sHeadPartPatchType), [](auto& s) { Values.sHeadPartPatchType = s; } },
 			{ VAR_NAME(Values.sHeadPartPatchTriPath), [](auto& s) { Values.sHeadPartPatchTriPath = s; } },
 			{ VAR_NAME(Values.iDefaultSceneDuration), [](auto& s) { Values.iDefaultSceneDuration = ParseU32(s, 30); } },
+			{ VAR_NAME(Values.bRecordUsageStats), [](auto& s) { Values.bRecordUsageStats = ParseBool(s); } },
+			{ VAR_NAME(Values.iFaceAnimCacheBudgetKB), [](auto& s) { Values.iFaceAnimCacheBudgetKB = ParseU32(s, 16384); } },
+			{ VAR_NAME(Values.iFaceAnimBakeRate), [](auto& s) { Values.iFaceAnimBakeRate = ParseU32(s, 0); } },
+			{ VAR_NAME(Values.iFacePrefetchBudgetKB), [](auto& s) { Values.iFacePrefetchBudgetKB = ParseU32(s, 4096); } },
+			{ VAR_NAME(Values.iFacePreEvalThreads), [](auto& s) { Values.iFacePreEvalThreads = ParseU32(s, 3); } },
+			{ VAR_NAME(Values.iFaceLODFullDistance), [](auto& s) { Values.iFaceLODFullDistance = ParseU32(s, 1500); } },
+			{ VAR_NAME(Values.iFaceLODFrozenDistance), [](auto& s) { Values.iFaceLODFrozenDistance = ParseU32(s, 6000); } },
+			{ VAR_NAME(Values.iFaceLODReducedInterval), [](auto& s) { Values.iFaceLODReducedInterval = ParseU32(s, 3); } },
+			{ VAR_NAME(Values.iSceneUpdateThreads), [](auto& s) { Values.iSceneUpdateThreads = ParseU32(s, 0); } },
 		};
 
 		static std::unordered_map<std::string, std::string> ParseINI(std::istream& a_stream) {
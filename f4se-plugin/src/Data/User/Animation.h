@@ -1,5 +1,6 @@
 #pragma once
 #include "Misc/MathUtil.h"
+#include "Misc/StringPool.h"
 
 namespace Data
 {
@@ -42,8 +43,8 @@ namespace Data
 					ar(hasVal, val);
 				}
 			private:
-				bool hasVal;
-				T val;
+				bool hasVal = false;
+				T val{};
 			};
 			
 			ActorGender gender;
@@ -70,58 +71,332 @@ namespace Data
 				return result;
 			}
 
-			template <typename T>
-			static void OptionalSet(Scene::ActorPropertyMap& m, Scene::PropType pTy, integrated_optional<T> val) {
-				if (val.has_value()) {
-					m[pTy].value = val.value();
-				} else {
-					m.erase(pTy);
-				}
+			static RE::TESIdleForm* GetIdle(const std::string& editorId) {
+				RE::TESIdleForm* result = RE::TESForm::GetFormByEditorID<RE::TESIdleForm>(editorId);
+				if (!result)
+					result = Data::Forms::LooseIdleStop;
+				return result;
 			}
 
-			template <typename T>
-			static void OptionalApply(RE::Actor* a, integrated_optional<T> val)
+			template <class Archive>
+			void serialize(Archive& ar, const uint32_t)
 			{
-				if (val.has_value()) {
-					val.value().Apply(a);
-				}
+				ar(rootBehavior, gender, idle, dynamicIdle, faceAnim, morphs, startEquipSet, stopEquipSet, actions);
+			}
+		};
+
+		//Column-wise storage for the slots of an Animation. Strings are interned, and optional values are
+		//tracked with a presence mask. Morphs, actions & offsets are rarely set, so they're stored out of line,
+		//keyed by slot index. Each slot costs ~28 bytes plus any out of line data.
+		//Use Get/Set to read or write a whole Slot, the other accessors are for hot paths that only need one column.
+		class SlotTable
+		{
+		public:
+			typedef Misc::StringPool::ID StringID;
+
+			enum Flag : uint8_t
+			{
+				kDynamicIdle = 1 << 0,
+				kLoopFaceAnim = 1 << 1,
+				kBehaviorRequiresConvert = 1 << 2,
+				kIdleRequiresConvert = 1 << 3,
+				kHasFaceAnim = 1 << 4,
+				kHasStartEquipSet = 1 << 5,
+				kHasStopEquipSet = 1 << 6,
+				kHasScale = 1 << 7
+			};
+
+			size_t size() const
+			{
+				return flags.size();
+			}
+
+			bool empty() const
+			{
+				return flags.empty();
 			}
 
-			void Apply(RE::Actor* a, Scene::ActorPropertyMap& m) const {
+			void reserve(size_t count)
+			{
+				genders.reserve(count);
+				flags.reserve(count);
+				rootBehaviors.reserve(count);
+				idles.reserve(count);
+				faceAnims.reserve(count);
+				equipSets.reserve(count);
+				scales.reserve(count);
+			}
+
+			void push_back(const Slot& s)
+			{
+				genders.push_back(static_cast<int8_t>(s.gender));
+				flags.push_back(0);
+				rootBehaviors.push_back(0);
+				idles.push_back(0);
+				faceAnims.push_back(0);
+				equipSets.push_back({ 0, 0 });
+				scales.push_back(1.0f);
+				Set(size() - 1, s);
+			}
+
+			void erase(size_t i)
+			{
+				genders.erase(std::next(genders.begin(), i));
+				flags.erase(std::next(flags.begin(), i));
+				rootBehaviors.erase(std::next(rootBehaviors.begin(), i));
+				idles.erase(std::next(idles.begin(), i));
+				faceAnims.erase(std::next(faceAnims.begin(), i));
+				equipSets.erase(std::next(equipSets.begin(), i));
+				scales.erase(std::next(scales.begin(), i));
+				morphs.erase_slot(i);
+				actions.erase_slot(i);
+				offsets.erase_slot(i);
+			}
+
+			void clear()
+			{
+				(*this) = SlotTable();
+			}
+
+			ActorGender GetGender(size_t i) const
+			{
+				return static_cast<ActorGender>(genders[i]);
+			}
+
+			StringID GetRootBehaviorID(size_t i) const
+			{
+				return rootBehaviors[i];
+			}
+
+			const std::string& GetRootBehavior(size_t i) const
+			{
+				return Misc::StringPool::Get(rootBehaviors[i]);
+			}
+
+			const std::string& GetIdle(size_t i) const
+			{
+				return Misc::StringPool::Get(idles[i]);
+			}
+
+			const std::string& GetFaceAnim(size_t i) const
+			{
+				return Misc::StringPool::Get(faceAnims[i]);
+			}
+
+			bool HasFlag(size_t i, Flag f) const
+			{
+				return (flags[i] & f) != 0;
+			}
+
+			Slot Get(size_t i) const
+			{
+				Slot result;
+				const uint8_t f = flags[i];
+				result.gender = GetGender(i);
+				result.dynamicIdle = (f & kDynamicIdle) != 0;
+				result.loopFaceAnim = (f & kLoopFaceAnim) != 0;
+				result.behaviorRequiresConvert = (f & kBehaviorRequiresConvert) != 0;
+				result.idleRequiresConvert = (f & kIdleRequiresConvert) != 0;
+				result.rootBehavior = GetRootBehavior(i);
+				result.idle = GetIdle(i);
+				GetOptional(result.faceAnim, (f & kHasFaceAnim) != 0, faceAnims[i]);
+				GetOptional(result.startEquipSet, (f & kHasStartEquipSet) != 0, equipSets[i].first);
+				GetOptional(result.stopEquipSet, (f & kHasStopEquipSet) != 0, equipSets[i].second);
+				result.customScale.set_has_value((f & kHasScale) != 0);
+				result.customScale.value() = scales[i];
+				morphs.get(i, result.morphs);
+				actions.get(i, result.actions);
+				offsets.get(i, result.offset);
+				return result;
+			}
+
+			void Set(size_t i, const Slot& s)
+			{
+				uint8_t f = 0;
+				SetFlag(f, kDynamicIdle, s.dynamicIdle);
+				SetFlag(f, kLoopFaceAnim, s.loopFaceAnim);
+				SetFlag(f, kBehaviorRequiresConvert, s.behaviorRequiresConvert);
+				SetFlag(f, kIdleRequiresConvert, s.idleRequiresConvert);
+				SetFlag(f, kHasFaceAnim, s.faceAnim.has_value());
+				SetFlag(f, kHasStartEquipSet, s.startEquipSet.has_value());
+				SetFlag(f, kHasStopEquipSet, s.stopEquipSet.has_value());
+				SetFlag(f, kHasScale, s.customScale.has_value());
+
+				genders[i] = static_cast<int8_t>(s.gender);
+				flags[i] = f;
+				rootBehaviors[i] = Misc::StringPool::Intern(s.rootBehavior);
+				idles[i] = Misc::StringPool::Intern(s.idle);
+				faceAnims[i] = s.faceAnim.has_value() ? Misc::StringPool::Intern(s.faceAnim.value()) : 0;
+				equipSets[i] = {
+					s.startEquipSet.has_value() ? Misc::StringPool::Intern(s.startEquipSet.value()) : 0,
+					s.stopEquipSet.has_value() ? Misc::StringPool::Intern(s.stopEquipSet.value()) : 0
+				};
+				scales[i] = s.customScale.has_value() ? s.customScale.value() : 1.0f;
+				morphs.set(i, s.morphs);
+				actions.set(i, s.actions);
+				offsets.set(i, s.offset);
+			}
+
+			void Apply(size_t i, RE::Actor* a, Scene::ActorPropertyMap& m) const
+			{
 				if (!a) {
 					return;
 				}
 
-				if (dynamicIdle) {
-					m[Scene::PropType::kDynIdle].value = idle;
+				const uint8_t f = flags[i];
+				if (f & kDynamicIdle) {
+					m.set(Scene::PropType::kDynIdle, GetIdle(i));
 					m.erase(Scene::PropType::kIdle);
 				} else {
-					m[Scene::PropType::kIdle].value = GetIdle();
+					m.set(Scene::PropType::kIdle, Scene::SerializableIdle{ Slot::GetIdle(GetIdle(i)) });
 					m.erase(Scene::PropType::kDynIdle);
 				}
 
-				m[Scene::PropType::kLoopFaceAnim].value = loopFaceAnim;
-				OptionalSet(m, Scene::kFaceAnim, faceAnim);
-				OptionalApply(a, morphs);
-				OptionalSet(m, Scene::kStartEquipSet, startEquipSet);
-				OptionalSet(m, Scene::kStopEquipSet, stopEquipSet);
-				OptionalSet(m, Scene::kAction, actions);
-				OptionalSet(m, Scene::kOffset, offset);
-				OptionalSet(m, Scene::kScale, customScale);
+				m.set(Scene::PropType::kLoopFaceAnim, (f & kLoopFaceAnim) != 0);
+				ApplyString(m, Scene::kFaceAnim, (f & kHasFaceAnim) != 0, faceAnims[i]);
+				if (auto mrph = morphs.find(i); mrph != nullptr) {
+					mrph->Apply(a);
+				}
+				ApplyString(m, Scene::kStartEquipSet, (f & kHasStartEquipSet) != 0, equipSets[i].first);
+				ApplyString(m, Scene::kStopEquipSet, (f & kHasStopEquipSet) != 0, equipSets[i].second);
+				if (auto act = actions.find(i); act != nullptr) {
+					m.set(Scene::kAction, *act);
+				} else {
+					m.erase(Scene::kAction);
+				}
+				if (auto off = offsets.find(i); off != nullptr) {
+					m.set(Scene::kOffset, *off);
+				} else {
+					m.erase(Scene::kOffset);
+				}
+				if (f & kHasScale) {
+					m.set(Scene::kScale, scales[i]);
+				} else {
+					m.erase(Scene::kScale);
+				}
 			}
 
-			RE::TESIdleForm* GetIdle() const {
-				RE::TESIdleForm* result = RE::TESForm::GetFormByEditorID<RE::TESIdleForm>(idle);
-				if (!result)
-					result = Data::Forms::LooseIdleStop;
-				return result;
+			size_t QMemoryUsage() const
+			{
+				return sizeof(SlotTable) +
+				       genders.capacity() * sizeof(int8_t) +
+				       flags.capacity() * sizeof(uint8_t) +
+				       (rootBehaviors.capacity() + idles.capacity() + faceAnims.capacity()) * sizeof(StringID) +
+				       equipSets.capacity() * sizeof(std::pair<StringID, StringID>) +
+				       scales.capacity() * sizeof(float) +
+				       morphs.QMemoryUsage() + actions.QMemoryUsage() + offsets.QMemoryUsage();
 			}
 
 			template <class Archive>
-			void serialize(Archive& ar, const uint32_t)
+			void save(Archive& ar, const uint32_t) const
 			{
-				ar(rootBehavior, gender, idle, dynamicIdle, faceAnim, morphs, startEquipSet, stopEquipSet, actions);
+				std::vector<Slot> result;
+				result.reserve(size());
+				for (size_t i = 0; i < size(); i++) {
+					result.push_back(Get(i));
+				}
+				ar(result);
+			}
+
+			template <class Archive>
+			void load(Archive& ar, const uint32_t)
+			{
+				std::vector<Slot> in;
+				ar(in);
+				clear();
+				reserve(in.size());
+				for (auto& s : in) {
+					push_back(s);
+				}
 			}
+
+		private:
+			//Values for a small subset of slots, stored as (slot index, value) pairs.
+			template <typename T>
+			class SparseColumn
+			{
+			public:
+				const T* find(size_t i) const
+				{
+					for (auto& e : entries) {
+						if (e.first == i) {
+							return &e.second;
+						}
+					}
+					return nullptr;
+				}
+
+				void get(size_t i, Slot::integrated_optional<T>& out) const
+				{
+					if (auto v = find(i); v != nullptr) {
+						out = *v;
+					} else {
+						out.set_has_value(false);
+					}
+				}
+
+				void set(size_t i, const Slot::integrated_optional<T>& in)
+				{
+					std::erase_if(entries, [&](auto& e) { return e.first == i; });
+					if (in.has_value()) {
+						entries.push_back({ static_cast<uint32_t>(i), in.value() });
+					}
+				}
+
+				void erase_slot(size_t i)
+				{
+					std::erase_if(entries, [&](auto& e) { return e.first == i; });
+					for (auto& e : entries) {
+						if (e.first > i) {
+							e.first--;
+						}
+					}
+				}
+
+				size_t QMemoryUsage() const
+				{
+					return entries.capacity() * sizeof(std::pair<uint32_t, T>);
+				}
+
+			private:
+				std::vector<std::pair<uint32_t, T>> entries;
+			};
+
+			static void SetFlag(uint8_t& f, Flag flag, bool v)
+			{
+				if (v) {
+					f |= flag;
+				}
+			}
+
+			static void GetOptional(Slot::integrated_optional<std::string>& out, bool present, StringID id)
+			{
+				if (present) {
+					out = Misc::StringPool::Get(id);
+				} else {
+					out.set_has_value(false);
+				}
+			}
+
+			static void ApplyString(Scene::ActorPropertyMap& m, Scene::PropType pTy, bool present, StringID id)
+			{
+				if (present) {
+					m.set(pTy, Misc::StringPool::Get(id));
+				} else {
+					m.erase(pTy);
+				}
+			}
+
+			std::vector<int8_t> genders;
+			std::vector<uint8_t> flags;
+			std::vector<StringID> rootBehaviors;
+			std::vector<StringID> idles;
+			std::vector<StringID> faceAnims;
+			std::vector<std::pair<StringID, StringID>> equipSets;
+			std::vector<float> scales;
+			SparseColumn<Morphs> morphs;
+			SparseColumn<ActionSet> actions;
+			SparseColumn<std::pair<RE::NiPoint3, float>> offsets;
 		};
 
 		static ActorGender ActorSexToGender(RE::Actor::Sex s)
@@ -141,7 +416,7 @@ namespace Data
 			return SetActorInfo(mapIn, slots);
 		}
 
-		static bool SetActorInfo(Scene::SceneActorsMap& mapIn, const std::vector<Slot>& slots)
+		static bool SetActorInfo(Scene::SceneActorsMap& mapIn, const SlotTable& slots)
 		{
 			auto actors = Scene::GetActorsInOrder(mapIn);
 
@@ -154,15 +429,15 @@ namespace Data
 			std::vector<size_t> anyIndices;
 
 			for (size_t i = 0; i < slots.size(); i++) {
-				auto& s = slots[i];
 				//First try to fill all gendered slots to avoid incorrectly placing a gendered actor into a non-gendered slot.
-				if (s.gender != ActorGender::Any) {
+				const ActorGender gender = slots.GetGender(i);
+				if (gender != ActorGender::Any) {
 					for (auto it = actors.begin(); it != actors.end(); it++) {
 						ActorGender g = ActorSexToGender((*it)->GetSex());
 
 						//If this actor has the same root behavior & gender as the corresponding slot, fill in the slot info for this actor.
-						if (s.rootBehavior == (*it)->race->behaviorGraphProjectName[0] && (g == s.gender)) {
-							s.Apply(it->get(), mapIn[it->get()->GetActorHandle()]);
+						if (slots.GetRootBehavior(i) == (*it)->race->behaviorGraphProjectName[0] && (g == gender)) {
+							slots.Apply(i, it->get(), mapIn[it->get()->GetActorHandle()]);
 							//Remove actor from the temporary vector once its map info has been filled in.
 							it = actors.erase(it);
 							break;
@@ -176,11 +451,9 @@ namespace Data
 
 			//After filling all gendered slots, fill any non-gendered slots using the same procedure.
 			for (auto& i : anyIndices) {
-				auto& s = slots[i];
-
 				for (auto it = actors.begin(); it != actors.end(); it++) {
-					if (s.rootBehavior == (*it)->race->behaviorGraphProjectName[0]) {
-						s.Apply(it->get(), mapIn[it->get()->GetActorHandle()]);
+					if (slots.GetRootBehavior(i) == (*it)->race->behaviorGraphProjectName[0]) {
+						slots.Apply(i, it->get(), mapIn[it->get()->GetActorHandle()]);
 						it = actors.erase(it);
 						break;
 					}
@@ -235,7 +508,7 @@ namespace Data
 			
 			size_t i = 0;
 			m.GetArray([&](XMLUtil::Mapper& m) {
-				auto& s = out.slots[i];
+				Slot s;
 				s.behaviorRequiresConvert = true;
 				s.idleRequiresConvert = true;
 
@@ -282,18 +555,19 @@ namespace Data
 
 				s.morphs.set_has_value(hasMorphs);
 
+				out.slots.push_back(s);
 				i++;
 				return m;
 			},
 			"actor", "Animation node has no actors!", true,
 			[&](size_t size) {
-				out.slots.resize(size);
+				out.slots.reserve(size);
 			});
 
 			return m;
 		}
 
-		std::vector<Slot> slots;
+		SlotTable slots;
 
 		template <class Archive>
 		void serialize(Archive& ar, const uint32_t)
@@ -17,18 +17,10 @@ namespace Data
 				name = nameOverride.value();
 			}
 
-			std::ostringstream buffer(std::ios::binary);
-
-			try {
-				cereal::BinaryOutputArchive outArchive(buffer);
-				outArchive(animData);
-			} catch (std::exception ex) {
-				logger::warn("Failed to save AnimationData. Full message: {}", ex.what());
+			if (!AnimBuildQueue::WriteBinary(name, FaceAnimation::FrameBasedAnimData::FromRuntimeData(animData))) {
 				return std::nullopt;
 			}
 
-			AnimCache::AddFile(name, buffer.str());
-
 			return name;
 		}
 
@@ -38,7 +30,10 @@ namespace Data
 
 			if (!outData && !outFrameData && buildBinary && XMLCache::IsCacheValid()) {
 				out.fileName = XMLCache::primaryCache.animDataMap[out.id].filename;
-				return m;
+				// Only face anims whose binary is missing from the AnimCache need their keyframes parsed.
+				if (AnimCache::Contains(out.fileName)) {
+					return m;
+				}
 			}
 
 			FaceAnimation::FrameBasedAnimData data;
@@ -73,24 +68,22 @@ namespace Data
 			}
 
 			if (m && (buildBinary || outData != nullptr)) {
-				auto rData = data.ToRuntimeData();
-
 				if (buildBinary) {
+					// The binary is built by the AnimBuildQueue once all data has been loaded.
 					if (XMLCache::IsCacheValid()) {
 						out.fileName = XMLCache::primaryCache.animDataMap[out.id].filename;
-					} else {
-						auto name = BuildBinary(rData);
-						if (!name.has_value()) {
-							return false;
-						} else {
-							XMLCache::AddAnimInfoToCache(out.id, name.value(), out.loadPriority);
-							out.fileName = name.value();
+						if (!AnimCache::Contains(out.fileName)) {
+							AnimBuildQueue::GetSingleton()->Enqueue(out.fileName, data, out.loadPriority);
 						}
+					} else {
+						out.fileName = std::format("{}", nextFileId++);
+						XMLCache::AddAnimInfoToCache(out.id, out.fileName, out.loadPriority);
+						AnimBuildQueue::GetSingleton()->Enqueue(out.fileName, data, out.loadPriority);
 					}
 				}
 
 				if (outData != nullptr) {
-					(*outData) = rData;
+					(*outData) = data.ToRuntimeData();
 				}
 			}
 			
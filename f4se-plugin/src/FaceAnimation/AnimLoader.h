@@ -0,0 +1,280 @@
+#pragma once
+#include <deque>
+#include "FaceAnimation/Animation.h"
+
+namespace FaceAnimation
+{
+	//Fixed pool of worker threads that decode face animations requested for playback.
+	//Requests for the same animation ID share a single load. Each request is made on behalf of a key (an actor handle),
+	//and a newer request or Cancel() for the same key supersedes the older one, so its callback never runs. Loads that
+	//nobody is waiting on anymore are dropped before they start.
+	//Callbacks are run on a worker thread while deliveryLock is held, so once Cancel() returns, the key's callback
+	//either already finished or will never run.
+	//Prefetches are queued separately and only picked up when no playback request is waiting. A playback request for
+	//an animation that's still queued for prefetch moves it to the playback queue.
+	class AnimLoader
+	{
+	public:
+		typedef std::function<void(std::shared_ptr<const AnimationData>)> Callback;
+
+		struct Metrics
+		{
+			uint64_t requests = 0;
+			uint64_t prefetches = 0;
+			uint64_t coalesced = 0;
+			uint64_t superseded = 0;
+			uint64_t dropped = 0;
+			uint64_t loads = 0;
+			uint64_t failed = 0;
+			double totalQueueMs = 0.0;
+			double totalLoadMs = 0.0;
+			double maxLatencyMs = 0.0;
+
+			double QAverageLatencyMs() const
+			{
+				return loads > 0 ? (totalQueueMs + totalLoadMs) / static_cast<double>(loads) : 0.0;
+			}
+		};
+
+		static AnimLoader* GetSingleton()
+		{
+			static AnimLoader singleton;
+			return &singleton;
+		}
+
+		~AnimLoader()
+		{
+			Stop();
+		}
+
+		void Request(uint32_t key, const std::string& id, Callback callback)
+		{
+			std::unique_lock dl{ deliveryLock };
+			std::unique_lock l{ lock };
+			const uint64_t generation = ++nextGeneration;
+			latest[key] = generation;
+			dl.unlock();
+
+			metrics.requests++;
+			auto iter = jobs.find(id);
+			if (iter != jobs.end()) {
+				metrics.coalesced++;
+				iter->second.waiters.push_back({ key, generation, std::move(callback) });
+				if (iter->second.prefetchOnly && !iter->second.running) {
+					iter->second.prefetchOnly = false;
+					order.push_back(id);
+					jobQueued.notify_one();
+				}
+				return;
+			}
+
+			auto& job = jobs[id];
+			job.queuedAt = Utility::CreatePerfCounter();
+			job.waiters.push_back({ key, generation, std::move(callback) });
+			order.push_back(id);
+
+			StartWorkers_NonThreadSafe();
+			jobQueued.notify_one();
+		}
+
+		//Queues a low-priority load that nobody is waiting on yet. The callback is run once the animation is decoded,
+		//even if it was requested for playback in the meantime.
+		void Prefetch(const std::string& id, Callback callback)
+		{
+			std::unique_lock l{ lock };
+			metrics.prefetches++;
+			auto iter = jobs.find(id);
+			if (iter != jobs.end()) {
+				iter->second.waiters.push_back({ 0, 0, std::move(callback), true });
+				return;
+			}
+
+			auto& job = jobs[id];
+			job.queuedAt = Utility::CreatePerfCounter();
+			job.prefetchOnly = true;
+			job.waiters.push_back({ 0, 0, std::move(callback), true });
+			prefetchOrder.push_back(id);
+
+			StartWorkers_NonThreadSafe();
+			jobQueued.notify_one();
+		}
+
+		void Cancel(uint32_t key)
+		{
+			std::scoped_lock l{ deliveryLock, lock };
+			latest.erase(key);
+		}
+
+		bool IsPending(uint32_t key)
+		{
+			std::unique_lock l{ lock };
+			return latest.contains(key);
+		}
+
+		void CancelAll()
+		{
+			std::scoped_lock l{ deliveryLock, lock };
+			latest.clear();
+			if (metrics.requests > 0) {
+				LogMetrics_NonThreadSafe();
+			}
+			metrics = Metrics();
+		}
+
+		void Stop()
+		{
+			std::unique_lock l{ lock };
+			stopping = true;
+			jobQueued.notify_all();
+			l.unlock();
+
+			for (auto& w : workers) {
+				if (w.joinable()) {
+					w.join();
+				}
+			}
+
+			l.lock();
+			workers.clear();
+			stopping = false;
+		}
+
+		Metrics QMetrics()
+		{
+			std::unique_lock l{ lock };
+			return metrics;
+		}
+
+	private:
+		struct Waiter
+		{
+			uint32_t key;
+			uint64_t generation;
+			Callback callback;
+			bool prefetch = false;
+		};
+
+		struct Job
+		{
+			std::vector<Waiter> waiters;
+			int64_t queuedAt = 0;
+			bool prefetchOnly = false;
+			bool running = false;
+		};
+
+		bool IsCurrent_NonThreadSafe(const Waiter& w) const
+		{
+			if (w.prefetch) {
+				return true;
+			}
+
+			auto iter = latest.find(w.key);
+			return iter != latest.end() && iter->second == w.generation;
+		}
+
+		// Drops superseded waiters, returns false if nobody is left waiting on the job.
+		bool PruneWaiters_NonThreadSafe(Job& job)
+		{
+			const size_t before = job.waiters.size();
+			std::erase_if(job.waiters, [&](const Waiter& w) { return !IsCurrent_NonThreadSafe(w); });
+			metrics.superseded += before - job.waiters.size();
+			return !job.waiters.empty();
+		}
+
+		void StartWorkers_NonThreadSafe()
+		{
+			if (!workers.empty()) {
+				return;
+			}
+
+			for (size_t i = 0; i < FACEANIM_LOADER_THREADS; i++) {
+				workers.emplace_back(&AnimLoader::WorkerRoutine, this);
+				SetThreadPriority(workers.back().native_handle(), THREAD_PRIORITY_BELOW_NORMAL);
+			}
+		}
+
+		void WorkerRoutine()
+		{
+			std::unique_lock l{ lock };
+			while (true) {
+				jobQueued.wait(l, [&] { return stopping || !order.empty() || !prefetchOrder.empty(); });
+				if (stopping) {
+					break;
+				}
+
+				auto& queue = !order.empty() ? order : prefetchOrder;
+				std::string id = std::move(queue.front());
+				queue.pop_front();
+				auto iter = jobs.find(id);
+				// A job can be listed in both queues, if a playback request was made while it was queued for prefetch.
+				if (iter == jobs.end() || iter->second.running) {
+					continue;
+				}
+
+				if (!PruneWaiters_NonThreadSafe(iter->second)) {
+					metrics.dropped++;
+					jobs.erase(iter);
+					continue;
+				}
+
+				iter->second.running = true;
+				const double queueMs = Utility::QueryPerfCounterTime(iter->second.queuedAt);
+				l.unlock();
+
+				auto timer = Utility::CreatePerfCounter();
+				auto data = FaceAnimation::DecodeData(id);
+				const double loadMs = Utility::QueryPerfCounterTime(timer);
+
+				std::unique_lock dl{ deliveryLock };
+				l.lock();
+				iter = jobs.find(id);
+				Job job = std::move(iter->second);
+				jobs.erase(iter);
+
+				metrics.loads++;
+				metrics.totalQueueMs += queueMs;
+				metrics.totalLoadMs += loadMs;
+				metrics.maxLatencyMs = std::max(metrics.maxLatencyMs, queueMs + loadMs);
+				if (data == nullptr) {
+					metrics.failed++;
+				}
+				logger::trace("Loaded face animation '{}' for {} waiter(s): {:.2f}ms queued, {:.2f}ms loading.", id, job.waiters.size(), queueMs, loadMs);
+
+				PruneWaiters_NonThreadSafe(job);
+				for (auto& w : job.waiters) {
+					if (!w.prefetch) {
+						latest.erase(w.key);
+					}
+				}
+				l.unlock();
+
+				if (data != nullptr) {
+					for (auto& w : job.waiters) {
+						w.callback(data);
+					}
+				}
+
+				dl.unlock();
+				l.lock();
+			}
+		}
+
+		void LogMetrics_NonThreadSafe()
+		{
+			logger::info("Face animation loader: {} requests, {} prefetches, {} coalesced, {} superseded, {} loads dropped, {} loads ({} failed), {:.2f}ms avg latency, {:.2f}ms max latency",
+				metrics.requests, metrics.prefetches, metrics.coalesced, metrics.superseded, metrics.dropped, metrics.loads, metrics.failed, metrics.QAverageLatencyMs(), metrics.maxLatencyMs);
+		}
+
+		std::mutex deliveryLock;
+		std::mutex lock;
+		std::condition_variable jobQueued;
+		std::vector<std::thread> workers;
+		bool stopping = false;
+		uint64_t nextGeneration = 0;
+		std::unordered_map<uint32_t, uint64_t> latest;
+		std::unordered_map<std::string, Job> jobs;
+		std::deque<std::string> order;
+		std::deque<std::string> prefetchOrder;
+		Metrics metrics;
+	};
+}
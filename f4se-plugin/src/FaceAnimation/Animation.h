@@ -1,62 +1,165 @@
 #pragma once
 #include "FaceAnimation/AnimationData.h"
+#include "FaceAnimation/BatchEvaluator.h"
+#include "FaceAnimation/FaceLOD.h"
 
 namespace FaceAnimation
 {
+	//Morph & eye values of an animation sampled at one point in time.
+	struct EvaluatedFace
+	{
+		const AnimationData* data = nullptr;
+		double time = 0.0;
+		uint8_t count = 0;
+		bool hasEyes = false;
+		float eyeU = 0.0f;
+		float eyeV = 0.0f;
+		uint8_t morphs[BatchEvaluator::MaxChannels];
+		float values[BatchEvaluator::MaxChannels];
+
+		//Only usable if sampled from the same data, close enough to the time the hook ended up at.
+		bool Matches(const AnimationData* _data, double _time) const
+		{
+			return data == _data && std::abs(time - _time) <= FACEANIM_PREEVAL_MAX_DRIFT;
+		}
+
+		//Writes the morph values into an expression, skipping those that are already within FACEANIM_LOD_WRITE_EPSILON.
+		//Returns the number of morphs written.
+		size_t Apply(float* exp) const
+		{
+			size_t written = 0;
+			for (size_t i = 0; i < count; i++) {
+				if (std::abs(exp[morphs[i]] - values[i]) > FACEANIM_LOD_WRITE_EPSILON) {
+					exp[morphs[i]] = values[i];
+					written++;
+				}
+			}
+			return written;
+		}
+
+		//Blends between two samples of the same data, otherwise just takes b.
+		static void Blend(const EvaluatedFace& a, const EvaluatedFace& b, float t, EvaluatedFace& out)
+		{
+			if (a.data != b.data || a.count != b.count || a.hasEyes != b.hasEyes) {
+				out = b;
+				return;
+			}
+
+			out.data = b.data;
+			out.time = std::lerp(a.time, b.time, static_cast<double>(t));
+			out.count = b.count;
+			for (size_t i = 0; i < b.count; i++) {
+				out.morphs[i] = b.morphs[i];
+				out.values[i] = std::lerp(a.values[i], b.values[i], t);
+			}
+			out.hasEyes = b.hasEyes;
+			out.eyeU = std::lerp(a.eyeU, b.eyeU, t);
+			out.eyeV = std::lerp(a.eyeV, b.eyeV, t);
+		}
+	};
+
+	struct UpdateResult
+	{
+		bool preEvaluated = false;
+		size_t morphs = 0;
+		size_t written = 0;
+	};
+
 	struct FaceAnimation
 	{
 		std::mutex lock;
-		AnimationData data;
+		std::shared_ptr<const AnimationData> data = std::make_shared<const AnimationData>();
+		std::vector<TimelineCursor> cursors;
+		double duration = 0.00001;
 		double timeElapsed = 0.00001;
+		float lastTimeDelta = 0.0f;
 		bool loop = false;
 		bool havokSync = false;
 		bool paused = false;
 
+		//Last values written to the face, and the samples the reduced LOD band blends between. Not serialized.
+		LODBand lodBand = LODBand::kFull;
+		EvaluatedFace shown;
+		EvaluatedFace lodFrom;
+		EvaluatedFace lodTo;
+		uint32_t lodStep = 0;
+		RE::BSGeometry* lastEyeGeo = nullptr;
+		float lastEyeU = 0.0f;
+		float lastEyeV = 0.0f;
+
 		FaceAnimation(AnimationData _data) {
-			data = _data;
+			SetData(std::make_shared<const AnimationData>(std::move(_data)));
 		}
 
 		FaceAnimation()
 		{
 		}
 
-		bool LoadData(const std::string& id)
+		static std::shared_ptr<const AnimationData> DecodeData(const std::string& id)
 		{
 			auto targetAnim = Data::GetFaceAnim(id);
 
 			if (targetAnim == nullptr) {
 				logger::warn("Cannot load face animation '{}', no such animation id exists.", id);
-				return false;
+				return nullptr;
 			}
 
-			std::istringstream buffer(Data::AnimCache::GetFile(targetAnim->fileName), std::ios::binary);
+			return Data::DecodedAnimCache::Get(targetAnim->fileName);
+		}
 
-			try {
-				cereal::BinaryInputArchive inArchive(buffer);
-				inArchive(data);
-			} catch (std::exception ex) {
-				logger::warn("Failed to load AnimationData. Full message: {}", ex.what());
+		bool LoadData(const std::string& id)
+		{
+			auto decoded = DecodeData(id);
+			if (decoded == nullptr) {
 				return false;
 			}
 
+			SetData(std::move(decoded));
 			return true;
 		}
 
+		void SetData(std::shared_ptr<const AnimationData> _data) {
+			data = std::move(_data);
+			duration = data->duration;
+			cursors.assign(data->timelines.size(), {});
+		}
+
 		void SetDuration(double durationMs) {
-			data.duration = durationMs / 1000;
+			duration = durationMs / 1000;
 		}
 
 		void SetStartNow() {
 			timeElapsed = 0.00001;
 		}
 
-		bool Update(RE::BSFaceGenAnimationData* animData, RE::BSGeometry* eyeGeo, float timeDelta) {
-			std::scoped_lock l{ lock };
+		std::optional<float> GetMorphValueAtTime(uint8_t morph, double time) {
+			for (size_t i = 0; i < data->timelines.size(); i++) {
+				auto& tl = data->timelines[i];
+				if (!tl.isEyes && tl.morph == morph) {
+					return tl.GetValueAtTime(time / duration, cursors[i]);
+				}
+			}
+			return std::nullopt;
+		}
+
+		std::optional<EyeVector> GetEyesValueAtTime(double time) {
+			for (size_t i = 0; i < data->timelines.size(); i++) {
+				auto& tl = data->timelines[i];
+				if (tl.isEyes) {
+					return tl.GetEyesValueAtTime(time / duration, cursors[i]);
+				}
+			}
+			return std::nullopt;
+		}
 
+		//Caller must hold lock. Returns false once a non-looping animation has finished.
+		bool Advance(float timeDelta)
+		{
+			lastTimeDelta = timeDelta;
 			if (!paused)
 				timeElapsed += timeDelta;
 
-			if (timeElapsed > data.duration) {
+			if (timeElapsed > duration) {
 				if (loop) {
 					SetStartNow();
 				} else {
@@ -64,20 +167,120 @@ namespace FaceAnimation
 				}
 			}
 
-			UpdateNoDelta(animData, eyeGeo);
 			return true;
 		}
 
-		void UpdateNoDelta(RE::BSFaceGenAnimationData* animData, RE::BSGeometry* eyeGeo)
+		//Caller must hold lock. Guesses where the next Advance() will end up, assuming the same time delta as the last one.
+		std::optional<double> QPredictedTime() const
+		{
+			double t = paused ? timeElapsed : timeElapsed + lastTimeDelta;
+			if (t > duration) {
+				if (havokSync) {
+					t = loop ? std::fmod(t, duration) : t;
+				} else if (loop) {
+					t = 0.00001;
+				} else {
+					return std::nullopt;
+				}
+			}
+			return t;
+		}
+
+		//Caller must hold lock.
+		void Evaluate(double time, EvaluatedFace& out)
+		{
+			thread_local BatchEvaluator evaluator;
+			const double t = time / duration;
+			auto eyeTimeline = evaluator.Gather(*data, cursors, t);
+			evaluator.Evaluate();
+
+			out.data = data.get();
+			out.time = time;
+			out.count = static_cast<uint8_t>(evaluator.size());
+			for (size_t i = 0; i < evaluator.size(); i++) {
+				out.morphs[i] = evaluator.GetMorph(i);
+				out.values[i] = evaluator.GetResult(i);
+			}
+
+			out.hasEyes = eyeTimeline.has_value();
+			if (out.hasEyes) {
+				auto val = data->timelines[eyeTimeline.value()].GetEyesValueAtTime(t, cursors[eyeTimeline.value()]);
+				out.eyeU = static_cast<float>(val.u);
+				out.eyeV = static_cast<float>(val.v);
+			}
+		}
+
+		//Caller must hold lock. Writes the animation's current values at the given LOD band.
+		//At full rate, pre-evaluated values are used if they match the current time.
+		UpdateResult UpdateNoDelta(RE::BSFaceGenAnimationData* animData, RE::BSGeometry* eyeGeo, LODBand band = LODBand::kFull, const EvaluatedFace* preEvaluated = nullptr)
+		{
+			UpdateResult result;
+			switch (band) {
+			case LODBand::kFull:
+				if (preEvaluated != nullptr && preEvaluated->Matches(data.get(), timeElapsed)) {
+					shown = *preEvaluated;
+					result.preEvaluated = true;
+				} else {
+					Evaluate(timeElapsed, shown);
+				}
+				break;
+			case LODBand::kReduced:
+				UpdateReduced();
+				break;
+			case LODBand::kFrozen:
+				if (shown.data != data.get()) {
+					Evaluate(timeElapsed, shown);
+				}
+				break;
+			}
+			lodBand = band;
+
+			//Decoding rejects morphs outside of the expression, which relies on this.
+			static_assert(std::extent_v<decltype(RE::Expression::exp)> == FACEANIM_MORPH_COUNT);
+			result.morphs = shown.count;
+			result.written = shown.Apply(animData->finalExp.exp);
+			if (shown.hasEyes) {
+				SetEyes(eyeGeo, shown.eyeU, shown.eyeV);
+			}
+			return result;
+		}
+
+		//Forces the next update to write the eye coords, for when something else has changed them.
+		void InvalidateEyes()
 		{
-			double timeDeltaNormalized = timeElapsed / data.duration;
-			for (auto& tl : data.timelines) {
-				if (!tl.isEyes) {
-					animData->finalExp.exp[tl.morph] = std::clamp(tl.GetValueAtTime(timeDeltaNormalized), 0.001f, 0.999f);
+			lastEyeGeo = nullptr;
+		}
+
+	private:
+		//Samples the animation a full interval ahead once every QReducedInterval() frames, and blends towards it in between.
+		void UpdateReduced()
+		{
+			const uint32_t interval = FaceLOD::QReducedInterval();
+			if (lodBand != LODBand::kReduced || lodStep >= interval || lodTo.data != data.get()) {
+				if (lodBand != LODBand::kReduced || lodTo.data != data.get()) {
+					Evaluate(timeElapsed, lodFrom);
 				} else {
-					auto val = tl.GetEyesValueAtTime(timeDeltaNormalized);
-					GameUtil::SetEyeCoords(eyeGeo, static_cast<float>(val.u), static_cast<float>(val.v));
+					lodFrom = lodTo;
 				}
+				const double ahead = paused ? 0.0 : static_cast<double>(lastTimeDelta) * interval;
+				Evaluate(std::min(timeElapsed + ahead, duration), lodTo);
+				lodStep = 0;
+			}
+
+			EvaluatedFace::Blend(lodFrom, lodTo, static_cast<float>(lodStep) / static_cast<float>(interval), shown);
+			lodStep++;
+		}
+
+		void SetEyes(RE::BSGeometry* eyeGeo, float u, float v)
+		{
+			if (eyeGeo == lastEyeGeo && std::abs(u - lastEyeU) <= FACEANIM_LOD_WRITE_EPSILON && std::abs(v - lastEyeV) <= FACEANIM_LOD_WRITE_EPSILON) {
+				return;
+			}
+
+			if (GameUtil::SetEyeCoords(eyeGeo, u, v)) {
+				lastEyeGeo = eyeGeo;
+				lastEyeU = u;
+				lastEyeV = v;
 			}
 		}
 	};
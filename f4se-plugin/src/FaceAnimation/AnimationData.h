@@ -54,84 +54,214 @@ namespace FaceAnimation
 		}
 	};
 
+	//Playback position within an AnimationTimeline, the index of the key at or before the last sampled time.
+	//Kept by each FaceAnimation instance so that the timeline itself can be shared between instances.
+	struct TimelineCursor
+	{
+		uint32_t index = 0;
+	};
+
+	//Baked runtime timeline. Keys are stored as parallel arrays sorted by normalized time,
+	//eye timelines store U/V pairs instead of morph values.
 	struct AnimationTimeline
 	{
-		uint8_t morph;
+		uint8_t morph = 0;
 		bool isEyes = false;
-		std::map<double, Keyframe> keys;
-		std::map<double, Keyframe>::iterator cachedNextIter;
-		std::map<double, Keyframe>::iterator cachedPrevIter;
+		std::vector<float> times;
+		std::vector<Easing::Function> eases;
+		std::vector<float> values;
+		std::vector<std::pair<float, float>> eyes;
+
+		//Optional fixed-rate lookup table of quantized values, built at decode time. Not serialized.
+		std::vector<uint16_t> lut;
+		float lutMin = 0.0f;
+		float lutStep = 0.0f;
 
 		AnimationTimeline()
 		{
 		}
 
-		AnimationTimeline(std::map<double, Keyframe> _keys, uint8_t _morph, bool _isEyes) :
-			keys(_keys), morph(_morph), isEyes(_isEyes)
+		AnimationTimeline(const std::map<double, Keyframe>& keys, uint8_t _morph, bool _isEyes) :
+			morph(_morph), isEyes(_isEyes)
 		{
-			cachedNextIter = keys.begin();
-			cachedPrevIter = keys.begin();
+			times.reserve(keys.size());
+			eases.reserve(keys.size());
+			if (!isEyes) {
+				values.reserve(keys.size());
+			} else {
+				eyes.reserve(keys.size());
+			}
+
+			for (auto& k : keys) {
+				times.push_back(static_cast<float>(k.first));
+				eases.push_back(k.second.ease);
+				if (!isEyes) {
+					values.push_back(k.second.value);
+				} else {
+					eyes.push_back({ static_cast<float>(k.second.eyesValue.u), static_cast<float>(k.second.eyesValue.v) });
+				}
+			}
 		}
 
-		template <class Archive>
-		void save(Archive& ar, const uint32_t) const
+		size_t size() const
 		{
-			ar(morph, isEyes, keys);
+			return times.size();
+		}
+
+		Keyframe GetKey(size_t i) const
+		{
+			Keyframe result;
+			result.ease = eases[i];
+			if (!isEyes) {
+				result.value = values[i];
+			} else {
+				result.eyesValue = { eyes[i].first, eyes[i].second };
+			}
+			return result;
 		}
 
 		template <class Archive>
-		void load(Archive& ar, const uint32_t)
+		void serialize(Archive& ar, const uint32_t)
 		{
-			ar(morph, isEyes, keys);
-			cachedNextIter = keys.begin();
-			cachedPrevIter = keys.begin();
+			ar(morph, isEyes, times, eases, values, eyes);
 		}
 
-		float GetValueAtTime(double t)
+		float GetValueAtTime(double t, TimelineCursor& c) const
 		{
-			if (cachedNextIter->first < t || cachedPrevIter->first > t) {
-				auto nextKey = keys.lower_bound(t);
+			float e;
+			auto i = Seek(t, c, e);
+			if (i == SIZE_MAX) {
+				return values[e > 0.0f ? values.size() - 1 : 0];
+			}
+			return std::lerp(values[i], values[i + 1], e);
+		}
 
-				if (nextKey == keys.end()) {
-					return std::prev(nextKey)->second.value;
-				} else if (nextKey == keys.begin() || keys.size() < 2) {
-					return nextKey->second.value;
-				} else {
-					cachedNextIter = nextKey;
-					cachedPrevIter = std::prev(nextKey);
+		EyeVector GetEyesValueAtTime(double t, TimelineCursor& c) const
+		{
+			float e;
+			auto i = Seek(t, c, e);
+			if (i == SIZE_MAX) {
+				auto& val = eyes[e > 0.0f ? eyes.size() - 1 : 0];
+				return { val.first, val.second };
+			}
+			return { std::lerp(eyes[i].first, eyes[i + 1].first, e), std::lerp(eyes[i].second, eyes[i + 1].second, e) };
+		}
+
+		size_t QMemoryUsage() const
+		{
+			return times.capacity() * sizeof(float) +
+			       eases.capacity() * sizeof(Easing::Function) +
+			       values.capacity() * sizeof(float) +
+			       eyes.capacity() * sizeof(std::pair<float, float>) +
+			       lut.capacity() * sizeof(uint16_t);
+		}
+
+		bool HasLUT() const
+		{
+			return !lut.empty();
+		}
+
+		//Samples the timeline at numSamples evenly spaced points into a 16-bit lookup table.
+		//Returns the max error of the table against exact evaluation, checked at every sample and at
+		//FACEANIM_BAKE_CHECK_STEPS points between samples. If the error is above maxError, the table is discarded.
+		float BuildLUT(size_t numSamples, float maxError)
+		{
+			lut.clear();
+			if (isEyes || times.size() < 2 || numSamples < 2) {
+				return 0.0f;
+			}
+
+			TimelineCursor c;
+			std::vector<float> exact(numSamples);
+			const double step = 1.0 / static_cast<double>(numSamples - 1);
+			for (size_t i = 0; i < numSamples; i++) {
+				exact[i] = GetValueAtTime(static_cast<double>(i) * step, c);
+			}
+
+			auto [minIter, maxIter] = std::minmax_element(exact.begin(), exact.end());
+			lutMin = *minIter;
+			lutStep = (*maxIter - *minIter) / static_cast<float>(UINT16_MAX);
+			lut.resize(numSamples);
+			for (size_t i = 0; i < numSamples; i++) {
+				lut[i] = lutStep > 0.0f ? static_cast<uint16_t>(std::lround((exact[i] - lutMin) / lutStep)) : 0;
+			}
+
+			float maxErr = 0.0f;
+			c = TimelineCursor();
+			for (size_t i = 0; i < numSamples - 1; i++) {
+				maxErr = std::max(maxErr, std::abs(exact[i] - GetLUTValue(i)));
+				for (size_t s = 1; s < FACEANIM_BAKE_CHECK_STEPS; s++) {
+					const float fraction = static_cast<float>(s) / FACEANIM_BAKE_CHECK_STEPS;
+					const float between = GetValueAtTime((static_cast<double>(i) + fraction) * step, c);
+					maxErr = std::max(maxErr, std::abs(between - std::lerp(GetLUTValue(i), GetLUTValue(i + 1), fraction)));
 				}
 			}
 
-			auto totalDiff = cachedNextIter->first - cachedPrevIter->first;
-			auto currentDiff = t - cachedPrevIter->first;
+			if (maxErr > maxError) {
+				lut.clear();
+				lut.shrink_to_fit();
+			}
 
-			auto normalizedTime = currentDiff * (1 / totalDiff);
-			return static_cast<float>(std::lerp(cachedPrevIter->second.value, cachedNextIter->second.value, Easing::Ease(normalizedTime, cachedPrevIter->second.ease)));
+			return maxErr;
 		}
 
-		EyeVector GetEyesValueAtTime(double t)
+		float GetLUTValue(size_t i) const
 		{
-			if (cachedNextIter->first < t || cachedPrevIter->first > t) {
-				auto nextKey = keys.lower_bound(t);
+			return lutMin + static_cast<float>(lut[i]) * lutStep;
+		}
 
-				if (nextKey == keys.end()) {
-					return std::prev(nextKey)->second.eyesValue;
-				} else if (nextKey == keys.begin() || keys.size() < 2) {
-					return nextKey->second.eyesValue;
-				} else {
-					cachedNextIter = nextKey;
-					cachedPrevIter = std::prev(nextKey);
+		//Returns the index of the table entry at or before t, and the fraction towards the next entry.
+		size_t LocateLUT(double t, float& fractionOut) const
+		{
+			const double pos = std::clamp(t, 0.0, 1.0) * static_cast<double>(lut.size() - 1);
+			const size_t i = std::min(static_cast<size_t>(pos), lut.size() - 2);
+			fractionOut = static_cast<float>(pos - static_cast<double>(i));
+			return i;
+		}
+
+		// Returns the index of the key at or before t, and the normalized time between it and the next key.
+		// If t is outside of the keyed range, returns SIZE_MAX and sets the time to 1 past the last key, or 0 before the first.
+		// Playback normally only moves forward by a few keys per frame, so the cursor is advanced linearly
+		// and falls back to a binary search after a seek.
+		size_t Locate(double t, TimelineCursor& c, double& normalizedOut) const
+		{
+			const size_t n = times.size();
+			const float ft = static_cast<float>(t);
+
+			if (n < 2 || ft <= times[0]) {
+				normalizedOut = 0.0;
+				return SIZE_MAX;
+			} else if (ft >= times[n - 1]) {
+				normalizedOut = 1.0;
+				return SIZE_MAX;
+			}
+
+			size_t i = c.index;
+			if (i >= n - 1 || times[i] > ft) {
+				i = std::distance(times.begin(), std::upper_bound(times.begin(), times.end(), ft)) - 1;
+			} else {
+				for (size_t steps = 0; times[i + 1] <= ft; steps++) {
+					if (steps > 3) {
+						i = std::distance(times.begin(), std::upper_bound(times.begin() + i, times.end(), ft)) - 1;
+						break;
+					}
+					i++;
 				}
 			}
+			c.index = static_cast<uint32_t>(i);
 
-			auto totalDiff = cachedNextIter->first - cachedPrevIter->first;
-			auto currentDiff = t - cachedPrevIter->first;
+			// Keys are stored as floats, so t can land slightly outside of the bracket.
+			normalizedOut = std::clamp((t - times[i]) / (times[i + 1] - times[i]), 0.0, 1.0);
+			return i;
+		}
 
-			auto normalizedTime = currentDiff * (1 / totalDiff);
-			EyeVector interpVec;
-			interpVec.u = std::lerp(cachedPrevIter->second.eyesValue.u, cachedNextIter->second.eyesValue.u, Easing::Ease(normalizedTime, cachedPrevIter->second.ease));
-			interpVec.v = std::lerp(cachedPrevIter->second.eyesValue.v, cachedNextIter->second.eyesValue.v, Easing::Ease(normalizedTime, cachedPrevIter->second.ease));
-			return interpVec;
+	private:
+		size_t Seek(double t, TimelineCursor& c, float& easedOut) const
+		{
+			double normalizedTime;
+			auto i = Locate(t, c, normalizedTime);
+			easedOut = i == SIZE_MAX ? static_cast<float>(normalizedTime) : Easing::Fast::Ease(static_cast<float>(normalizedTime), eases[i]);
+			return i;
 		}
 	};
 
@@ -140,6 +270,57 @@ namespace FaceAnimation
 		std::vector<AnimationTimeline> timelines;
 		double duration = 0.00001;
 
+		size_t QKeyCount() const
+		{
+			size_t result = 0;
+			for (auto& tl : timelines) {
+				result += tl.size();
+			}
+			return result;
+		}
+
+		struct BakeReport
+		{
+			size_t baked = 0;
+			size_t rejected = 0;
+			size_t keyBytes = 0;
+			size_t lutBytes = 0;
+			float maxError = 0.0f;
+		};
+
+		//Builds fixed-rate lookup tables for all morph timelines. Timelines that can't meet maxError keep exact evaluation.
+		BakeReport BakeLUTs(uint32_t sampleRate, float maxError, size_t maxSamples = 65536)
+		{
+			BakeReport result;
+			const size_t numSamples = static_cast<size_t>(std::ceil(duration * sampleRate)) + 1;
+			for (auto& tl : timelines) {
+				if (tl.isEyes) {
+					continue;
+				}
+
+				// Very long animations would need huge tables, keep them exact.
+				const float err = numSamples <= maxSamples ? tl.BuildLUT(numSamples, maxError) : 0.0f;
+				if (tl.HasLUT()) {
+					result.baked++;
+					result.lutBytes += tl.lut.size() * sizeof(uint16_t);
+					result.maxError = std::max(result.maxError, err);
+				} else {
+					result.rejected++;
+				}
+				result.keyBytes += tl.size() * (sizeof(float) * 2 + sizeof(Easing::Function));
+			}
+			return result;
+		}
+
+		size_t QMemoryUsage() const
+		{
+			size_t result = sizeof(AnimationData) + timelines.capacity() * sizeof(AnimationTimeline);
+			for (auto& tl : timelines) {
+				result += tl.QMemoryUsage();
+			}
+			return result;
+		}
+
 		template <class Archive>
 		void serialize(Archive& ar, const uint32_t)
 		{
@@ -237,8 +418,8 @@ namespace FaceAnimation
 			std::map<int32_t, Keyframe> convertedFrames;
 			for (auto& tl : runtimeData.timelines) {
 				convertedFrames.clear();
-				for (auto& k : tl.keys) {
-					convertedFrames.insert({ static_cast<int32_t>((k.first * runtimeData.duration) * static_cast<double>(frameRate)), k.second });
+				for (size_t i = 0; i < tl.size(); i++) {
+					convertedFrames.insert({ static_cast<int32_t>(std::lround((tl.times[i] * runtimeData.duration) * static_cast<double>(frameRate))), tl.GetKey(i) });
 				}
 				res.timelines.push_back(FrameBasedTimeline{ tl.morph, tl.isEyes, convertedFrames });
 			}
@@ -0,0 +1,125 @@
+#pragma once
+#include <xmmintrin.h>
+#include "FaceAnimation/AnimationData.h"
+
+namespace FaceAnimation
+{
+	//Evaluates every morph timeline of an animation in one pass.
+	//The bracketing keys of all channels are gathered into flat arrays, interpolation factors are
+	//eased, then all channels are lerped & clamped 4 lanes at a time before being scattered into the expression.
+	class BatchEvaluator
+	{
+	public:
+		static constexpr size_t MaxChannels = 64;
+
+		BatchEvaluator()
+		{
+			std::fill(std::begin(from), std::end(from), 0.0f);
+			std::fill(std::begin(to), std::end(to), 0.0f);
+			std::fill(std::begin(factor), std::end(factor), 0.0f);
+		}
+
+		//Gathers all morph channels at normalized time t. Returns the index of the eye timeline, if any.
+		std::optional<size_t> Gather(const AnimationData& data, std::vector<TimelineCursor>& cursors, double t)
+		{
+			count = 0;
+			std::optional<size_t> eyeTimeline = std::nullopt;
+
+			for (size_t i = 0; i < data.timelines.size(); i++) {
+				auto& tl = data.timelines[i];
+				if (tl.isEyes) {
+					eyeTimeline = i;
+					continue;
+				}
+
+				if (count >= MaxChannels || tl.size() < 1) {
+					continue;
+				}
+
+				morphs[count] = tl.morph;
+				if (tl.HasLUT()) {
+					auto k = tl.LocateLUT(t, factor[count]);
+					from[count] = tl.GetLUTValue(k);
+					to[count] = tl.GetLUTValue(k + 1);
+					eases[count] = Easing::None;
+					count++;
+					continue;
+				}
+
+				double normalizedTime;
+				auto k = tl.Locate(t, cursors[i], normalizedTime);
+				if (k == SIZE_MAX) {
+					from[count] = to[count] = tl.values[normalizedTime > 0.0 ? tl.values.size() - 1 : 0];
+					factor[count] = 0.0f;
+					eases[count] = Easing::None;
+				} else {
+					from[count] = tl.values[k];
+					to[count] = tl.values[k + 1];
+					factor[count] = static_cast<float>(normalizedTime);
+					eases[count] = tl.eases[k] < Easing::EaseFunctions.size() ? tl.eases[k] : Easing::None;
+				}
+				count++;
+			}
+
+			return eyeTimeline;
+		}
+
+		void Evaluate()
+		{
+			EaseFactors();
+
+			const __m128 minVal = _mm_set1_ps(0.001f);
+			const __m128 maxVal = _mm_set1_ps(0.999f);
+			for (size_t i = 0; i < count; i += 4) {
+				const __m128 a = _mm_load_ps(from + i);
+				const __m128 b = _mm_load_ps(to + i);
+				const __m128 e = _mm_load_ps(factor + i);
+				__m128 r = _mm_add_ps(a, _mm_mul_ps(e, _mm_sub_ps(b, a)));
+				r = _mm_min_ps(_mm_max_ps(r, minVal), maxVal);
+				_mm_store_ps(result + i, r);
+			}
+		}
+
+		void Write(float* exp) const
+		{
+			for (size_t i = 0; i < count; i++) {
+				exp[morphs[i]] = result[i];
+			}
+		}
+
+		size_t size() const
+		{
+			return count;
+		}
+
+		float GetResult(size_t i) const
+		{
+			return result[i];
+		}
+
+		uint8_t GetMorph(size_t i) const
+		{
+			return morphs[i];
+		}
+
+	private:
+		//Channels are eased one at a time. Grouping them by curve first cost more than it saved at the dozen or so
+		//channels a face animation has.
+		void EaseFactors()
+		{
+			for (size_t i = 0; i < count; i++) {
+				if (eases[i] != Easing::None) {
+					factor[i] = Easing::Fast::Ease(factor[i], eases[i]);
+				}
+			}
+		}
+
+		alignas(16) float from[MaxChannels];
+		alignas(16) float to[MaxChannels];
+		alignas(16) float factor[MaxChannels];
+		alignas(16) float result[MaxChannels];
+		uint8_t morphs[MaxChannels];
+		Easing::Function eases[MaxChannels];
+		size_t count = 0;
+	};
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+namespace FaceAnimation
+{
+	enum class LODBand : uint8_t
+	{
+		kFull,
+		kReduced,
+		kFrozen
+	};
+
+	//Where faces are relative to the camera. Replaceable, so that the LOD policy doesn't depend on the game's camera.
+	class ILODView
+	{
+	public:
+		virtual ~ILODView() {}
+		//Returns nullopt if the distance can't be determined, in which case the face is updated at full rate.
+		virtual std::optional<float> QCameraDistance(RE::Actor* actor) = 0;
+		virtual bool QOnScreen(RE::Actor* actor) = 0;
+	};
+
+	class GameLODView : public ILODView
+	{
+	public:
+		virtual std::optional<float> QCameraDistance(RE::Actor* actor) override
+		{
+			auto camPos = QCameraPosition();
+			if (!camPos.has_value() || actor == nullptr) {
+				return std::nullopt;
+			}
+			return static_cast<float>(GameUtil::GetDistance(camPos.value(), actor->data.location));
+		}
+
+		//Only rejects faces well behind the camera, since the FOV isn't known here.
+		virtual bool QOnScreen(RE::Actor* actor) override
+		{
+			auto cam = RE::PlayerCamera::GetSingleton();
+			if (cam == nullptr || cam->cameraRoot == nullptr || actor == nullptr) {
+				return true;
+			}
+
+			//The camera looks down its local Y axis.
+			auto& world = cam->cameraRoot->world;
+			const float dx = actor->data.location.x - world.translate.x;
+			const float dy = actor->data.location.y - world.translate.y;
+			const float dz = actor->data.location.z - world.translate.z;
+			const float dot = world.rotate.entry[0].y * dx + world.rotate.entry[1].y * dy + world.rotate.entry[2].y * dz;
+			return dot >= -0.2f * std::sqrt(dx * dx + dy * dy + dz * dz);
+		}
+
+	private:
+		std::optional<RE::NiPoint3> QCameraPosition()
+		{
+			auto cam = RE::PlayerCamera::GetSingleton();
+			if (cam == nullptr || cam->cameraRoot == nullptr) {
+				return std::nullopt;
+			}
+			return cam->cameraRoot->world.translate;
+		}
+	};
+
+	//Decides how often each managed face is updated, based on its distance from the camera:
+	//full rate within iFaceLODFullDistance, every iFaceLODReducedInterval frames (interpolated in between)
+	//up to iFaceLODFrozenDistance, and frozen beyond that or when off screen. An iFaceLODFullDistance of 0 disables LOD.
+	class FaceLOD
+	{
+	public:
+		struct Metrics
+		{
+			uint64_t fullFrames = 0;
+			uint64_t reducedFrames = 0;
+			uint64_t frozenFrames = 0;
+			uint64_t morphWrites = 0;
+			uint64_t morphWritesSkipped = 0;
+		};
+
+		static LODBand GetBand(RE::Actor* actor)
+		{
+			const float fullDist = static_cast<float>(Data::Settings::Values.iFaceLODFullDistance.load());
+			if (fullDist <= 0.0f) {
+				return LODBand::kFull;
+			}
+
+			std::shared_lock l{ viewLock };
+			auto dist = view->QCameraDistance(actor);
+			if (!dist.has_value() || dist.value() <= fullDist) {
+				return LODBand::kFull;
+			} else if (dist.value() > static_cast<float>(Data::Settings::Values.iFaceLODFrozenDistance.load()) || !view->QOnScreen(actor)) {
+				return LODBand::kFrozen;
+			}
+			return LODBand::kReduced;
+		}
+
+		static uint32_t QReducedInterval()
+		{
+			return std::max(Data::Settings::Values.iFaceLODReducedInterval.load(), 1u);
+		}
+
+		static void SetView(std::unique_ptr<ILODView> newView)
+		{
+			std::unique_lock l{ viewLock };
+			view = std::move(newView);
+		}
+
+		static void RecordFrame(LODBand band, size_t morphs, size_t written)
+		{
+			switch (band) {
+			case LODBand::kFull:
+				fullFrames.fetch_add(1, std::memory_order_relaxed);
+				break;
+			case LODBand::kReduced:
+				reducedFrames.fetch_add(1, std::memory_order_relaxed);
+				break;
+			case LODBand::kFrozen:
+				frozenFrames.fetch_add(1, std::memory_order_relaxed);
+				break;
+			}
+			morphWrites.fetch_add(written, std::memory_order_relaxed);
+			morphWritesSkipped.fetch_add(morphs - written, std::memory_order_relaxed);
+		}
+
+		static Metrics QMetrics()
+		{
+			Metrics result;
+			result.fullFrames = fullFrames.load();
+			result.reducedFrames = reducedFrames.load();
+			result.frozenFrames = frozenFrames.load();
+			result.morphWrites = morphWrites.load();
+			result.morphWritesSkipped = morphWritesSkipped.load();
+			return result;
+		}
+
+		static void Reset()
+		{
+			auto m = QMetrics();
+			if (m.fullFrames + m.reducedFrames + m.frozenFrames > 0) {
+				logger::info("Face LOD: {} full, {} reduced, {} frozen face updates, {} morph writes, {} skipped as unchanged",
+					m.fullFrames, m.reducedFrames, m.frozenFrames, m.morphWrites, m.morphWritesSkipped);
+			}
+			fullFrames = 0;
+			reducedFrames = 0;
+			frozenFrames = 0;
+			morphWrites = 0;
+			morphWritesSkipped = 0;
+		}
+
+	private:
+		inline static std::shared_mutex viewLock;
+		inline static std::unique_ptr<ILODView> view = std::make_unique<GameLODView>();
+		inline static std::atomic<uint64_t> fullFrames = 0;
+		inline static std::atomic<uint64_t> reducedFrames = 0;
+		inline static std::atomic<uint64_t> frozenFrames = 0;
+		inline static std::atomic<uint64_t> morphWrites = 0;
+		inline static std::atomic<uint64_t> morphWritesSkipped = 0;
+	};
+}
@@ -2,6 +2,11 @@
 #include <shared_mutex>
 #include "Serialization/General.h"
 #include "FaceAnimation/Animation.h"
+#include "FaceAnimation/AnimLoader.h"
+#include "FaceAnimation/Prefetcher.h"
+#include "FaceAnimation/FrameEvaluator.h"
+#include "Misc/AtomicPtrSet.h"
+#include "Misc/SyncInfoCache.h"
 
 namespace FaceAnimation
 {
@@ -22,7 +27,6 @@ namespace FaceAnimation
 			std::string animationId = "";
 			std::optional<EyeVector> eyeOverride = std::nullopt;
 			std::optional<AnimInfo> animBackup = std::nullopt;
-			RE::BGSAnimationSystemUtils::ActiveSyncInfo syncInfoCache;
 
 			template <class Archive>
 			void save(Archive& ar, const uint32_t) const
@@ -50,9 +54,14 @@ namespace FaceAnimation
 			}
 		};
 
+		//Lock-free filter checked by the hooks before taking stateLock. Always a superset of managedDatas,
+		//so a miss means the face isn't managed, while a hit still has to be confirmed against managedDatas.
+		static Misc::AtomicPtrSet<RE::BSFaceGenAnimationData> managedFaces;
+
 		struct PersistentState
 		{
 			std::unordered_map<RE::BSFaceGenAnimationData*, SerializableActorHandle> managedDatas;
+			std::unordered_map<SerializableActorHandle, RE::BSFaceGenAnimationData*> managedHandles;
 			std::unordered_map<SerializableActorHandle, FaceData> managedAnims;
 
 			template <class Archive>
@@ -69,6 +78,8 @@ namespace FaceAnimation
 					auto d = GameUtil::GetFaceAnimData(pair.first.get().get());
 					if (d != nullptr) {
 						managedDatas[d] = pair.first;
+						managedHandles[pair.first] = d;
+						managedFaces.Insert(d);
 					}
 				}
 			}
@@ -81,8 +92,6 @@ namespace FaceAnimation
 		static REL::Relocation<UpdateLip> OriginalUpdateLip;
 		inline static std::unique_ptr<PersistentState> state = std::make_unique<PersistentState>();
 		static std::shared_mutex stateLock;
-		static std::unordered_map<SerializableActorHandle, std::string> loadingAnims;
-		static std::mutex loadingAnimsLock;
 		static std::unordered_map<SerializableActorHandle, RE::NiPointer<RE::BSGeometry>> eyeGeoCache;
 		static std::shared_mutex geoCacheLock;
 
@@ -112,17 +121,30 @@ namespace FaceAnimation
 			return result;
 		}
 
+		void SetDataManaged_NonThreadSafe(RE::BSFaceGenAnimationData* data, SerializableActorHandle hndl)
+		{
+			if (data == nullptr) {
+				return;
+			}
+
+			auto& current = state->managedHandles[hndl];
+			if (current != nullptr && current != data) {
+				state->managedDatas.erase(current);
+				managedFaces.Erase(current);
+			}
+			current = data;
+			state->managedDatas[data] = hndl;
+			managedFaces.Insert(data);
+		}
+
 		void EraseIfEmpty_NonThreadSafe(RE::ActorHandle targetActor)
 		{
 			if (state->managedAnims[targetActor].anim == nullptr && !state->managedAnims[targetActor].eyeOverride.has_value()) {
 				state->managedAnims.erase(targetActor);
-				for (auto iter = state->managedDatas.begin(); iter != state->managedDatas.end();) {
-					if (iter->second.hash() == targetActor.native_handle_const()) {
-						iter = state->managedDatas.erase(iter);
-						break;
-					} else {
-						iter++;
-					}
+				if (auto iter = state->managedHandles.find(targetActor); iter != state->managedHandles.end()) {
+					state->managedDatas.erase(iter->second);
+					managedFaces.Erase(iter->second);
+					state->managedHandles.erase(iter);
 				}
 				std::unique_lock l{ geoCacheLock };
 				eyeGeoCache.erase(targetActor);
@@ -130,6 +152,10 @@ namespace FaceAnimation
 		}
 
 		bool HookedUpdateLip(RE::BSFaceGenAnimationData* data, float ptimeDelta) {
+			if (!managedFaces.Contains(data)) {
+				return OriginalUpdateLip(data, ptimeDelta);
+			}
+
 			std::shared_lock l{ stateLock };
 
 			if (auto h = IsDataManaged(data); h) {
@@ -144,6 +170,10 @@ namespace FaceAnimation
 		bool HookedUpdate(RE::BSFaceGenAnimationData* data, float timeDelta, bool unk01, float pGameTime)
 		{
 			bool result = OriginalUpdate(data, timeDelta, unk01, pGameTime);
+			if (!managedFaces.Contains(data)) {
+				return result;
+			}
+
 			std::shared_lock l{ stateLock };
 
 			if (auto h = IsDataManaged(data); h) {
@@ -153,19 +183,36 @@ namespace FaceAnimation
 				RE::BSAutoLock bl{ data->instanceData.lock };
 
 				if (a->second.anim != nullptr) {
-					if (!a->second.anim->havokSync) {
-						if (!a->second.anim->Update(data, eyeGeo, timeDelta)) {
-							pendingDelete = true;
+					const auto actor = h.get().get();
+					const LODBand band = FaceLOD::GetBand(actor);
+					auto evaluator = FrameEvaluator::GetSingleton();
+					FrameEvaluator::Reader preEvaluated{ *evaluator };
+					auto& anim = a->second.anim;
+					std::scoped_lock al{ anim->lock };
+					bool advanced = true;
+					if (!anim->havokSync) {
+						advanced = anim->Advance(timeDelta);
+					} else {
+						anim->lastTimeDelta = timeDelta;
+						if (!anim->paused && band != LODBand::kFrozen && !Misc::SyncInfoCache::IsInTransition(actor)) {
+							if (auto syncTime = Misc::SyncInfoCache::GetSyncTime(actor); syncTime.has_value()) {
+								anim->timeElapsed = anim->loop ? std::fmod(syncTime->current, anim->duration) : syncTime->current;
+							}
 						}
+					}
+
+					if (!advanced) {
+						pendingDelete = true;
 					} else {
-						const auto actor = h.get().get();
-						auto& syncInfo = a->second.syncInfoCache;
-						syncInfo.otherSyncInfo.clear();
-						std::scoped_lock al{ a->second.anim->lock };
-						if (!a->second.anim->paused && !RE::BGSAnimationSystemUtils::IsActiveGraphInTransition(actor) && RE::BGSAnimationSystemUtils::GetActiveSyncInfo(actor, syncInfo)) {
-							a->second.anim->timeElapsed = a->second.anim->loop ? std::fmod(syncInfo.currentAnimTime, a->second.anim->data.duration) : syncInfo.currentAnimTime;
+						auto r = anim->UpdateNoDelta(data, eyeGeo, band, band == LODBand::kFull ? preEvaluated.Find(data) : nullptr);
+						if (band == LODBand::kFull) {
+							evaluator->RecordApply(r.preEvaluated);
 						}
-						a->second.anim->UpdateNoDelta(data, eyeGeo);
+						FaceLOD::RecordFrame(band, r.morphs, r.written);
+					}
+
+					if (a->second.eyeOverride.has_value()) {
+						anim->InvalidateEyes();
 					}
 				}
 
@@ -185,6 +232,26 @@ namespace FaceAnimation
 			return result;
 		}
 
+		//Called at the start of each game loop tick, samples every playing animation ahead of the face update hook.
+		void PreEvaluate()
+		{
+			auto evaluator = FrameEvaluator::GetSingleton();
+			if (!evaluator->IsEnabled() || managedFaces.size() == 0) {
+				return;
+			}
+
+			thread_local std::vector<FrameEvaluator::Job> jobs;
+			jobs.clear();
+			std::shared_lock l{ stateLock };
+			for (auto& [face, hndl] : state->managedDatas) {
+				auto a = state->managedAnims.find(hndl);
+				if (a != state->managedAnims.end() && a->second.anim != nullptr) {
+					jobs.push_back({ face, a->second.anim.get() });
+				}
+			}
+			evaluator->Publish(jobs);
+		}
+
 		//Once an animation is passed to this function, it is considered "managed" by FaceUpdateHook.
 		//If the animation needs to be accessed and/or modified after this point, use VisitAnimation().
 		void StartAnimation(RE::ActorHandle targetActor, std::unique_ptr<FaceAnimation> anim, std::string id = "", bool animOverride = false)
@@ -205,7 +272,7 @@ namespace FaceAnimation
 			anim->SetStartNow();
 			managedActor.anim = std::move(anim);
 			managedActor.animationId = id;
-			state->managedDatas[GameUtil::GetFaceAnimData(a.get())] = targetActor;
+			SetDataManaged_NonThreadSafe(GameUtil::GetFaceAnimData(a.get()), targetActor);
 		}
 
 		bool LoadAndPlayAnimation(RE::ActorHandle targetActor, std::string id, bool loop = false, bool havokSync = false)
@@ -213,35 +280,25 @@ namespace FaceAnimation
 			if (auto targetAnim = Data::GetFaceAnim(id); targetAnim == nullptr) {
 				return false;
 			}
-
-			auto newAnim = std::make_unique<FaceAnimation>();
-			newAnim->loop = loop;
-			newAnim->havokSync = havokSync;
-
-			std::unique_lock l{ loadingAnimsLock };
-			loadingAnims[targetActor] = id;
-			l.unlock();
-
-			std::thread([targetActor = std::move(targetActor), inst = std::move(newAnim), id = std::move(id)]() mutable {
-				bool successful = inst->LoadData(id);
-				std::unique_lock l{ loadingAnimsLock };
-				if (loadingAnims.contains(targetActor) && loadingAnims[targetActor] == id) {
-					loadingAnims.erase(targetActor);
-					if (successful) {
-						StartAnimation(targetActor, std::move(inst), id);
-					}
-				}
-			}).detach();
+			Data::UsageStats::Record(Data::UsageStats::kFaceAnim, id);
+
+			const bool predicted = Prefetcher::Consume(id);
+			const auto requestTime = Utility::CreatePerfCounter();
+			AnimLoader::GetSingleton()->Request(targetActor.native_handle(), id, [targetActor, id, loop, havokSync, predicted, requestTime](std::shared_ptr<const AnimationData> data) {
+				Prefetcher::RecordGap(predicted, Utility::QueryPerfCounterTime(requestTime));
+				auto inst = std::make_unique<FaceAnimation>();
+				inst->loop = loop;
+				inst->havokSync = havokSync;
+				inst->SetData(std::move(data));
+				StartAnimation(targetActor, std::move(inst), id);
+			});
 
 			return true;
 		}
 
 		void StopAnimation(RE::ActorHandle targetActor, bool animOverride = false) {
-			std::unique_lock l1{ loadingAnimsLock };
-			if (loadingAnims.contains(targetActor)) {
-				loadingAnims.erase(targetActor);
-			}
-			std::unique_lock l2{ stateLock };
+			AnimLoader::GetSingleton()->Cancel(targetActor.native_handle());
+			std::unique_lock l{ stateLock };
 			auto managedActor = state->managedAnims.find(targetActor);
 
 			if (managedActor != state->managedAnims.end()) {
@@ -253,8 +310,7 @@ namespace FaceAnimation
 					if (animOverride) {
 						FaceData::AnimInfo animInfo = managedActor->second.animBackup.value();
 						managedActor->second.animBackup = std::nullopt;
-						l1.unlock();
-						l2.unlock();
+						l.unlock();
 						LoadAndPlayAnimation(targetActor, animInfo.animationId, animInfo.loop, animInfo.havokSync);
 					} else {
 						managedActor->second.animBackup = std::nullopt;
@@ -280,7 +336,7 @@ namespace FaceAnimation
 		{
 			std::unique_lock l{ stateLock };
 			state->managedAnims[targetActor].eyeOverride = EyeVector{ u * -0.25, v * 0.2 };
-			state->managedDatas[GameUtil::GetFaceAnimData(targetActor.get().get())] = targetActor;
+			SetDataManaged_NonThreadSafe(GameUtil::GetFaceAnimData(targetActor.get().get()), targetActor);
 		}
 
 		void ClearEyeOverride(RE::ActorHandle targetActor)
@@ -293,9 +349,13 @@ namespace FaceAnimation
 		}
 
 		void Reset() {
-			std::scoped_lock l{ loadingAnimsLock, stateLock, geoCacheLock };
+			AnimLoader::GetSingleton()->CancelAll();
+			Prefetcher::Reset();
+			FrameEvaluator::GetSingleton()->Clear();
+			FaceLOD::Reset();
+			std::scoped_lock l{ stateLock, geoCacheLock };
 			state = std::make_unique<PersistentState>();
-			loadingAnims.clear();
+			managedFaces.Clear();
 			eyeGeoCache.clear();
 		}
 
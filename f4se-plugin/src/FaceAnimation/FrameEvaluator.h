@@ -0,0 +1,241 @@
+#pragma once
+#include "FaceAnimation/Animation.h"
+#include "Misc/WorkerPool.h"
+
+namespace FaceAnimation
+{
+	//Samples every playing face animation at the start of the game loop tick, spread over a small pool of worker threads,
+	//so that the face update hook only has to copy the results. Results are double buffered: Publish() fills the back
+	//buffer while the hooks read the front one, then swaps them. Each buffer has its own lock, which is only ever
+	//contended by a hook that's still reading a buffer from two ticks ago.
+	//Animations that will be sampled from the same data, loop state & time (to within FACEANIM_PREEVAL_SHARE_STEP), such as
+	//havok synced actors in a group scene, are only evaluated once & the result is copied to every face in the group.
+	//Sharing only happens here, so it's off along with pre-evaluation, & the hook evaluates every face on its own then.
+	//The pool size is iFacePreEvalThreads (plus the calling thread), 0 disables pre-evaluation.
+	class FrameEvaluator
+	{
+	public:
+		struct Job
+		{
+			RE::BSFaceGenAnimationData* face;
+			FaceAnimation* anim;
+		};
+
+		struct Metrics
+		{
+			uint64_t ticks = 0;
+			uint64_t evaluated = 0;
+			uint64_t shared = 0;
+			uint64_t applied = 0;
+			uint64_t fallbacks = 0;
+			double totalTickMs = 0.0;
+			double maxTickMs = 0.0;
+
+			double QAverageTickMs() const
+			{
+				return ticks > 0 ? totalTickMs / static_cast<double>(ticks) : 0.0;
+			}
+
+			//Share of full rate hook updates that could use the pre-evaluated values, the rest drifted too far from the predicted time.
+			double QAppliedRate() const
+			{
+				const uint64_t total = applied + fallbacks;
+				return total > 0 ? static_cast<double>(applied) / static_cast<double>(total) : 0.0;
+			}
+		};
+
+		struct Buffer
+		{
+			std::shared_mutex lock;
+			std::vector<EvaluatedFace> results;
+			std::unordered_map<RE::BSFaceGenAnimationData*, size_t> index;
+		};
+
+		//Keeps the front buffer locked for as long as the hook is using its results.
+		class Reader
+		{
+		public:
+			Reader(FrameEvaluator& owner) :
+				buffer(owner.buffers[owner.front.load(std::memory_order_acquire)]), l(buffer.lock) {}
+
+			const EvaluatedFace* Find(RE::BSFaceGenAnimationData* face) const
+			{
+				auto iter = buffer.index.find(face);
+				return iter != buffer.index.end() ? &buffer.results[iter->second] : nullptr;
+			}
+
+		private:
+			Buffer& buffer;
+			std::shared_lock<std::shared_mutex> l;
+		};
+
+		static FrameEvaluator* GetSingleton()
+		{
+			static FrameEvaluator singleton;
+			return &singleton;
+		}
+
+		~FrameEvaluator()
+		{
+			Stop();
+		}
+
+		bool IsEnabled() const
+		{
+			return Data::Settings::Values.iFacePreEvalThreads.load() > 0;
+		}
+
+		//Evaluates the jobs & publishes the results. The caller must keep every job's animation alive until this returns.
+		void Publish(const std::vector<Job>& jobs)
+		{
+			auto timer = Utility::CreatePerfCounter();
+			const size_t numShared = GroupJobs(jobs);
+			auto& back = buffers[front.load(std::memory_order_relaxed) ^ 1];
+			{
+				std::unique_lock l{ back.lock };
+				back.index.clear();
+				back.results.resize(jobs.size());
+
+				auto evaluate = [&](size_t g) {
+					const size_t i = leaders[g];
+					std::scoped_lock al{ jobs[i].anim->lock };
+					jobs[i].anim->Evaluate(times[i], back.results[i]);
+				};
+
+				if (leaders.size() < FACEANIM_PREEVAL_MIN_PARALLEL) {
+					for (size_t g = 0; g < leaders.size(); g++) {
+						evaluate(g);
+					}
+				} else {
+					pool.ParallelFor(leaders.size(), evaluate, Data::Settings::Values.iFacePreEvalThreads.load());
+				}
+
+				for (size_t i = 0; i < jobs.size(); i++) {
+					if (groupOf[i] == SIZE_MAX) {
+						continue;
+					}
+
+					if (const size_t leader = leaders[groupOf[i]]; leader != i) {
+						back.results[i] = back.results[leader];
+					}
+					back.index[jobs[i].face] = i;
+				}
+			}
+			front.fetch_xor(1, std::memory_order_release);
+
+			const double ms = Utility::QueryPerfCounterTime(timer);
+			std::unique_lock l{ metricsLock };
+			metrics.ticks++;
+			metrics.evaluated += leaders.size();
+			metrics.shared += numShared;
+			metrics.totalTickMs += ms;
+			metrics.maxTickMs = std::max(metrics.maxTickMs, ms);
+		}
+
+		void RecordApply(bool applied)
+		{
+			(applied ? appliedCount : fallbackCount).fetch_add(1, std::memory_order_relaxed);
+		}
+
+		//Drops published results, so nothing is applied to faces that were managed before.
+		void Clear()
+		{
+			for (auto& b : buffers) {
+				std::unique_lock l{ b.lock };
+				b.index.clear();
+			}
+
+			std::unique_lock l{ metricsLock };
+			FoldCounts_NonThreadSafe();
+			if (metrics.ticks > 0) {
+				logger::info("Face pre-evaluation: {} ticks, {} faces evaluated, {} evaluations shared, {} applied, {} fell back to the hook ({:.1f}% applied), {:.3f}ms avg tick, {:.3f}ms max tick",
+					metrics.ticks, metrics.evaluated, metrics.shared, metrics.applied, metrics.fallbacks, metrics.QAppliedRate() * 100.0, metrics.QAverageTickMs(), metrics.maxTickMs);
+			}
+			metrics = Metrics();
+		}
+
+		void Stop()
+		{
+			pool.Stop();
+		}
+
+		Metrics QMetrics()
+		{
+			std::unique_lock l{ metricsLock };
+			FoldCounts_NonThreadSafe();
+			return metrics;
+		}
+
+	private:
+		struct ShareKey
+		{
+			const AnimationData* data;
+			int64_t step;
+			bool loop;
+
+			bool operator==(const ShareKey&) const = default;
+		};
+
+		struct ShareKeyHash
+		{
+			size_t operator()(const ShareKey& k) const
+			{
+				size_t h = std::hash<const AnimationData*>{}(k.data);
+				h ^= std::hash<int64_t>{}(k.step) + 0x9E3779B9 + (h << 6) + (h >> 2);
+				return h ^ static_cast<size_t>(k.loop);
+			}
+		};
+
+		//Predicts each job's sample time & groups jobs with the same ShareKey. Returns how many jobs share another job's result.
+		size_t GroupJobs(const std::vector<Job>& jobs)
+		{
+			groups.clear();
+			leaders.clear();
+			groupOf.assign(jobs.size(), SIZE_MAX);
+			times.assign(jobs.size(), 0.0);
+
+			size_t numShared = 0;
+			for (size_t i = 0; i < jobs.size(); i++) {
+				auto anim = jobs[i].anim;
+				std::scoped_lock al{ anim->lock };
+				auto t = anim->QPredictedTime();
+				if (!t.has_value() || anim->lodBand != LODBand::kFull) {
+					continue;
+				}
+
+				times[i] = t.value();
+				ShareKey key{ anim->data.get(), std::llround(t.value() / FACEANIM_PREEVAL_SHARE_STEP), anim->loop };
+				auto [iter, inserted] = groups.try_emplace(key, leaders.size());
+				if (inserted) {
+					leaders.push_back(i);
+				} else {
+					numShared++;
+				}
+				groupOf[i] = iter->second;
+			}
+			return numShared;
+		}
+
+		void FoldCounts_NonThreadSafe()
+		{
+			metrics.applied += appliedCount.exchange(0, std::memory_order_relaxed);
+			metrics.fallbacks += fallbackCount.exchange(0, std::memory_order_relaxed);
+		}
+
+		Buffer buffers[2];
+		std::atomic<uint32_t> front = 0;
+
+		//Only used by Publish(), which runs on the game loop thread.
+		std::unordered_map<ShareKey, size_t, ShareKeyHash> groups;
+		std::vector<size_t> leaders;
+		std::vector<size_t> groupOf;
+		std::vector<double> times;
+
+		Misc::WorkerPool pool;
+
+		std::mutex metricsLock;
+		Metrics metrics;
+		std::atomic<uint64_t> appliedCount = 0;
+		std::atomic<uint64_t> fallbackCount = 0;
+	};
+}
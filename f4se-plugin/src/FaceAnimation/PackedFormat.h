@@ -0,0 +1,268 @@
+#pragma once
+#include "FaceAnimation/AnimationData.h"
+
+namespace FaceAnimation
+{
+	//Compact binary encoding of face animations, as stored in the AnimCache.
+	//All integers are LEB128 varints, signed ones are zigzag encoded. Layout:
+	//  duration (frames), frame rate, timeline count, then per timeline:
+	//  morph (u8), flags (u8), key count,
+	//  key frames as the first frame followed by deltas,
+	//  ease run count, then (ease u8, run length) pairs,
+	//  morph values as hundredths, the first one followed by deltas, or as raw floats if kRawValues is set,
+	//  eye timelines store a raw U/V float pair per key instead.
+	//Decoding writes straight into the runtime layout of AnimationTimeline, with the same results as FrameBasedAnimData::ToRuntimeData().
+	//Data with morphs outside the expression or unknown ease functions is rejected, as morphs index straight into the expression.
+	namespace PackedFormat
+	{
+		enum TimelineFlag : uint8_t
+		{
+			kEyes = 1 << 0,
+			kRawValues = 1 << 1
+		};
+
+		class Writer
+		{
+		public:
+			void Varint(uint64_t v)
+			{
+				while (v >= 0x80) {
+					buffer.push_back(static_cast<char>((v & 0x7F) | 0x80));
+					v >>= 7;
+				}
+				buffer.push_back(static_cast<char>(v));
+			}
+
+			void SignedVarint(int64_t v)
+			{
+				Varint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+			}
+
+			void Byte(uint8_t v)
+			{
+				buffer.push_back(static_cast<char>(v));
+			}
+
+			void Float(float v)
+			{
+				const uint32_t bits = std::bit_cast<uint32_t>(v);
+				for (size_t i = 0; i < 4; i++) {
+					Byte(static_cast<uint8_t>(bits >> (i * 8)));
+				}
+			}
+
+			std::string buffer;
+		};
+
+		class Reader
+		{
+		public:
+			Reader(std::string_view _data) :
+				data(_data) {}
+
+			bool Varint(uint64_t& out)
+			{
+				out = 0;
+				for (uint32_t shift = 0; shift < 64; shift += 7) {
+					if (pos >= data.size()) {
+						return false;
+					}
+					const uint8_t b = static_cast<uint8_t>(data[pos++]);
+					out |= static_cast<uint64_t>(b & 0x7F) << shift;
+					if ((b & 0x80) == 0) {
+						return true;
+					}
+				}
+				return false;
+			}
+
+			bool SignedVarint(int64_t& out)
+			{
+				uint64_t v;
+				if (!Varint(v)) {
+					return false;
+				}
+				out = static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+				return true;
+			}
+
+			bool Byte(uint8_t& out)
+			{
+				if (pos >= data.size()) {
+					return false;
+				}
+				out = static_cast<uint8_t>(data[pos++]);
+				return true;
+			}
+
+			bool Float(float& out)
+			{
+				if (data.size() - pos < 4) {
+					return false;
+				}
+				uint32_t bits = 0;
+				for (size_t i = 0; i < 4; i++) {
+					bits |= static_cast<uint32_t>(static_cast<uint8_t>(data[pos++])) << (i * 8);
+				}
+				out = std::bit_cast<float>(bits);
+				return true;
+			}
+
+			size_t Remaining() const
+			{
+				return data.size() - pos;
+			}
+
+		private:
+			std::string_view data;
+			size_t pos = 0;
+		};
+
+		inline bool IsHundredths(float v)
+		{
+			return static_cast<float>(std::lround(v * 100.0f)) * 0.01f == v;
+		}
+
+		inline std::string Encode(const FrameBasedAnimData& anim)
+		{
+			Writer w;
+			w.Varint(static_cast<uint64_t>(std::max(anim.duration, 1)));
+			w.Varint(static_cast<uint64_t>(std::max(anim.frameRate, 1)));
+			w.Varint(anim.timelines.size());
+
+			for (auto& tl : anim.timelines) {
+				uint8_t flags = 0;
+				if (tl.isEyes) {
+					flags |= kEyes;
+				} else if (!std::all_of(tl.keys.begin(), tl.keys.end(), [](auto& k) { return IsHundredths(k.second.value); })) {
+					flags |= kRawValues;
+				}
+
+				w.Byte(tl.morph);
+				w.Byte(flags);
+				w.Varint(tl.keys.size());
+
+				int32_t lastFrame = 0;
+				for (auto& k : tl.keys) {
+					w.SignedVarint(static_cast<int64_t>(k.first) - lastFrame);
+					lastFrame = k.first;
+				}
+
+				std::vector<std::pair<Easing::Function, uint32_t>> runs;
+				for (auto& k : tl.keys) {
+					if (!runs.empty() && runs.back().first == k.second.ease) {
+						runs.back().second++;
+					} else {
+						runs.push_back({ k.second.ease, 1 });
+					}
+				}
+				w.Varint(runs.size());
+				for (auto& r : runs) {
+					w.Byte(r.first);
+					w.Varint(r.second);
+				}
+
+				if (flags & kEyes) {
+					for (auto& k : tl.keys) {
+						w.Float(static_cast<float>(k.second.eyesValue.u));
+						w.Float(static_cast<float>(k.second.eyesValue.v));
+					}
+				} else if (flags & kRawValues) {
+					for (auto& k : tl.keys) {
+						w.Float(k.second.value);
+					}
+				} else {
+					int64_t lastValue = 0;
+					for (auto& k : tl.keys) {
+						const int64_t v = std::lround(k.second.value * 100.0f);
+						w.SignedVarint(v - lastValue);
+						lastValue = v;
+					}
+				}
+			}
+
+			return std::move(w.buffer);
+		}
+
+		inline bool Decode(std::string_view data, AnimationData& out)
+		{
+			Reader r(data);
+			uint64_t durationFrames, frameRate, timelineCount;
+			if (!r.Varint(durationFrames) || !r.Varint(frameRate) || !r.Varint(timelineCount) ||
+				durationFrames == 0 || frameRate == 0 || timelineCount > r.Remaining()) {
+				return false;
+			}
+
+			const double rate = static_cast<double>(frameRate);
+			out.duration = static_cast<double>(durationFrames) / rate;
+			out.timelines.clear();
+			out.timelines.resize(timelineCount);
+
+			for (auto& tl : out.timelines) {
+				uint8_t flags;
+				uint64_t keyCount;
+				if (!r.Byte(tl.morph) || !r.Byte(flags) || !r.Varint(keyCount) || tl.morph >= FACEANIM_MORPH_COUNT || keyCount > r.Remaining()) {
+					return false;
+				}
+				tl.isEyes = (flags & kEyes) != 0;
+
+				tl.times.resize(keyCount);
+				int64_t frame = 0;
+				for (auto& t : tl.times) {
+					int64_t delta;
+					if (!r.SignedVarint(delta)) {
+						return false;
+					}
+					frame += delta;
+					t = static_cast<float>((static_cast<double>(frame) / rate) / out.duration);
+				}
+
+				uint64_t runCount;
+				if (!r.Varint(runCount) || runCount > keyCount) {
+					return false;
+				}
+				tl.eases.reserve(keyCount);
+				for (uint64_t i = 0; i < runCount; i++) {
+					uint8_t ease;
+					uint64_t length;
+					if (!r.Byte(ease) || !r.Varint(length) || ease >= Easing::EaseFunctions.size() || length > keyCount - tl.eases.size()) {
+						return false;
+					}
+					tl.eases.insert(tl.eases.end(), length, static_cast<Easing::Function>(ease));
+				}
+				if (tl.eases.size() != keyCount) {
+					return false;
+				}
+
+				if (tl.isEyes) {
+					tl.eyes.resize(keyCount);
+					for (auto& e : tl.eyes) {
+						if (!r.Float(e.first) || !r.Float(e.second)) {
+							return false;
+						}
+					}
+				} else if (flags & kRawValues) {
+					tl.values.resize(keyCount);
+					for (auto& v : tl.values) {
+						if (!r.Float(v)) {
+							return false;
+						}
+					}
+				} else {
+					tl.values.resize(keyCount);
+					int64_t value = 0;
+					for (auto& v : tl.values) {
+						int64_t delta;
+						if (!r.SignedVarint(delta)) {
+							return false;
+						}
+						value += delta;
+						v = static_cast<float>(value) * 0.01f;
+					}
+				}
+			}
+
+			return true;
+		}
+	}
+}
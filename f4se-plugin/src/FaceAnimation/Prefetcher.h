@@ -0,0 +1,141 @@
+#pragma once
+#include "FaceAnimation/AnimLoader.h"
+
+namespace FaceAnimation
+{
+	//Warms the DecodedAnimCache with face animations that scenes are likely to play next, so that a stage or
+	//position change doesn't have to wait for the animation to be read & decoded.
+	//Each Prefetch() call is limited to iFacePrefetchBudgetKB of not yet decoded data, estimated from the average
+	//size of previous loads. Candidates are taken in order of weight, and anything below FACEANIM_PREFETCH_MIN_WEIGHT is skipped.
+	//Play requests report whether their animation was predicted & how long it took to start, for the hit rate and transition gap metrics.
+	class Prefetcher
+	{
+	public:
+		struct Metrics
+		{
+			uint64_t rounds = 0;
+			uint64_t issued = 0;
+			uint64_t alreadyCached = 0;
+			uint64_t overBudget = 0;
+			uint64_t hits = 0;
+			uint64_t misses = 0;
+			double totalHitGapMs = 0.0;
+			double totalMissGapMs = 0.0;
+
+			double QHitRate() const
+			{
+				const uint64_t total = hits + misses;
+				return total > 0 ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+			}
+
+			double QAverageHitGapMs() const
+			{
+				return hits > 0 ? totalHitGapMs / static_cast<double>(hits) : 0.0;
+			}
+
+			double QAverageMissGapMs() const
+			{
+				return misses > 0 ? totalMissGapMs / static_cast<double>(misses) : 0.0;
+			}
+		};
+
+		//Candidates are (face animation ID, weight) pairs, in any order.
+		static void Prefetch(std::vector<std::pair<std::string, float>> candidates)
+		{
+			const size_t budget = static_cast<size_t>(Data::Settings::Values.iFacePrefetchBudgetKB.load()) * 1024;
+			if (budget == 0 || Data::Settings::Values.iFaceAnimCacheBudgetKB.load() == 0) {
+				return;
+			}
+
+			std::stable_sort(candidates.begin(), candidates.end(), [](auto& a, auto& b) { return a.second > b.second; });
+
+			std::unique_lock l{ lock };
+			metrics.rounds++;
+			round++;
+			std::erase_if(predicted, [](const auto& p) { return round - p.second > PredictionRounds; });
+
+			size_t queuedBytes = 0;
+			for (auto& c : candidates) {
+				if (c.second < FACEANIM_PREFETCH_MIN_WEIGHT) {
+					break;
+				}
+
+				auto [iter, inserted] = predicted.insert({ c.first, round });
+				if (!inserted) {
+					iter->second = round;
+					continue;
+				}
+
+				auto targetAnim = Data::GetFaceAnim(c.first);
+				if (targetAnim == nullptr) {
+					predicted.erase(iter);
+					continue;
+				}
+
+				if (Data::DecodedAnimCache::Contains(targetAnim->fileName)) {
+					metrics.alreadyCached++;
+					continue;
+				}
+
+				if (queuedBytes + averageBytes > budget) {
+					metrics.overBudget++;
+					predicted.erase(iter);
+					continue;
+				}
+
+				queuedBytes += averageBytes;
+				metrics.issued++;
+				AnimLoader::GetSingleton()->Prefetch(c.first, [](std::shared_ptr<const AnimationData> data) {
+					std::unique_lock l{ lock };
+					averageBytes = (averageBytes * 7 + data->QMemoryUsage()) / 8;
+				});
+			}
+		}
+
+		//Called when an animation is requested for playback, returns true if it was predicted.
+		static bool Consume(const std::string& id)
+		{
+			std::unique_lock l{ lock };
+			return predicted.erase(id) > 0;
+		}
+
+		static void RecordGap(bool predictedHit, double ms)
+		{
+			std::unique_lock l{ lock };
+			if (predictedHit) {
+				metrics.hits++;
+				metrics.totalHitGapMs += ms;
+			} else {
+				metrics.misses++;
+				metrics.totalMissGapMs += ms;
+			}
+		}
+
+		static Metrics QMetrics()
+		{
+			std::unique_lock l{ lock };
+			return metrics;
+		}
+
+		static void Reset()
+		{
+			std::unique_lock l{ lock };
+			if (metrics.rounds > 0) {
+				logger::info("Face animation prefetch: {} rounds, {} issued, {} already cached, {} over budget, {:.1f}% hit rate, {:.2f}ms avg gap on hits, {:.2f}ms avg gap on misses",
+					metrics.rounds, metrics.issued, metrics.alreadyCached, metrics.overBudget, metrics.QHitRate() * 100.0, metrics.QAverageHitGapMs(), metrics.QAverageMissGapMs());
+			}
+			metrics = Metrics();
+			predicted.clear();
+		}
+
+	private:
+		// Predictions that haven't been played after this many rounds are forgotten.
+		static constexpr uint64_t PredictionRounds = 8;
+
+		inline static safe_mutex lock;
+		inline static std::unordered_map<std::string, uint64_t> predicted;
+		inline static uint64_t round = 0;
+		inline static size_t averageBytes = 32 * 1024;
+		inline static Metrics metrics;
+	};
+}
@@ -103,11 +103,11 @@ namespace Menu
 				}
 
 				void remove(size_t index) {
-					animationImpl->slots.erase(std::next(animationImpl->slots.begin(), index));
+					animationImpl->slots.erase(index);
 				}
 
-				Data::Animation::Slot& operator[](size_t index) {
-					return animationImpl->slots.at(index);
+				Data::Animation::Slot GetSlot(size_t index) {
+					return animationImpl->slots.Get(index);
 				}
 			};
 
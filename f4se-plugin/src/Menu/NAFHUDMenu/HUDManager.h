@@ -462,7 +462,7 @@ namespace Menu
 					SetElementPosition(p.first, p.second.endX, p.second.endY);
 					iter = state->activeTranslations.erase(iter);
 				} else {
-					float normalizedTime = static_cast<float>(Easing::Ease(p.second.elapsedTime / p.second.totalTime, p.second.ease));
+					float normalizedTime = Easing::Fast::Ease(p.second.elapsedTime / p.second.totalTime, p.second.ease);
 					SetElementPosition(p.first, std::lerp(p.second.startX, p.second.endX, normalizedTime), std::lerp(p.second.startY, p.second.endY, normalizedTime));
 					iter++;
 				}
@@ -374,7 +374,7 @@ namespace Menu::NAF
 			(*previewTarget) = newTarget->GetActorHandle();
 
 			auto inst = std::make_unique<FaceAnimation::FaceAnimation>();
-			inst->data.duration = 2.0;
+			inst->duration = 2.0;
 			FaceAnimation::FaceUpdateHook::StartAnimation(previewTarget->value(), std::move(inst), "", true);
 			PushChangesToPreview();
 		}
@@ -393,7 +393,7 @@ namespace Menu::NAF
 				anim->havokSync = doHavokSync;
 				anim->paused = !playingPreview;
 				anim->loop = true;
-				data->animData.ToRuntimeData(&anim->data);
+				anim->SetData(std::make_shared<const FaceAnimation::AnimationData>(data->animData.ToRuntimeData()));
 				if (!playingPreview) {
 					anim->timeElapsed = GetTimeOfCurrentFrame();
 				}
@@ -460,14 +460,10 @@ namespace Menu::NAF
 					int res = 0;
 					if (previewTarget->has_value()) {
 						FaceAnimation::FaceUpdateHook::VisitAnimation(previewTarget->value(), [&](FaceAnimation::FaceAnimation* anim) {
-							for (auto& tl : anim->data.timelines) {
-								if (tl.isEyes) {
-									auto resVec = tl.GetEyesValueAtTime(GetTimeOfCurrentFrame() / anim->data.duration);
-									resVec.ConvertRange(false);
-									auto resD = ((isX ? resVec.u : resVec.v) * 100);
-									res = std::clamp(static_cast<int>(resD + (resD > 0 ? 0.1 : -0.1)), -100, 100);
-									break;
-								}
+							if (auto resVec = anim->GetEyesValueAtTime(GetTimeOfCurrentFrame()); resVec.has_value()) {
+								resVec->ConvertRange(false);
+								auto resD = ((isX ? resVec->u : resVec->v) * 100);
+								res = std::clamp(static_cast<int>(resD + (resD > 0 ? 0.1 : -0.1)), -100, 100);
 							}
 						});
 					}
@@ -507,12 +503,8 @@ namespace Menu::NAF
 					int res = 0;
 					if (previewTarget->has_value()) {
 						FaceAnimation::FaceUpdateHook::VisitAnimation(previewTarget->value(), [&](FaceAnimation::FaceAnimation* anim) {
-							for (auto& tl : anim->data.timelines) {
-								if (!tl.isEyes && tl.morph == morph) {
-									auto resF = tl.GetValueAtTime(GetTimeOfCurrentFrame() / anim->data.duration);
-									res = std::clamp(static_cast<int>((resF * 100) + 0.1f), 0, 100);
-									break;
-								}
+							if (auto resF = anim->GetMorphValueAtTime(morph, GetTimeOfCurrentFrame()); resF.has_value()) {
+								res = std::clamp(static_cast<int>((resF.value() * 100) + 0.1f), 0, 100);
 							}
 						});
 					}
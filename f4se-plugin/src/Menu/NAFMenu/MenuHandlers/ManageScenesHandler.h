@@ -77,7 +77,7 @@ namespace Menu::NAF
 		}
 
 		void OnSceneStart(const Events::EventData& data) {
-			if (auto uid = std::any_cast<uint64_t>(&data); currentStage == Stage::kManageWalkInstance && uid && (*uid) == selectionId) {
+			if (auto uid = std::get_if<uint64_t>(&data); currentStage == Stage::kManageWalkInstance && uid && (*uid) == selectionId) {
 				currentStage = Stage::kManageScene;
 				manager->RefreshList(false);
 			} else if (currentStage == Stage::kSelectScene) {
@@ -87,7 +87,7 @@ namespace Menu::NAF
 
 		void OnSceneEnd(const Events::EventData& data)
 		{
-			if (auto uid = std::any_cast<uint64_t>(&data); currentStage != Stage::kSelectScene && uid && (*uid) == selectionId) {
+			if (auto uid = std::get_if<uint64_t>(&data); currentStage != Stage::kSelectScene && uid && (*uid) == selectionId) {
 				currentStage = Stage::kSelectScene;
 				manager->RefreshList(true);
 				manager->ShowNotification("Scene ended.");
@@ -99,13 +99,13 @@ namespace Menu::NAF
 		template <typename T>
 		void RefreshIfMatchPair(const Events::EventData& data)
 		{
-			if (auto info = std::any_cast<std::pair<uint64_t, T>>(&data); currentStage == Stage::kManageScene && info && info->first == selectionId) {
+			if (auto info = std::get_if<std::pair<uint64_t, T>>(&data); currentStage == Stage::kManageScene && info && info->first == selectionId) {
 				manager->RefreshList(false);
 			}
 		}
 
 		void OnSceneAnimLoop(const Events::EventData& data) {
-			if (auto info = std::any_cast<uint64_t>(&data); currentStage == Stage::kManageScene && info && (*info) == selectionId) {
+			if (auto info = std::get_if<uint64_t>(&data); currentStage == Stage::kManageScene && info && (*info) == selectionId) {
 				manager->ShowNotification("Looped!", 0.5f);
 			}
 		}
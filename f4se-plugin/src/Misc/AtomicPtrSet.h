@@ -0,0 +1,183 @@
+#pragma once
+
+namespace Misc
+{
+	//Open-addressing set of pointers with lock-free lookups, for checks on hot paths where nearly every lookup misses.
+	//Writers must be serialized externally. A slot only ever goes from empty to used, erased & used again, so a
+	//concurrent reader's probe chain is never cut short. Once too many slots have been used, live entries are
+	//rehashed into a new table. Readers count themselves while probing, & replaced tables are only freed by a writer that
+	//sees no readers at all, so a reader still probing one stays valid however long it takes.
+	template <typename T>
+	class AtomicPtrSet
+	{
+	public:
+		AtomicPtrSet()
+		{
+			Publish(std::make_unique<Table>(MinCapacity));
+		}
+
+		AtomicPtrSet(const AtomicPtrSet&) = delete;
+		AtomicPtrSet& operator=(const AtomicPtrSet&) = delete;
+
+		bool Contains(const T* ptr) const
+		{
+			if (count.load(std::memory_order_acquire) == 0) {
+				return false;
+			}
+
+			readers.fetch_add(1);
+			const bool result = Find(*table.load(), ptr) != SIZE_MAX;
+			readers.fetch_sub(1, std::memory_order_release);
+			return result;
+		}
+
+		bool Insert(const T* ptr)
+		{
+			FreeRetired();
+			if (ptr == nullptr || Find(*owned, ptr) != SIZE_MAX) {
+				return false;
+			}
+
+			if ((owned->used + 1) * 4 > owned->capacity() * 3) {
+				Rehash(count.load() + 1);
+			}
+
+			auto& t = *owned;
+			for (size_t i = Hash(ptr) & t.mask;; i = (i + 1) & t.mask) {
+				const uintptr_t v = t.slots[i].load(std::memory_order_relaxed);
+				if (v == Empty || v == Erased) {
+					if (v == Empty) {
+						t.used++;
+					}
+					t.slots[i].store(reinterpret_cast<uintptr_t>(ptr), std::memory_order_release);
+					break;
+				}
+			}
+
+			count.fetch_add(1, std::memory_order_release);
+			return true;
+		}
+
+		bool Erase(const T* ptr)
+		{
+			FreeRetired();
+			const size_t i = Find(*owned, ptr);
+			if (i == SIZE_MAX) {
+				return false;
+			}
+
+			owned->slots[i].store(Erased, std::memory_order_release);
+			count.fetch_sub(1, std::memory_order_release);
+			return true;
+		}
+
+		void Clear()
+		{
+			count.store(0, std::memory_order_release);
+			Publish(std::make_unique<Table>(MinCapacity));
+		}
+
+		size_t size() const
+		{
+			return count.load(std::memory_order_acquire);
+		}
+
+	private:
+		static constexpr uintptr_t Empty = 0;
+		static constexpr uintptr_t Erased = 1;
+		static constexpr size_t MinCapacity = 64;
+
+		struct Table
+		{
+			Table(size_t capacity) :
+				slots(std::make_unique<std::atomic<uintptr_t>[]>(capacity)), mask(capacity - 1)
+			{
+				for (size_t i = 0; i < capacity; i++) {
+					slots[i].store(Empty, std::memory_order_relaxed);
+				}
+			}
+
+			size_t capacity() const
+			{
+				return mask + 1;
+			}
+
+			std::unique_ptr<std::atomic<uintptr_t>[]> slots;
+			size_t mask;
+			size_t used = 0;
+		};
+
+		static size_t Hash(const T* ptr)
+		{
+			uint64_t h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)) >> 4;
+			h ^= h >> 17;
+			h *= 0x9E3779B97F4A7C15ull;
+			return static_cast<size_t>(h ^ (h >> 32));
+		}
+
+		static size_t Find(const Table& t, const T* ptr)
+		{
+			const uintptr_t target = reinterpret_cast<uintptr_t>(ptr);
+			size_t i = Hash(ptr) & t.mask;
+			for (size_t n = 0; n < t.capacity(); n++, i = (i + 1) & t.mask) {
+				const uintptr_t v = t.slots[i].load(std::memory_order_acquire);
+				if (v == target) {
+					return i;
+				} else if (v == Empty) {
+					break;
+				}
+			}
+			return SIZE_MAX;
+		}
+
+		void Rehash(size_t minLive)
+		{
+			size_t capacity = MinCapacity;
+			while (capacity < minLive * 2) {
+				capacity *= 2;
+			}
+
+			auto next = std::make_unique<Table>(capacity);
+			for (size_t i = 0; i < owned->capacity(); i++) {
+				const uintptr_t v = owned->slots[i].load(std::memory_order_relaxed);
+				if (v == Empty || v == Erased) {
+					continue;
+				}
+
+				size_t j = Hash(reinterpret_cast<const T*>(v)) & next->mask;
+				while (next->slots[j].load(std::memory_order_relaxed) != Empty) {
+					j = (j + 1) & next->mask;
+				}
+				next->slots[j].store(v, std::memory_order_relaxed);
+				next->used++;
+			}
+			Publish(std::move(next));
+		}
+
+		void Publish(std::unique_ptr<Table> next)
+		{
+			table.store(next.get());
+			if (owned) {
+				retired.push_back(std::move(owned));
+			}
+			owned = std::move(next);
+			FreeRetired();
+		}
+
+		//A reader that got hold of a retired table counted itself before loading the table pointer, which was before the
+		//table was replaced, so it's either still counted or done with the table.
+		//Both sides store then load, which only orders like that if all four are seq_cst, so the readers load must be too.
+		void FreeRetired()
+		{
+			if (!retired.empty() && readers.load() == 0) {
+				retired.clear();
+			}
+		}
+
+		std::atomic<const Table*> table = nullptr;
+		std::atomic<size_t> count = 0;
+		mutable std::atomic<uint32_t> readers = 0;
+		std::unique_ptr<Table> owned;
+		std::vector<std::unique_ptr<Table>> retired;
+	};
+}
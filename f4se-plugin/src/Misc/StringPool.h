@@ -0,0 +1,94 @@
+#pragma once
+#include <shared_mutex>
+
+namespace Misc
+{
+	//Process-wide pool of interned strings, referred to by a 32-bit ID. ID 0 is always the empty string.
+	//Strings are stored in fixed-size chunks that are never moved or freed, so Get() is lock-free and
+	//the returned reference stays valid for the lifetime of the process.
+	class StringPool
+	{
+	public:
+		typedef uint32_t ID;
+		static constexpr ID EmptyID = 0;
+
+		static ID Intern(const std::string_view& s)
+		{
+			if (s.empty()) {
+				return EmptyID;
+			}
+
+			{
+				std::shared_lock l{ lock };
+				if (auto iter = ids.find(s); iter != ids.end()) {
+					return iter->second;
+				}
+			}
+
+			std::unique_lock l{ lock };
+			if (auto iter = ids.find(s); iter != ids.end()) {
+				return iter->second;
+			}
+
+			ID newId = count.load();
+			const size_t chunkIdx = newId / ChunkSize;
+			if (chunkIdx >= MaxChunks) {
+				logger::warn("String pool is full, cannot intern '{}'.", s);
+				return EmptyID;
+			}
+
+			if (!chunks[chunkIdx]) {
+				chunks[chunkIdx] = std::make_unique<std::string[]>(ChunkSize);
+			}
+
+			auto& stored = chunks[chunkIdx][newId % ChunkSize];
+			stored = s;
+			ids.insert({ stored, newId });
+			count = newId + 1;
+			return newId;
+		}
+
+		static const std::string& Get(ID id)
+		{
+			if (id >= count.load()) {
+				return chunks[0][EmptyID];
+			}
+
+			return chunks[id / ChunkSize][id % ChunkSize];
+		}
+
+		static size_t QMemoryUsage()
+		{
+			std::shared_lock l{ lock };
+			size_t result = 0;
+			for (auto& c : chunks) {
+				if (c) {
+					result += ChunkSize * sizeof(std::string);
+				}
+			}
+			for (ID i = 0; i < count; i++) {
+				auto& s = Get(i);
+				if (s.capacity() > 15) {
+					result += s.capacity() + 1;
+				}
+			}
+			return result + (ids.size() * (sizeof(std::string_view) + sizeof(ID) + sizeof(void*) * 2));
+		}
+
+	private:
+		static constexpr size_t ChunkSize = 4096;
+		static constexpr size_t MaxChunks = 1024;
+
+		static std::array<std::unique_ptr<std::string[]>, MaxChunks> InitChunks()
+		{
+			std::array<std::unique_ptr<std::string[]>, MaxChunks> result;
+			result[0] = std::make_unique<std::string[]>(ChunkSize);
+			return result;
+		}
+
+		inline static std::shared_mutex lock;
+		inline static std::array<std::unique_ptr<std::string[]>, MaxChunks> chunks = InitChunks();
+		inline static std::unordered_map<std::string_view, ID> ids;
+		inline static std::atomic<ID> count = 1;
+	};
+}
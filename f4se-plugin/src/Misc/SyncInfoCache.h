@@ -0,0 +1,177 @@
+#pragma once
+
+namespace Misc
+{
+	struct SyncTime
+	{
+		float current = 0.0f;
+		float total = 0.0f;
+	};
+
+	//Where SyncInfoCache gets its data from. Replaceable, so that the cache doesn't depend on the game's animation graphs.
+	class ISyncInfoSource
+	{
+	public:
+		virtual ~ISyncInfoSource() {}
+		virtual std::optional<SyncTime> QActiveSyncTime(RE::Actor* actor) = 0;
+		virtual bool QInTransition(RE::Actor* actor) = 0;
+	};
+
+	class GameSyncInfoSource : public ISyncInfoSource
+	{
+	public:
+		virtual std::optional<SyncTime> QActiveSyncTime(RE::Actor* actor) override
+		{
+			info.otherSyncInfo.clear();
+			if (!RE::BGSAnimationSystemUtils::GetActiveSyncInfo(actor, info)) {
+				return std::nullopt;
+			}
+			return SyncTime{ info.currentAnimTime, info.totalAnimTime };
+		}
+
+		virtual bool QInTransition(RE::Actor* actor) override
+		{
+			return RE::BGSAnimationSystemUtils::IsActiveGraphInTransition(actor);
+		}
+
+	private:
+		//Reused between queries to avoid reallocating otherSyncInfo, only touched under SyncInfoCache's lock.
+		RE::BGSAnimationSystemUtils::ActiveSyncInfo info;
+	};
+
+	//Frame-scoped cache of each actor's active sync info & graph transition state.
+	//The first lookup for an actor in a frame queries its animation graph, every later lookup in the same frame
+	//(scene time tracking, smooth sync, havok synced face animations) reuses the result.
+	//NextFrame() is called at the start of each game loop tick, Invalidate() whenever an actor's animation is changed.
+	class SyncInfoCache
+	{
+	public:
+		struct Metrics
+		{
+			uint64_t frames = 0;
+			uint64_t lookups = 0;
+			uint64_t graphQueries = 0;
+			uint64_t invalidations = 0;
+			uint64_t maxQueriesPerFrame = 0;
+		};
+
+		static std::optional<SyncTime> GetSyncTime(RE::Actor* actor)
+		{
+			if (actor == nullptr) {
+				return std::nullopt;
+			}
+
+			std::unique_lock l{ lock };
+			lookups++;
+			auto& e = entries[actor];
+			if (e.syncFrame != frame) {
+				e.sync = source->QActiveSyncTime(actor);
+				e.syncFrame = frame;
+				CountQuery_NonThreadSafe();
+			}
+			return e.sync;
+		}
+
+		static bool IsInTransition(RE::Actor* actor)
+		{
+			if (actor == nullptr) {
+				return false;
+			}
+
+			std::unique_lock l{ lock };
+			lookups++;
+			auto& e = entries[actor];
+			if (e.transitionFrame != frame) {
+				e.inTransition = source->QInTransition(actor);
+				e.transitionFrame = frame;
+				CountQuery_NonThreadSafe();
+			}
+			return e.inTransition;
+		}
+
+		static void Invalidate(RE::Actor* actor)
+		{
+			std::unique_lock l{ lock };
+			if (auto iter = entries.find(actor); iter != entries.end()) {
+				entries.erase(iter);
+				invalidations++;
+			}
+		}
+
+		static void NextFrame()
+		{
+			std::unique_lock l{ lock };
+			frame++;
+			frames++;
+			queriesThisFrame = 0;
+
+			if (frame % PruneInterval == 0) {
+				std::erase_if(entries, [](const auto& e) { return std::max(e.second.syncFrame, e.second.transitionFrame) + PruneInterval < frame; });
+			}
+		}
+
+		static void SetSource(std::unique_ptr<ISyncInfoSource> newSource)
+		{
+			std::unique_lock l{ lock };
+			source = std::move(newSource);
+			entries.clear();
+		}
+
+		static Metrics QMetrics()
+		{
+			std::unique_lock l{ lock };
+			Metrics result;
+			result.frames = frames;
+			result.lookups = lookups;
+			result.graphQueries = graphQueries;
+			result.invalidations = invalidations;
+			result.maxQueriesPerFrame = maxQueriesPerFrame;
+			return result;
+		}
+
+		static void Clear()
+		{
+			std::unique_lock l{ lock };
+			if (lookups > 0) {
+				logger::info("Sync info cache: {} lookups over {} frames, {} graph queries ({} max per frame), {} invalidations",
+					lookups, frames, graphQueries, maxQueriesPerFrame, invalidations);
+			}
+			entries.clear();
+			frames = 0;
+			lookups = 0;
+			graphQueries = 0;
+			invalidations = 0;
+			maxQueriesPerFrame = 0;
+		}
+
+	private:
+		struct Entry
+		{
+			uint64_t syncFrame = 0;
+			uint64_t transitionFrame = 0;
+			std::optional<SyncTime> sync;
+			bool inTransition = false;
+		};
+
+		//Entries that haven't been looked up for this many frames are dropped.
+		static constexpr uint64_t PruneInterval = 600;
+
+		static void CountQuery_NonThreadSafe()
+		{
+			graphQueries++;
+			queriesThisFrame++;
+			maxQueriesPerFrame = std::max(maxQueriesPerFrame, queriesThisFrame);
+		}
+
+		inline static safe_mutex lock;
+		inline static std::unique_ptr<ISyncInfoSource> source = std::make_unique<GameSyncInfoSource>();
+		inline static std::unordered_map<RE::Actor*, Entry> entries;
+		inline static uint64_t frame = 1;
+		inline static uint64_t queriesThisFrame = 0;
+		inline static uint64_t frames = 0;
+		inline static uint64_t lookups = 0;
+		inline static uint64_t graphQueries = 0;
+		inline static uint64_t invalidations = 0;
+		inline static uint64_t maxQueriesPerFrame = 0;
+	};
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+namespace Misc
+{
+	//Small pool of worker threads for splitting a loop across threads, used by callers on the game loop thread.
+	//Workers are started on first use & stay asleep between batches.
+	class WorkerPool
+	{
+	public:
+		WorkerPool() {}
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		~WorkerPool()
+		{
+			Stop();
+		}
+
+		//Runs func for every index in [0, count) on up to numThreads workers & the calling thread, returns once all of them are done.
+		//Workers only join a batch while it's open, so a late worker can never pick up indices of the next batch.
+		void ParallelFor(size_t count, const std::function<void(size_t)>& func, size_t numThreads)
+		{
+			std::unique_lock l{ poolLock };
+			StartWorkers_NonThreadSafe(numThreads);
+			batchFunc = &func;
+			batchCount = count;
+			next.store(0, std::memory_order_relaxed);
+			batchId++;
+			batchOpen = true;
+			batchReady.notify_all();
+			l.unlock();
+
+			RunBatch();
+
+			l.lock();
+			batchDone.wait(l, [&] { return activeWorkers == 0; });
+			batchOpen = false;
+			batchFunc = nullptr;
+		}
+
+		void Stop()
+		{
+			std::unique_lock l{ poolLock };
+			stopping = true;
+			batchReady.notify_all();
+			l.unlock();
+
+			for (auto& w : workers) {
+				if (w.joinable()) {
+					w.join();
+				}
+			}
+
+			l.lock();
+			workers.clear();
+			stopping = false;
+		}
+
+	private:
+		void RunBatch()
+		{
+			for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < batchCount; i = next.fetch_add(1, std::memory_order_relaxed)) {
+				(*batchFunc)(i);
+			}
+		}
+
+		void StartWorkers_NonThreadSafe(size_t numThreads)
+		{
+			numThreads = std::min<size_t>(numThreads, 16);
+			while (workers.size() < numThreads) {
+				workers.emplace_back(&WorkerPool::WorkerRoutine, this);
+			}
+		}
+
+		void WorkerRoutine()
+		{
+			uint64_t lastBatch = 0;
+			std::unique_lock l{ poolLock };
+			while (true) {
+				batchReady.wait(l, [&] { return stopping || (batchOpen && batchId != lastBatch); });
+				if (stopping) {
+					break;
+				}
+
+				lastBatch = batchId;
+				activeWorkers++;
+				l.unlock();
+
+				RunBatch();
+
+				l.lock();
+				if (--activeWorkers == 0) {
+					batchDone.notify_one();
+				}
+			}
+		}
+
+		std::mutex poolLock;
+		std::condition_variable batchReady;
+		std::condition_variable batchDone;
+		std::vector<std::thread> workers;
+		bool stopping = false;
+		bool batchOpen = false;
+		uint64_t batchId = 0;
+		size_t batchCount = 0;
+		const std::function<void(size_t)>* batchFunc = nullptr;
+		size_t activeWorkers = 0;
+		std::atomic<size_t> next = 0;
+	};
+}
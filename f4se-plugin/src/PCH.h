@@ -28,4 +28,5 @@ using namespace std::literals;
 #include "cereal/types/optional.hpp"
 #include "cereal/types/atomic.hpp"
 #include "cereal/types/utility.hpp"
+#include "cereal/types/array.hpp"
 #include "pugixml/pugixml.hpp"
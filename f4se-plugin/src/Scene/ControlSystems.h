@@ -119,6 +119,28 @@ namespace Scene
 			scn->TransitionToAnimation(currentAnim);
 		}
 
+		virtual void GetLikelyNext(AnimCandidates& out, float weight) override
+		{
+			if (group == nullptr || group->stages.empty()) {
+				return;
+			}
+
+			if (group->sequential) {
+				const size_t nextStage = (currentStage + 1) < group->stages.size() ? currentStage + 1 : 0;
+				out.push_back({ Data::GetAnimation(group->stages[nextStage].animation), weight });
+			} else {
+				uint32_t total = 0;
+				for (auto& w : weights) {
+					total += w.first;
+				}
+				for (auto& w : weights) {
+					if (total > 0) {
+						out.push_back({ Data::GetAnimation(group->stages[w.second].animation), weight * static_cast<float>(w.first) / static_cast<float>(total) });
+					}
+				}
+			}
+		}
+
 		virtual void OnAnimationLoop(IControllable* scn) override
 		{
 			loopsRemaining--;
@@ -265,6 +287,37 @@ namespace Scene
 			Advance(false, true);
 		}
 
+		virtual void PrefetchNext() override
+		{
+			CheckParentPointer();
+			if (parent != nullptr)
+				parent->PrefetchNext();
+		}
+
+		virtual void GetLikelyNext(AnimCandidates& out, float weight) override
+		{
+			if (subSystem != nullptr) {
+				subSystem->GetLikelyNext(out, weight);
+			}
+
+			if (!currentNode || currentNode->children.empty()) {
+				return;
+			}
+
+			//When auto advancing, the next node has already been picked. Otherwise the player can pick any child, but most likely the selected one.
+			const float otherWeight = autoAdvance ? 0.0f : weight * 0.5f / static_cast<float>(currentNode->children.size());
+			for (size_t i = 0; i < currentNode->children.size(); i++) {
+				const float w = i == nextIndex ? weight : otherWeight;
+				if (w <= 0.0f) {
+					continue;
+				}
+
+				if (auto p = Data::GetPosition(currentNode->children[i]->position); p != nullptr) {
+					out.push_back({ p->GetBaseAnimation(), w });
+				}
+			}
+		}
+
 		void QueueSubSystem(std::unique_ptr<IControlSystem> sys)
 		{
 			queuedSubSystem = std::move(sys);
@@ -400,6 +453,7 @@ namespace Scene
 				nextIndex = Utility::RandomNumber(0ui64, currentNode->children.size() - 1);
 			}
 			UpdateHUDState(timerDur);
+			PrefetchNext();
 		}
 
 		void OnHudKey(Data::Events::event_type e, Data::Events::EventData&)
@@ -453,6 +507,7 @@ namespace Scene
 								nextIndex = 0;
 							}
 							UpdateHUDState();
+							PrefetchNext();
 							PlayOKSound();
 						} else {
 							PlayCancelSound();
@@ -466,6 +521,7 @@ namespace Scene
 								nextIndex = (currentNode->children.size() - 1);
 							}
 							UpdateHUDState();
+							PrefetchNext();
 							PlayOKSound();
 						} else {
 							PlayCancelSound();
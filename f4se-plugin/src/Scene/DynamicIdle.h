@@ -1,4 +1,5 @@
 #pragma once
+#include "Misc/SyncInfoCache.h"
 
 namespace Scene
 {
@@ -31,6 +32,7 @@ namespace Scene
 
 			if (a != nullptr && a->currentProcess != nullptr) {
 				a->currentProcess->PlayIdle(a, 0x35, Data::Forms::NAFDynIdle);
+				Misc::SyncInfoCache::Invalidate(a);
 			}
 		}
 	}
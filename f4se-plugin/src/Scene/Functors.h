@@ -14,5 +14,10 @@ namespace Scene
 		{
 			F4SE::GetTaskInterface()->AddTask(new T(sceneId));
 		}
+
+		virtual void RunOnMainThread() override
+		{
+			T(sceneId).Run();
+		}
 	};
 }
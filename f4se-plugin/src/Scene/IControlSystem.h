@@ -4,6 +4,9 @@ namespace Scene
 {
 	class IScene;
 
+	//Animations a control system may transition to next, with a weight for how likely each one is.
+	typedef std::vector<std::pair<std::shared_ptr<const Data::Animation>, float>> AnimCandidates;
+
 	class IControllable
 	{
 	public:
@@ -18,6 +21,7 @@ namespace Scene
 		virtual void SoftEnd() = 0;
 		virtual double QDuration() { return -1.0; };
 		virtual void ReportSystemCompletion() {};
+		virtual void PrefetchNext() {};
 
 		template <class Archive>
 		void serialize(Archive&)
@@ -36,6 +40,7 @@ namespace Scene
 		virtual std::string QSystemID() { return ""; }
 		virtual void Notify(const std::any&) {}
 		virtual void OnTimer(uint16_t) {}
+		virtual void GetLikelyNext(AnimCandidates&, float) {}
 
 		template <class Archive>
 		void serialize(Archive&)
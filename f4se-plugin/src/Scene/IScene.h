@@ -5,6 +5,7 @@
 #include "Tasks/TaskFunctor.h"
 #include "Scene/DynamicIdle.h"
 #include "Scene/IControlSystem.h"
+#include "Scene/SceneRegistry.h"
 
 #define SCENE_FUNCTOR()                             \
 	using SceneFunctor::SceneFunctor;               \
@@ -53,6 +54,11 @@ namespace Scene
 		{
 		}
 
+		virtual std::optional<uint64_t> QOrderingKey() const override
+		{
+			return sceneId;
+		}
+
 		template <class Archive>
 		void serialize(Archive& ar, const uint32_t)
 		{
@@ -203,7 +209,7 @@ namespace Scene
 		RE::NiPoint3 angle;
 		float animMult = 100.0;
 		IdleCache cachedIdlesMap;
-		Tasks::TaskContainer tasks;
+		Tasks::TaskContainer tasks{ Tasks::TimerDomain::kGameFrame };
 		std::unique_ptr<IControlSystem> controlSystem = nullptr;
 		std::unique_ptr<IControlSystem> queuedSystem = nullptr;
 		float lastAnimTime = 0.0f;
@@ -213,6 +219,8 @@ namespace Scene
 		std::string startEquipSet;
 		std::string stopEquipSet;
 		SceneSettings settings;
+		//Not serialized, set by SceneManager while the scene is attached.
+		SceneHandle registryHandle;
 
 		IScene()
 		{
@@ -248,8 +256,21 @@ namespace Scene
 
 		virtual void SoftEnd() {}
 
-		// Once a scene is attached to the SceneManager, Update will be called between every frame
-		virtual void Update(){}
+		// Once a scene is attached to the SceneManager, it's updated between every frame in three phases, so that
+		// the compute phase of every scene can run in parallel:
+		// GatherUpdate reads the game state the update needs, on the main thread with the scene locked.
+		// ComputeUpdate may run on any thread without the scene locked, so it may only use what GatherUpdate copied.
+		// ApplyUpdate makes the resulting game calls, on the main thread with the scene locked again.
+		virtual void GatherUpdate() {}
+		virtual void ComputeUpdate() {}
+		virtual void ApplyUpdate() {}
+
+		void Update()
+		{
+			GatherUpdate();
+			ComputeUpdate();
+			ApplyUpdate();
+		}
 
 		virtual void SetDuration(float){}
 
@@ -271,7 +292,9 @@ namespace Scene
 
 		virtual void SetSyncState(SyncState) {}
 
-		void ForEachActor(std::function<void(RE::Actor*, ActorPropertyMap&)> func, bool require3d = true)
+		//Visits actors in order, func is called as func(RE::Actor*, ActorPropertyMap&).
+		template <typename F>
+		void ForEachActor(F&& func, bool require3d = true)
 		{
 			RE::NiPointer<RE::Actor> currentActor = nullptr;
 			for (auto& a : actors) {
@@ -3,6 +3,7 @@
 #include "Functors.h"
 #include "FaceAnimation/FaceUpdateHook.h"
 #include "Misc/MathUtil.h"
+#include "UpdatePlan.h"
 #include "EventProxy.h"
 
 #define SCNSYNC_DELAY_FUNCTOR(delName)	           \
@@ -31,11 +32,23 @@ namespace Scene
 		SystemTimerFunctor(uint64_t _sceneId, uint16_t _timerId) :
 			sceneId(_sceneId), timerId(_timerId) {}
 
+		virtual std::optional<uint64_t> QOrderingKey() const override {
+			return sceneId;
+		}
+
 		virtual void Run() override {
 			F4SE::GetTaskInterface()->AddTask([sceneId = sceneId, timerId = timerId]() {
-				SceneManager::VisitScene(sceneId, [timerId = timerId](IScene* scn) {
-					scn->controlSystem->OnTimer(timerId);
-				});
+				Fire(sceneId, timerId);
+			});
+		}
+
+		virtual void RunOnMainThread() override {
+			Fire(sceneId, timerId);
+		}
+
+		static void Fire(uint64_t sceneId, uint16_t timerId) {
+			SceneManager::VisitScene(sceneId, [timerId](IScene* scn) {
+				scn->controlSystem->OnTimer(timerId);
 			});
 		}
 
@@ -165,17 +178,10 @@ namespace Scene
 	class Scene : public IScene
 	{
 	public:
-		struct LocalSyncInfo
-		{
-			RE::NiPointer<RE::Actor> actor;
-			float currentAnimTime = 0.0f;
-			float totalAnimTime = 0.0f;
-		};
-
 		using IScene::IScene;
 
 		std::vector<LocalSyncInfo> syncInfoVec;
-		RE::BGSAnimationSystemUtils::ActiveSyncInfo cachedSyncInfo;
+		UpdatePlan plan;
 		float diffLimit = 100.0f * 0.05f;
 		float basicallyFullSpeed = 100.0f * 0.9999f;
 		RE::NiPoint3 baseLocation;
@@ -251,6 +257,7 @@ namespace Scene
 		virtual bool Init(std::shared_ptr<const Data::Position> position) override
 		{
 			IScene::Init(position);
+			Data::UsageStats::Record(Data::UsageStats::kPosition, position->id);
 			startEquipSet = position->startEquipSet;
 			stopEquipSet = position->stopEquipSet;
 			controlSystem = GetControlSystem(position);
@@ -277,12 +284,12 @@ namespace Scene
 
 				if (currentActor != player) {
 					if (currentActor->HasKeyword(Data::Forms::TeammateReadyWeaponKW)) {
-						props[kHadReadyWeapon].value = true;
+						props.set(kHadReadyWeapon, true);
 						currentActor->ModifyKeyword(Data::Forms::TeammateReadyWeaponKW, false);
 					}
 
 					if (currentActor->GetCanDoFavor()) {
-						props[kWasCommandable].value = true;
+						props.set(kWasCommandable, true);
 						currentActor->SetCanDoFavor(false);
 					}
 
@@ -482,6 +489,7 @@ namespace Scene
 				return;
 
 			anim->SetActorInfo(actors);
+			Data::UsageStats::Record(Data::UsageStats::kAnimation, anim->id);
 
 			ForEachActor([&](RE::Actor* currentActor, ActorPropertyMap& props) {
 				if (auto actions = GetProperty<Data::ActionSet>(props, kAction); actions.has_value()) {
@@ -491,9 +499,37 @@ namespace Scene
 
 			ClearAnimObjects();
 			PlayAnimations();
+			PrefetchNext();
 			Data::Events::Send(Data::Events::SCENE_ANIM_CHANGE, std::pair<uint64_t, std::string>{ uid, anim->id });
 		}
 
+		virtual void PrefetchNext() override
+		{
+			if (controlSystem == nullptr) {
+				return;
+			}
+
+			AnimCandidates next;
+			controlSystem->GetLikelyNext(next, 1.0f);
+
+			std::vector<std::pair<std::string, float>> faceAnims;
+			for (auto& [anim, weight] : next) {
+				if (anim == nullptr) {
+					continue;
+				}
+
+				for (size_t i = 0; i < anim->slots.size(); i++) {
+					if (anim->slots.HasFlag(i, Data::Animation::SlotTable::kHasFaceAnim)) {
+						faceAnims.push_back({ anim->slots.GetFaceAnim(i), weight });
+					}
+				}
+			}
+
+			if (!faceAnims.empty()) {
+				FaceAnimation::Prefetcher::Prefetch(std::move(faceAnims));
+			}
+		}
+
 		virtual void PlayAnimations() override {
 			cachedIdlesMap.clear();
 			ForEachActor([&](RE::Actor* a, ActorPropertyMap& props) {
@@ -527,6 +563,7 @@ namespace Scene
 			}
 
 			QueueControlSystem(GetControlSystem(targetPos));
+			Data::UsageStats::Record(Data::UsageStats::kPosition, id);
 
 			Data::Events::Send(Data::Events::SCENE_POS_CHANGE, Data::Events::ScenePositionData{ uid, id, true });
 			return true;
@@ -573,7 +610,8 @@ namespace Scene
 			}
 		}
 
-		void UpdateSmoothSync() {
+		//Reads every actor's sync time & anim speed for the compute phase, once all of them have their sync info available.
+		void GatherSmoothSync() {
 			auto player = RE::PlayerCharacter::GetSingleton();
 			bool allActorsReady = true;
 			bool noActorsReady = true;
@@ -585,15 +623,14 @@ namespace Scene
 			float baseTotalTime = 0.0f;
 
 			ForEachActor([&](RE::Actor* currentActor, ActorPropertyMap&) {
-				cachedSyncInfo.otherSyncInfo.clear();
 				//We don't want to make any changes until all actors are finished transitioning
 				//to the animation and have their active sync info available.
-				if (RE::BGSAnimationSystemUtils::GetActiveSyncInfo(currentActor, cachedSyncInfo) &&
-					cachedSyncInfo.currentAnimTime >= 0.0f) {
+				auto syncTime = Misc::SyncInfoCache::GetSyncTime(currentActor);
+				if (syncTime.has_value() && syncTime->current >= 0.0f) {
 					auto& ele = syncInfoVec[i];
 					ele.actor.reset(currentActor);
-					ele.currentAnimTime = std::clamp(cachedSyncInfo.currentAnimTime + (playerSyncOffset * (currentActor == player)), 0.0f, cachedSyncInfo.totalAnimTime);
-					ele.totalAnimTime = cachedSyncInfo.totalAnimTime;
+					ele.currentAnimTime = std::clamp(syncTime->current + (playerSyncOffset * (currentActor == player)), 0.0f, syncTime->total);
+					ele.totalAnimTime = syncTime->total;
 
 					//If this is the first actor, set minTime to its anim time to kick off the process.
 					//Use arithmetic here instead of a conditional to avoid an unneccesary branch.
@@ -607,42 +644,20 @@ namespace Scene
 				}
 			});
 
-			if (minTime > 0 && allActorsReady) {
-				bool allFullSpeed = true;
+			plan.smoothSync = minTime > 0 && allActorsReady;
+			plan.minTime = minTime;
+			plan.baseTotalTime = baseTotalTime;
+			if (plan.smoothSync) {
 				for (auto& info : syncInfoVec) {
-					//Avoid synchronizing animations that have different total times.
-					if (info.totalAnimTime != baseTotalTime) {
-						allFullSpeed = true;
-						break;
-					}
-
-					float oldMult = GameUtil::GetAnimMult(info.actor.get());
-					//Adjust each actor's animation speed to nudge their current time towards the minTime.
-					//Over time this results in an ease-out function, where anim speed is changed by a large amount
-					//at first then gradually tapers off until all current times align with the min time.
-					//To keep the function from suddenly going out of sync when one actor's current time loops
-					//back to 0 before others, the anim speed change is clamped to +/- 5% of the scene's base anim speed.
-					float mult = std::clamp(animMult * (minTime / info.currentAnimTime), oldMult - diffLimit, oldMult + diffLimit);
-					GameUtil::SetAnimMult(info.actor.get(), mult);
-
-					//basicallyFullSpeed = scene's base anim speed * 0.9999
-					if (mult < basicallyFullSpeed) {
-						allFullSpeed = false;
-					}
-				}
-
-				//Once all anim speeds are within floating point error of the scene's base anim speed,
-				//the anim times are as synchronized as they're going to get and smooth sync updates can
-				//be stopped for this scene.
-				if (allFullSpeed) {
-					SetAnimMult(animMult);
-					SetSyncState(Synced);
+					info.oldMult = info.actor != nullptr ? GameUtil::GetAnimMult(info.actor.get()) : 0.0f;
 				}
 			}
 		}
 
-		virtual void Update() override
+		virtual void GatherUpdate() override
 		{
+			plan.smoothSync = false;
+
 			switch (syncStatus) {
 			case Synced:
 				break;
@@ -651,7 +666,7 @@ namespace Scene
 					bool allReady = true;
 					for (auto& idl : cachedIdlesMap) {
 						auto a = idl.first.get();
-						if (a != nullptr && RE::BGSAnimationSystemUtils::IsActiveGraphInTransition(a.get())) {
+						if (a != nullptr && Misc::SyncInfoCache::IsInTransition(a.get())) {
 							GameUtil::SetAnimMult(a.get(), GameUtil::GetAnimMult(a.get()) + 5.0f);
 							allReady = false;
 						}
@@ -670,6 +685,7 @@ namespace Scene
 								DynamicIdle::Play(a, idl.second.dynIdle.value(), startEvent, graph);
 							} else if (a != nullptr && a->currentProcess != nullptr) {
 								a->currentProcess->PlayIdle(a, static_cast<uint32_t>(RE::DEFAULT_OBJECT::kActionIdle), idl.second.regularIdle, false);
+								Misc::SyncInfoCache::Invalidate(a);
 							}
 						}
 
@@ -680,15 +696,16 @@ namespace Scene
 			case WaitingForLoad:
 				{
 					bool oneLoading = false;
-					std::string idlePath;
 					for (auto& actorIdle : cachedIdlesMap) {
 						auto a = actorIdle.first.get().get();
-						if (actorIdle.second.dynIdle.has_value()) {
-							idlePath = actorIdle.second.dynIdle.value();
-						} else {
-							idlePath = actorIdle.second.regularIdle->animFileName;
+						if (a == nullptr) {
+							continue;
 						}
-						if (a != nullptr && (RE::BGSAnimationSystemUtils::IsIdleLoading(a, idlePath) || RE::BGSAnimationSystemUtils::IsActiveGraphInTransition(a))) {
+						//Regular idles already have their path as a BSFixedString, no need to copy it into a std::string every frame.
+						const bool idleLoading = actorIdle.second.dynIdle.has_value() ?
+						                             RE::BGSAnimationSystemUtils::IsIdleLoading(a, actorIdle.second.dynIdle.value()) :
+						                             RE::BGSAnimationSystemUtils::IsIdleLoading(a, actorIdle.second.regularIdle->animFileName);
+						if (idleLoading || Misc::SyncInfoCache::IsInTransition(a)) {
 							oneLoading = true;
 							break;
 						}
@@ -704,18 +721,16 @@ namespace Scene
 				}
 			case SyncingTimes:
 				{
-					UpdateSmoothSync();
+					GatherSmoothSync();
 					break;
 				}
 			}
 
 			if (trackAnimTime) {
-				cachedSyncInfo.otherSyncInfo.clear();
 				auto trackingActor = actors.begin()->first.get();
-				if (trackingActor != nullptr &&
-					RE::BGSAnimationSystemUtils::GetActiveSyncInfo(trackingActor.get(), cachedSyncInfo) &&
-					cachedSyncInfo.currentAnimTime >= 0.0f) {
-					animTime = cachedSyncInfo.currentAnimTime;
+				auto syncTime = Misc::SyncInfoCache::GetSyncTime(trackingActor.get());
+				if (syncTime.has_value() && syncTime->current >= 0.0f) {
+					animTime = syncTime->current;
 					if (animTime < lastAnimTime) {
 						controlSystem->OnAnimationLoop(this);
 						Data::Events::Send(Data::Events::SCENE_ANIM_LOOP, uid);
@@ -724,27 +739,78 @@ namespace Scene
 				}
 			}
 
+			plan.location = location;
+			plan.angle = angle;
+			plan.animMult = animMult;
+			plan.diffLimit = diffLimit;
+			plan.basicallyFullSpeed = basicallyFullSpeed;
+
 			auto player = RE::PlayerCharacter::GetSingleton();
-			ForEachActor([&](RE::Actor* currentActor, ActorPropertyMap& props) {
-				if (currentActor == player) {
+			plan.placements.clear();
+			//Same as ForEachActor, but keeps each actor's index so that ApplyUpdate can find its properties again.
+			for (size_t i = 0; i < actors.size(); i++) {
+				auto& a = actors.begin()[i];
+				auto currentActor = a.first.get();
+				if (!GameUtil::ActorIsEnabled(currentActor.get(), true)) {
+					continue;
+				}
+				if (currentActor.get() == player) {
 					player->UpdatePlayer3D();
 				}
-				RE::NiPoint3 actorLoc = location;
-				RE::NiPoint3 actorAngle = angle;
-				if (auto offset = GetProperty<std::pair<RE::NiPoint3, float>>(props, kOffset); offset.has_value()) {
-					MathUtil::ApplyOffsetToLocalSpace(actorLoc, offset->first, actorAngle.z);
-					actorAngle.z += offset->second;
-					MathUtil::ConstrainRadian(actorAngle.z);
+				auto& p = plan.placements.emplace_back();
+				p.actor = currentActor;
+				p.index = i;
+				p.currentLocation = currentActor->data.location;
+				p.currentAngle = currentActor->data.angle;
+				p.offset = GetProperty<std::pair<RE::NiPoint3, float>>(a.second, kOffset);
+			}
+		}
+
+		virtual void ComputeUpdate() override
+		{
+			if (plan.smoothSync) {
+				plan.ComputeSmoothSync(syncInfoVec);
+			}
+			plan.ComputePlacements();
+		}
+
+		virtual void ApplyUpdate() override
+		{
+			//Skip the anim speed changes if the scene moved on to another animation since GatherUpdate.
+			if (plan.smoothSync && syncStatus == SyncingTimes) {
+				for (size_t i = 0; i < plan.syncCount; i++) {
+					GameUtil::SetAnimMult(syncInfoVec[i].actor.get(), syncInfoVec[i].newMult);
+				}
+
+				//Once all anim speeds are within floating point error of the scene's base anim speed,
+				//the anim times are as synchronized as they're going to get and smooth sync updates can
+				//be stopped for this scene.
+				if (plan.allFullSpeed) {
+					SetAnimMult(animMult);
+					SetSyncState(Synced);
 				}
-				if (!MathUtil::CoordsWithinError(currentActor->data.angle, actorAngle)) {
-					currentActor->SetAngleOnReference(actorAngle);
+			}
+			plan.smoothSync = false;
+
+			//The scene was unlocked while the placements were computed, so its position or an actor's offset may have
+			//changed since. Placements of actors that left the scene are dropped, ones with changed inputs are redone.
+			const bool sceneMoved = plan.MoveScene(location, angle);
+			for (auto& p : plan.placements) {
+				if (p.index >= actors.size() || actors.begin()[p.index].first.get().get() != p.actor.get()) {
+					continue;
 				}
-				if (!MathUtil::CoordsWithinError(currentActor->data.location, actorLoc)) {
-					currentActor->SetPosition(actorLoc, true);
-					currentActor->DisableCollision();
-					currentActor->SetNoCollision(true);
+				plan.Recheck(p, sceneMoved, p.actor->data.location, p.actor->data.angle, GetProperty<std::pair<RE::NiPoint3, float>>(actors.begin()[p.index].second, kOffset));
+
+				if (p.moveAngle) {
+					p.actor->SetAngleOnReference(p.targetAngle);
 				}
-			});
+				if (p.moveLocation) {
+					p.actor->SetPosition(p.targetLocation, true);
+					p.actor->DisableCollision();
+					p.actor->SetNoCollision(true);
+				}
+			}
+			plan.placements.clear();
 		}
 
 		template <class Archive>
@@ -775,7 +841,9 @@ namespace Scene
 		newScene->settings.ClearPreStartInfo();
 
 		for (size_t i = 0; i < actors.size(); i++) {
-			newScene->actors.insert({ actors[i]->GetActorHandle(), { { kOrder, ActorProperty{ i } } } });
+			ActorPropertyMap props;
+			props.set(kOrder, static_cast<uint64_t>(i));
+			newScene->actors.insert({ actors[i]->GetActorHandle(), std::move(props) });
 		}
 
 		newScene->Init(position);
@@ -1,5 +1,6 @@
 #include <shared_mutex>
 #include "Misc/Utility.h"
+#include "Misc/WorkerPool.h"
 #include "Data/Forms.h"
 #include "Tasks/TimerThread.h"
 #include "Serialization/General.h"
@@ -277,26 +278,44 @@ namespace Scene
 
 		static const std::vector<std::shared_ptr<IScene>> GetSceneMapSnapshot() {
 			DataReadLock l{ scenesMapLock };
-			std::vector<std::shared_ptr<IScene>> result;
-			result.reserve(state->scenes.size());
-			for (const auto& p : state->scenes) {
-				result.push_back(p.second);
-			}
-			return result;
+			return registry.QScenes();
 		}
 
+		//Gathers every scene's update on the main thread, computes them across iSceneUpdateThreads workers (plus the main
+		//thread) once there are at least SCENE_UPDATE_MIN_PARALLEL of them, then applies them on the main thread.
+		//Scenes are unlocked while their updates are computed. A scene's compute phase is cheap next to waking the workers,
+		//so iSceneUpdateThreads defaults to 0 & everything stays on the main thread.
 		static void UpdateScenes() {
-			const auto localScenes = GetSceneMapSnapshot();
+			Tasks::FrameTimer::Tick();
+			SyncUpdateList();
 
-			for (auto& scn : localScenes) {
+			updating.clear();
+			for (auto& scn : updateList) {
 				std::unique_lock l{ scn->lock };
 				if (scn->status != SceneState::PendingDeletion && !scn->noUpdate && scn->actors.size() > 0) {
 					auto firstActor = scn->actors.begin()->first.get().get();
 					if (firstActor != nullptr && firstActor->parentCell != nullptr && firstActor->parentCell->loadedData != nullptr) {
-						scn->Update();
+						scn->GatherUpdate();
+						updating.push_back(scn.get());
 					}
 				}
 			}
+
+			const size_t numThreads = Data::Settings::Values.iSceneUpdateThreads.load();
+			if (updating.size() < SCENE_UPDATE_MIN_PARALLEL || numThreads == 0) {
+				for (auto scn : updating) {
+					scn->ComputeUpdate();
+				}
+			} else {
+				updatePool.ParallelFor(updating.size(), computeUpdate, numThreads);
+			}
+
+			for (auto scn : updating) {
+				std::unique_lock l{ scn->lock };
+				if (scn->status != SceneState::PendingDeletion) {
+					scn->ApplyUpdate();
+				}
+			}
 		}
 
 		static void Reset() {
@@ -309,10 +328,39 @@ namespace Scene
 
 			std::scoped_lock l{ scenesMapLock, actorsWalkingLock };
 			state = std::make_unique<PersistentState>();
+			registry.Clear();
+		}
+
+		//Re-registers every scene after the state has been replaced by loading. Caller must hold scenesMapLock.
+		static void RebuildRegistry_NonThreadSafe() {
+			registry.Clear();
+			for (auto& p : state->scenes) {
+				p.second->registryHandle = registry.Insert(p.second);
+			}
 		}
 		
 	protected:
 		inline static Data::Events::EventRegistration keyReg;
+		//Guarded by scenesMapLock, mirrors state->scenes.
+		inline static SceneRegistry registry;
+		//Main thread only. The registry's scenes as of updateListVersion, so that updating scenes every frame
+		//needs neither scenesMapLock nor a fresh copy. Detached scenes stay alive here until the next frame.
+		inline static std::vector<std::shared_ptr<IScene>> updateList;
+		inline static uint64_t updateListVersion = 0;
+		//Main thread only. Scenes gathered this frame, kept alive by updateList.
+		inline static std::vector<IScene*> updating;
+		inline static Misc::WorkerPool updatePool;
+		inline static const std::function<void(size_t)> computeUpdate = [](size_t i) { updating[i]->ComputeUpdate(); };
+
+		static void SyncUpdateList() {
+			if (registry.QVersion() == updateListVersion) {
+				return;
+			}
+
+			DataReadLock l{ scenesMapLock };
+			updateListVersion = registry.QVersion();
+			updateList.assign(registry.QScenes().begin(), registry.QScenes().end());
+		}
 
 		inline static std::shared_ptr<IScene> ReleaseSceneFromMap(uint64_t sceneId)
 		{
@@ -322,6 +370,8 @@ namespace Scene
 			if (state->scenes.contains(sceneId)) {
 				result = state->scenes[sceneId];
 				state->scenes.erase(sceneId);
+				registry.Remove(result->registryHandle);
+				result->registryHandle = {};
 			}
 
 			return result;
@@ -329,12 +379,15 @@ namespace Scene
 
 		inline static void InsertSceneIntoMap(std::shared_ptr<IScene> scn) {
 			DataWriteLock l{ scenesMapLock };
-			state->scenes.insert({ scn->uid, scn });
+			if (state->scenes.insert({ scn->uid, scn }).second) {
+				scn->registryHandle = registry.Insert(scn);
+			}
 		}
 
 		inline static void ClearSceneMap() {
 			DataWriteLock l{ scenesMapLock };
 			state->scenes.clear();
+			registry.Clear();
 		}
 
 		static void OnHudUpKey(Data::Events::event_type, Data::Events::EventData&) {
@@ -342,7 +395,7 @@ namespace Scene
 				CompleteWalk(state->playerWalkInstance);
 			}
 
-			Data::Events::Unsubscribe(Data::Events::HUD_UP_KEY_DOWN, keyReg);
+			Data::Events::Unsubscribe(keyReg);
 		}
 
 		static bool StartWalkPackage(RE::Actor* a, const RE::TESObjectREFR* destRefr, uint64_t uid) {
@@ -0,0 +1,112 @@
+#pragma once
+
+namespace Scene
+{
+	class IScene;
+
+	//Generation-tagged reference to a scene's slot in the SceneRegistry.
+	//Goes stale once the scene is removed, even after the slot is reused by another scene.
+	struct SceneHandle
+	{
+		uint32_t index = UINT32_MAX;
+		uint32_t generation = 0;
+
+		bool QValid() const {
+			return index != UINT32_MAX;
+		}
+	};
+
+	//Slot map of attached scenes, only changed when scenes are attached or detached.
+	//Scenes are kept in a dense array for iteration. Removing one moves the last scene into its place, so removal
+	//is O(1) through its handle. Not thread safe, SceneManager guards it with scenesMapLock.
+	class SceneRegistry
+	{
+	public:
+		SceneHandle Insert(std::shared_ptr<IScene> scn) {
+			uint32_t index;
+			if (!freeSlots.empty()) {
+				index = freeSlots.back();
+				freeSlots.pop_back();
+			} else {
+				index = static_cast<uint32_t>(slots.size());
+				slots.emplace_back();
+			}
+
+			auto& slot = slots[index];
+			slot.denseIndex = static_cast<uint32_t>(scenes.size());
+			scenes.push_back(std::move(scn));
+			denseToSlot.push_back(index);
+			version++;
+			return { index, slot.generation };
+		}
+
+		std::shared_ptr<IScene> Remove(SceneHandle hndl) {
+			if (!QLive(hndl)) {
+				return nullptr;
+			}
+
+			auto& slot = slots[hndl.index];
+			const uint32_t denseIndex = slot.denseIndex;
+			std::shared_ptr<IScene> result = std::move(scenes[denseIndex]);
+
+			const uint32_t last = static_cast<uint32_t>(scenes.size() - 1);
+			if (denseIndex != last) {
+				scenes[denseIndex] = std::move(scenes[last]);
+				denseToSlot[denseIndex] = denseToSlot[last];
+				slots[denseToSlot[denseIndex]].denseIndex = denseIndex;
+			}
+			scenes.pop_back();
+			denseToSlot.pop_back();
+
+			slot.generation++;
+			slot.denseIndex = UINT32_MAX;
+			freeSlots.push_back(hndl.index);
+			version++;
+			return result;
+		}
+
+		IScene* Get(SceneHandle hndl) const {
+			return QLive(hndl) ? scenes[slots[hndl.index].denseIndex].get() : nullptr;
+		}
+
+		void Clear() {
+			freeSlots.clear();
+			for (uint32_t i = 0; i < slots.size(); i++) {
+				if (slots[i].denseIndex != UINT32_MAX) {
+					slots[i].generation++;
+					slots[i].denseIndex = UINT32_MAX;
+				}
+				freeSlots.push_back(i);
+			}
+			scenes.clear();
+			denseToSlot.clear();
+			version++;
+		}
+
+		const std::vector<std::shared_ptr<IScene>>& QScenes() const {
+			return scenes;
+		}
+
+		//Increased on every change, can be read without holding the registry's lock.
+		uint64_t QVersion() const {
+			return version.load(std::memory_order_acquire);
+		}
+
+	private:
+		struct Slot
+		{
+			uint32_t generation = 0;
+			uint32_t denseIndex = UINT32_MAX;
+		};
+
+		bool QLive(SceneHandle hndl) const {
+			return hndl.index < slots.size() && slots[hndl.index].generation == hndl.generation && slots[hndl.index].denseIndex != UINT32_MAX;
+		}
+
+		std::vector<Slot> slots;
+		std::vector<uint32_t> freeSlots;
+		std::vector<std::shared_ptr<IScene>> scenes;
+		std::vector<uint32_t> denseToSlot;
+		std::atomic<uint64_t> version = 0;
+	};
+}
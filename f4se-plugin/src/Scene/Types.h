@@ -58,17 +58,319 @@ namespace Scene
 		}
 	};
 
-	typedef std::unordered_map<PropType, ActorProperty> ActorPropertyMap;
-	typedef std::unordered_map<SerializableActorHandle, ActorPropertyMap> SceneActorsMap;
+	constexpr size_t PropTypeCount = 13;
 
+	//Owns a large property value out of line, so that the common small ones keep ActorPropertyMap compact. Copies are deep,
+	//moved from properties hold nothing & copy as such.
 	template <typename T>
-	std::optional<T> GetProperty(const ActorPropertyMap& m, PropType p) {
-		auto iter = m.find(p);
-		if (iter != m.end() && std::holds_alternative<T>(iter->second.value)) {
-			return get<T>(iter->second.value);
-		} else {
+	class OutOfLineProperty
+	{
+	public:
+		OutOfLineProperty(T v) :
+			ptr(std::make_unique<T>(std::move(v))) {}
+
+		OutOfLineProperty(const OutOfLineProperty& other) :
+			ptr(Copy(other)) {}
+
+		OutOfLineProperty(OutOfLineProperty&&) noexcept = default;
+
+		OutOfLineProperty& operator=(const OutOfLineProperty& other)
+		{
+			ptr = Copy(other);
+			return *this;
+		}
+
+		OutOfLineProperty& operator=(OutOfLineProperty&&) noexcept = default;
+
+		const T& get() const
+		{
+			return *ptr;
+		}
+
+	private:
+		static std::unique_ptr<T> Copy(const OutOfLineProperty& other)
+		{
+			return other.ptr != nullptr ? std::make_unique<T>(*other.ptr) : nullptr;
+		}
+
+		std::unique_ptr<T> ptr;
+	};
+
+	//Fixed slot per PropType with a presence bitmask, so that looking up a property is an indexed load instead of a hash lookup.
+	//Strings & action sets are stored out of line, everything else inline. Slots hold the same alternatives in the same
+	//order as ActorPropertyValue, and are serialized exactly like the unordered_map<PropType, ActorProperty> this replaced,
+	//which is also why save & load aren't versioned.
+	class ActorPropertyMap
+	{
+	public:
+		ActorPropertyMap() {}
+
+		ActorPropertyMap(const ActorPropertyMap&) = default;
+		ActorPropertyMap& operator=(const ActorPropertyMap&) = default;
+
+		//Moved from maps are left empty, as their out of line values are gone.
+		ActorPropertyMap(ActorPropertyMap&& other) noexcept :
+			slots(std::move(other.slots)), present(std::exchange(other.present, 0))
+		{
+			other.slots.fill(0.0f);
+		}
+
+		ActorPropertyMap& operator=(ActorPropertyMap&& other) noexcept
+		{
+			if (this != &other) {
+				slots = std::move(other.slots);
+				present = std::exchange(other.present, 0);
+				other.slots.fill(0.0f);
+			}
+			return *this;
+		}
+
+		bool contains(PropType p) const
+		{
+			return (present & Bit(p)) != 0;
+		}
+
+		size_t size() const
+		{
+			return std::popcount(present);
+		}
+
+		template <typename T>
+		std::optional<T> get(PropType p) const
+		{
+			if (!contains(p)) {
+				return std::nullopt;
+			}
+
+			if (auto v = std::get_if<Stored<T>>(&slots[p]); v != nullptr) {
+				if constexpr (IsOutOfLine<T>) {
+					return v->get();
+				} else {
+					return *v;
+				}
+			}
 			return std::nullopt;
 		}
+
+		ActorPropertyValue get(PropType p) const
+		{
+			return std::visit([](auto& v) -> ActorPropertyValue {
+				typedef Unstored<std::decay_t<decltype(v)>> U;
+				return ActorPropertyValue{ std::in_place_type<typename U::type>, U::Get(v) };
+			}, slots[p]);
+		}
+
+		void set(PropType p, ActorPropertyValue v)
+		{
+			slots[p] = std::visit([](auto&& v) -> StoredValue {
+				return StoredValue{ std::in_place_type<Stored<std::decay_t<decltype(v)>>>, std::move(v) };
+			}, std::move(v));
+			present |= Bit(p);
+		}
+
+		void erase(PropType p)
+		{
+			slots[p] = 0.0f;
+			present &= ~Bit(p);
+		}
+
+		void clear()
+		{
+			for (size_t i = 0; i < PropTypeCount; i++) {
+				erase(static_cast<PropType>(i));
+			}
+		}
+
+		template <class Archive>
+		void save(Archive& ar) const
+		{
+			ar(cereal::make_size_tag(static_cast<cereal::size_type>(size())));
+			for (size_t i = 0; i < PropTypeCount; i++) {
+				if (PropType key = static_cast<PropType>(i); contains(key)) {
+					ActorProperty prop{ get(key) };
+					ar(cereal::make_map_item(key, prop));
+				}
+			}
+		}
+
+		template <class Archive>
+		void load(Archive& ar)
+		{
+			clear();
+			cereal::size_type count;
+			ar(cereal::make_size_tag(count));
+			for (cereal::size_type i = 0; i < count; i++) {
+				PropType key;
+				ActorProperty prop;
+				ar(cereal::make_map_item(key, prop));
+				if (static_cast<size_t>(key) < PropTypeCount) {
+					set(key, std::move(prop.value));
+				}
+			}
+		}
+
+	private:
+		template <typename T>
+		static constexpr bool IsOutOfLine = std::is_same_v<T, std::string> || std::is_same_v<T, Data::ActionSet>;
+
+		template <typename T>
+		using Stored = std::conditional_t<IsOutOfLine<T>, OutOfLineProperty<T>, T>;
+
+		template <typename T>
+		struct Unstored
+		{
+			typedef T type;
+			static const T& Get(const T& v) { return v; }
+		};
+
+		template <typename T>
+		struct Unstored<OutOfLineProperty<T>>
+		{
+			typedef T type;
+			static const T& Get(const OutOfLineProperty<T>& v) { return v.get(); }
+		};
+
+		typedef std::variant<float, SerializableIdle, bool, Stored<std::string>, uint64_t, Stored<Data::ActionSet>, std::pair<RE::NiPoint3, float>> StoredValue;
+
+		static uint16_t Bit(PropType p)
+		{
+			return static_cast<uint16_t>(1u << p);
+		}
+
+		std::array<StoredValue, PropTypeCount> slots;
+		uint16_t present = 0;
+	};
+
+	//A scene's actors & their properties, kept in order of their kOrder property, which matches the order they were added in.
+	//Up to SCENE_INLINE_ACTORS actors are stored inline, more spill over to the heap all together, so iterating is always a
+	//walk over one contiguous array. Actors can only be removed all at once with clear(), so each actor keeps its index for as
+	//long as it's in the scene. Lookups by handle are linear.
+	//Keeps the parts of the unordered_map<SerializableActorHandle, ActorPropertyMap> interface that scenes used, & serializes
+	//the same way, which is also why save & load aren't versioned.
+	class SceneActorsMap
+	{
+	public:
+		typedef std::pair<SerializableActorHandle, ActorPropertyMap> value_type;
+		typedef value_type* iterator;
+		typedef const value_type* const_iterator;
+
+		size_t size() const
+		{
+			return count;
+		}
+
+		bool empty() const
+		{
+			return count == 0;
+		}
+
+		iterator begin() { return data(); }
+		iterator end() { return data() + count; }
+		const_iterator begin() const { return data(); }
+		const_iterator end() const { return data() + count; }
+
+		iterator find(const SerializableActorHandle& hndl)
+		{
+			return std::find_if(begin(), end(), [&](const value_type& e) { return e.first == hndl; });
+		}
+
+		const_iterator find(const SerializableActorHandle& hndl) const
+		{
+			return std::find_if(begin(), end(), [&](const value_type& e) { return e.first == hndl; });
+		}
+
+		bool contains(const SerializableActorHandle& hndl) const
+		{
+			return find(hndl) != end();
+		}
+
+		std::pair<iterator, bool> insert(value_type entry)
+		{
+			if (auto iter = find(entry.first); iter != end()) {
+				return { iter, false };
+			}
+			return { PushBack(std::move(entry)), true };
+		}
+
+		ActorPropertyMap& operator[](const SerializableActorHandle& hndl)
+		{
+			if (auto iter = find(hndl); iter != end()) {
+				return iter->second;
+			}
+			return PushBack({ hndl, ActorPropertyMap() })->second;
+		}
+
+		void clear()
+		{
+			for (size_t i = 0; i < count && spilled.empty(); i++) {
+				inlineEntries[i] = value_type();
+			}
+			spilled.clear();
+			count = 0;
+		}
+
+		template <class Archive>
+		void save(Archive& ar) const
+		{
+			ar(cereal::make_size_tag(static_cast<cereal::size_type>(count)));
+			for (auto& e : *this) {
+				ar(cereal::make_map_item(e.first, e.second));
+			}
+		}
+
+		//Saves from before this container may list actors in any order.
+		template <class Archive>
+		void load(Archive& ar)
+		{
+			clear();
+			cereal::size_type size;
+			ar(cereal::make_size_tag(size));
+			for (cereal::size_type i = 0; i < size; i++) {
+				value_type e;
+				ar(cereal::make_map_item(e.first, e.second));
+				insert(std::move(e));
+			}
+			std::stable_sort(begin(), end(), [](const value_type& a, const value_type& b) {
+				return a.second.get<uint64_t>(kOrder).value_or(UINT64_MAX) < b.second.get<uint64_t>(kOrder).value_or(UINT64_MAX);
+			});
+		}
+
+	private:
+		value_type* data()
+		{
+			return spilled.empty() ? inlineEntries.data() : spilled.data();
+		}
+
+		const value_type* data() const
+		{
+			return spilled.empty() ? inlineEntries.data() : spilled.data();
+		}
+
+		iterator PushBack(value_type entry)
+		{
+			if (spilled.empty() && count < inlineEntries.size()) {
+				inlineEntries[count] = std::move(entry);
+			} else {
+				if (spilled.empty()) {
+					spilled.reserve(count * 2);
+					for (size_t i = 0; i < count; i++) {
+						spilled.push_back(std::move(inlineEntries[i]));
+						inlineEntries[i] = value_type();
+					}
+				}
+				spilled.push_back(std::move(entry));
+			}
+			return data() + count++;
+		}
+
+		std::array<value_type, SCENE_INLINE_ACTORS> inlineEntries;
+		std::vector<value_type> spilled;
+		size_t count = 0;
+	};
+
+	template <typename T>
+	std::optional<T> GetProperty(const ActorPropertyMap& m, PropType p) {
+		return m.get<T>(p);
 	}
 
 	std::vector<RE::NiPointer<RE::Actor>> GetActorsInOrder(const SceneActorsMap& actors)
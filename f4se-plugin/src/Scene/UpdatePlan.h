@@ -0,0 +1,121 @@
+#pragma once
+#include "Misc/MathUtil.h"
+
+namespace Scene
+{
+	struct LocalSyncInfo
+	{
+		RE::NiPointer<RE::Actor> actor;
+		float currentAnimTime = 0.0f;
+		float totalAnimTime = 0.0f;
+		float oldMult = 0.0f;
+		float newMult = 0.0f;
+	};
+
+	struct ActorPlacement
+	{
+		RE::NiPointer<RE::Actor> actor;
+		//Index of the actor in the scene's actors, which it keeps for as long as it's in the scene.
+		size_t index = 0;
+		RE::NiPoint3A currentLocation;
+		RE::NiPoint3A currentAngle;
+		std::optional<std::pair<RE::NiPoint3, float>> offset;
+		RE::NiPoint3 targetLocation;
+		RE::NiPoint3 targetAngle;
+		bool moveAngle = false;
+		bool moveLocation = false;
+	};
+
+	//Handed from one scene update phase to the next, everything the compute phase needs is copied in by GatherUpdate.
+	//The compute functions only touch the plan & the sync infos passed in, so plans of different scenes can be computed on any thread. Not serialized.
+	struct UpdatePlan
+	{
+		RE::NiPoint3 location;
+		RE::NiPoint3 angle;
+		float animMult = 100.0f;
+		float diffLimit = 100.0f * 0.05f;
+		float basicallyFullSpeed = 100.0f * 0.9999f;
+		bool smoothSync = false;
+		float minTime = 0.0f;
+		float baseTotalTime = 0.0f;
+		size_t syncCount = 0;
+		bool allFullSpeed = false;
+		std::vector<ActorPlacement> placements;
+
+		static bool SameCoords(const RE::NiPoint3& a, const RE::NiPoint3& b)
+		{
+			return a.x == b.x && a.y == b.y && a.z == b.z;
+		}
+
+		//Works out each synced actor's new anim speed from the times GatherSmoothSync read.
+		void ComputeSmoothSync(std::vector<LocalSyncInfo>& syncInfoVec)
+		{
+			allFullSpeed = true;
+			syncCount = 0;
+			for (auto& info : syncInfoVec) {
+				//Avoid synchronizing animations that have different total times.
+				if (info.totalAnimTime != baseTotalTime) {
+					allFullSpeed = true;
+					break;
+				}
+
+				//Adjust each actor's animation speed to nudge their current time towards the minTime.
+				//Over time this results in an ease-out function, where anim speed is changed by a large amount
+				//at first then gradually tapers off until all current times align with the min time.
+				//To keep the function from suddenly going out of sync when one actor's current time loops
+				//back to 0 before others, the anim speed change is clamped to +/- 5% of the scene's base anim speed.
+				info.newMult = std::clamp(animMult * (minTime / info.currentAnimTime), info.oldMult - diffLimit, info.oldMult + diffLimit);
+				syncCount++;
+
+				//basicallyFullSpeed = scene's base anim speed * 0.9999
+				if (info.newMult < basicallyFullSpeed) {
+					allFullSpeed = false;
+				}
+			}
+		}
+
+		void ComputePlacement(ActorPlacement& p) const
+		{
+			p.targetLocation = location;
+			p.targetAngle = angle;
+			if (p.offset.has_value()) {
+				MathUtil::ApplyOffsetToLocalSpace(p.targetLocation, p.offset->first, p.targetAngle.z);
+				p.targetAngle.z += p.offset->second;
+				MathUtil::ConstrainRadian(p.targetAngle.z);
+			}
+			p.moveAngle = !MathUtil::CoordsWithinError(p.currentAngle, p.targetAngle);
+			p.moveLocation = !MathUtil::CoordsWithinError(p.currentLocation, p.targetLocation);
+		}
+
+		void ComputePlacements()
+		{
+			for (auto& p : placements) {
+				ComputePlacement(p);
+			}
+		}
+
+		//Sets the scene position the placements are relative to, returns true if it changed.
+		bool MoveScene(const RE::NiPoint3& a_location, const RE::NiPoint3& a_angle)
+		{
+			const bool moved = !SameCoords(location, a_location) || !SameCoords(angle, a_angle);
+			location = a_location;
+			angle = a_angle;
+			return moved;
+		}
+
+		//Redoes a computed placement if the scene or the actor moved, or the actor's offset changed, since it was gathered.
+		void Recheck(ActorPlacement& p, bool sceneMoved, const RE::NiPoint3A& currentLocation, const RE::NiPoint3A& currentAngle,
+			const std::optional<std::pair<RE::NiPoint3, float>>& offset) const
+		{
+			const bool offsetChanged = offset.has_value() != p.offset.has_value() ||
+			                           (offset.has_value() && (!SameCoords(offset->first, p.offset->first) || offset->second != p.offset->second));
+			const bool actorMoved = !SameCoords(p.currentLocation, currentLocation) || !SameCoords(p.currentAngle, currentAngle);
+			if (sceneMoved || offsetChanged || actorMoved) {
+				p.currentLocation = currentLocation;
+				p.currentAngle = currentAngle;
+				p.offset = offset;
+				ComputePlacement(p);
+			}
+		}
+	};
+}
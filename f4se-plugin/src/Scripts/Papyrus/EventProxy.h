@@ -11,21 +11,21 @@ namespace Papyrus
 		using Events = Data::Events;
 
 		void OnSceneStart(Events::event_type, Events::EventData& data) {
-			if (auto u64 = std::any_cast<uint64_t>(&data); u64) {
+			if (auto u64 = std::get_if<uint64_t>(&data); u64) {
 				GameUtil::SendPapyrusEvent(PEVENT_SCENE_START, PackSceneId(*u64));
 			}
 		}
 
 		void OnSceneEnd(Events::event_type, Events::EventData& data)
 		{
-			if (auto u64 = std::any_cast<uint64_t>(&data); u64) {
+			if (auto u64 = std::get_if<uint64_t>(&data); u64) {
 				GameUtil::SendPapyrusEvent(PEVENT_SCENE_END, PackSceneId(*u64));
 			}
 		}
 
 		void OnScenePosChange(Events::event_type, Events::EventData& data)
 		{
-			if (auto sData = std::any_cast<Events::ScenePositionData>(&data); sData && sData->successful) {
+			if (auto sData = std::get_if<Events::ScenePositionData>(&data); sData && sData->successful) {
 				GameUtil::SendPapyrusEvent(PEVENT_SCENE_POS_CHANGE, PackSceneId(sData->id), sData->newPosition);
 			}
 		}
@@ -278,7 +278,7 @@ namespace Serialization
 namespace std
 {
 	template <>
-	struct std::hash<Serialization::General::SerializableHandle<RE::Actor>>
+	struct hash<Serialization::General::SerializableHandle<RE::Actor>>
 	{
 		std::size_t operator()(const Serialization::General::SerializableHandle<RE::Actor>& hndl) const
 		{
@@ -287,7 +287,7 @@ namespace std
 	};
 
 	template <>
-	struct std::hash<Serialization::General::SerializableHandle<RE::TESObjectREFR>>
+	struct hash<Serialization::General::SerializableHandle<RE::TESObjectREFR>>
 	{
 		std::size_t operator()(const Serialization::General::SerializableHandle<RE::TESObjectREFR>& hndl) const
 		{
@@ -52,16 +52,14 @@ namespace Serialization
 		}
 
 		Utility::StartPerformanceCounter();
+		Data::UsageStats::Flush();
 
 		auto tThread = Tasks::TimerThread::GetSingleton();
-		tThread->Stop();
 
 		{
 			std::scoped_lock l{
 				Scene::SceneManager::scenesMapLock,
 				Scene::SceneManager::actorsWalkingLock,
-				tThread->timerLock,
-				FaceAnimation::FaceUpdateHook::loadingAnimsLock,
 				FaceAnimation::FaceUpdateHook::stateLock,
 				Data::Uid::lock,
 				PackageOverride::lock,
@@ -71,9 +69,16 @@ namespace Serialization
 				Menu::SceneHUD::lock
 			};
 
+			//Timers keep running while saving, they're only blocked while their pending tasks are copied.
+			auto snapshotTimer = Utility::CreatePerfCounter();
+			auto timedTasks = tThread->Snapshot();
+			auto frameTasks = Tasks::FrameTimer::Snapshot();
+			logger::info("Snapshotted {} timed tasks in {:.3f}ms", timedTasks->timedTasks.size() + frameTasks->timedTasks.size(), Utility::QueryPerfCounterTime(snapshotTimer));
+
 			Serialization::General::s_intfc = a_intfc;
 
-			SAVE_PERSISTENT_STATE('TASK', 5, "task", tThread->state);
+			SAVE_PERSISTENT_STATE('TASK', 5, "task", timedTasks);
+			SAVE_PERSISTENT_STATE('FTSK', 5, "frame task", frameTasks);
 			SAVE_PERSISTENT_STATE('SCNE', 5, "scene", Scene::SceneManager::state);
 			SAVE_PERSISTENT_STATE('EQPT', 5, "equipment", Scene::OrderedActionQueue::state);
 			SAVE_PERSISTENT_STATE('UID', 5, "UID", Data::Uid::state);
@@ -86,8 +91,6 @@ namespace Serialization
 		}
 
 		logger::info("Finished serialization in {:.3f}ms", Utility::GetPerformanceCounterMS());
-
-		tThread->Start();
 	}
 
 	void LoadCallback(const F4SE::SerializationInterface* a_intfc)
@@ -100,13 +103,16 @@ namespace Serialization
 
 		auto tThread = Tasks::TimerThread::GetSingleton();
 		tThread->Stop();
+		Tasks::FrameTimer::Stop();
+		//Runs dispatched before loading would otherwise act on the loaded state.
+		Tasks::TaskExecutor::GetSingleton()->CancelAll();
 
 		{
 			std::scoped_lock l{
 				Scene::SceneManager::scenesMapLock,
 				Scene::SceneManager::actorsWalkingLock,
 				tThread->timerLock,
-				FaceAnimation::FaceUpdateHook::loadingAnimsLock,
+				Tasks::FrameTimer::lock,
 				FaceAnimation::FaceUpdateHook::stateLock,
 				Data::Uid::lock,
 				PackageOverride::lock,
@@ -126,6 +132,7 @@ namespace Serialization
 				if (version >= 5) {
 					switch (type) {
 						LOAD_PERSISTENT_STATE_CL('TASK', "task", Tasks::TimerThread, tThread->state);
+						LOAD_PERSISTENT_STATE('FTSK', "frame task", Tasks::FrameTimer);
 						LOAD_PERSISTENT_STATE('SCNE', "scene", Scene::SceneManager);
 						LOAD_PERSISTENT_STATE('EQPT', "equipment", Scene::OrderedActionQueue);
 						LOAD_PERSISTENT_STATE('UID', "UID", Data::Uid);
@@ -137,20 +144,24 @@ namespace Serialization
 				}
 			}
 
+			Scene::SceneManager::RebuildRegistry_NonThreadSafe();
 			Serialization::General::s_intfc = nullptr;
 		}
 
 		logger::info("Finished deserialization in {:.3f}ms", Utility::GetPerformanceCounterMS());
 
 		tThread->Start();
+		Tasks::FrameTimer::Start();
 	}
 
 	void RevertCallback(const F4SE::SerializationInterface*)
 	{
 		Tasks::TimerThread::GetSingleton()->Reset();
+		Tasks::FrameTimer::Reset();
 		PackageOverride::Reset();
 		FaceAnimation::FaceUpdateHook::Reset();
 		Scene::SceneManager::Reset();
+		Misc::SyncInfoCache::Clear();
 		Scene::OrderedActionQueue::Reset();
 		Data::Uid::Reset();
 		Menu::HUDManager::Reset();
@@ -0,0 +1,214 @@
+#pragma once
+#include "TimedTask.h"
+
+namespace Tasks
+{
+	// Timer domain driven by the game loop. Tasks expire and run directly on the main thread through
+	// TaskFunctor::RunOnMainThread(), at the start of SceneManager::UpdateScenes, instead of expiring on the timer thread
+	// and hopping back to the main thread through F4SE's task interface.
+	// Time only advances while TimerThread isn't paused (menu mode), which forwards its paused state here.
+	// Tasks run with the lock released, so they're free to start or stop other tasks.
+	class FrameTimer
+	{
+	public:
+		struct PersistentState
+		{
+			std::unordered_map<uint64_t, std::shared_ptr<TimedTask>> timedTasks;
+
+			template <class Archive>
+			void serialize(Archive& ar, const uint32_t)
+			{
+				ar(timedTasks);
+			}
+		};
+
+		struct Metrics
+		{
+			uint64_t frames = 0;
+			uint64_t runs = 0;
+			double maxLateMs = 0.0;
+		};
+
+		inline static safe_mutex lock;
+		inline static std::unique_ptr<PersistentState> state = std::make_unique<PersistentState>();
+
+		static void AddTimedTask(std::shared_ptr<TimedTask> task)
+		{
+			std::unique_lock l{ lock };
+			state->timedTasks.insert(std::pair(task->uid, task));
+			if (schedule.QActive()) {
+				schedule.Schedule(task.get(), clock);
+			}
+		}
+
+		static bool RemoveTimedTask(uint64_t taskId)
+		{
+			std::unique_lock l{ lock };
+			return state->timedTasks.erase(taskId) > 0;
+		}
+
+		static bool RemoveTimedTasks(const std::vector<uint64_t>& taskIds)
+		{
+			std::unique_lock l{ lock };
+			bool removedAll = true;
+			for (auto& id : taskIds) {
+				if (state->timedTasks.erase(id) < 1) {
+					removedAll = false;
+				}
+			}
+			return removedAll;
+		}
+
+		static void VisitTask(uint64_t taskId, std::function<void(TimedTask*)> func)
+		{
+			std::unique_lock l{ lock };
+			auto iter = state->timedTasks.find(taskId);
+			if (iter != state->timedTasks.end()) {
+				auto tsk = iter->second.get();
+				if (schedule.QActive()) {
+					DeadlineSchedule::SyncDuration(tsk, clock);
+					func(tsk);
+					schedule.Schedule(tsk, clock);
+				} else {
+					func(tsk);
+				}
+			}
+		}
+
+		static void SetPaused(bool _paused)
+		{
+			std::unique_lock l{ lock };
+			if (paused && !_paused) {
+				lastTick = std::chrono::steady_clock::now();
+			}
+			paused = _paused;
+		}
+
+		// Called once per game loop tick, advances the clock by the time since the last tick.
+		// A single tick advances it by FRAME_TIMER_MAX_DELTA at most, so that a stall doesn't expire every task at once.
+		static void Tick()
+		{
+			double timeDelta;
+			{
+				std::unique_lock l{ lock };
+				const auto now = std::chrono::steady_clock::now();
+				timeDelta = std::chrono::duration<double>(now - lastTick).count();
+				lastTick = now;
+			}
+			Update(std::min(timeDelta, FRAME_TIMER_MAX_DELTA));
+		}
+
+		// Advances the clock by timeDelta unless paused or stopped, then runs every task that expired, in deadline order.
+		static void Update(double timeDelta)
+		{
+			std::unique_lock l{ lock };
+			if (stopped || paused) {
+				return;
+			}
+			if (!schedule.QActive()) {
+				schedule.Activate(state->timedTasks, clock);
+			}
+
+			clock += std::max(timeDelta, 0.0);
+			frames++;
+
+			// Collect first, so that repeating tasks with a 0 interval only run once per frame.
+			expiredTasks.clear();
+			while (auto tsk = schedule.PopDue(state->timedTasks, clock)) {
+				expiredTasks.push_back({ tsk, tsk->generation, tsk->deadline });
+			}
+
+			for (auto& e : expiredTasks) {
+				// An earlier task may have removed or rescheduled this one.
+				auto iter = state->timedTasks.find(e.task->uid);
+				if (iter == state->timedTasks.end() || iter->second->generation != e.generation) {
+					continue;
+				}
+
+				const bool finalize = schedule.Expire(state->timedTasks, e.task.get(), clock);
+				runs++;
+				maxLateMs = std::max(maxLateMs, (clock - e.deadline) * 1000.0);
+				auto functor = e.task->task;
+				l.unlock();
+
+				functor->RunOnMainThread();
+				if (finalize) {
+					functor->Finalize();
+				}
+
+				l.lock();
+			}
+			expiredTasks.clear();
+
+			schedule.Compact(state->timedTasks);
+		}
+
+		// Point-in-time copy of all pending tasks for saving.
+		static std::unique_ptr<PersistentState> Snapshot()
+		{
+			std::unique_lock l{ lock };
+			auto result = std::make_unique<PersistentState>();
+			result->timedTasks = schedule.Snapshot(state->timedTasks, clock);
+			return result;
+		}
+
+		// Writes remaining durations back to the tasks and stops the clock until Start(), for loading.
+		// Neither the time spent stopped nor paused counts towards the next Tick().
+		static void Stop()
+		{
+			std::unique_lock l{ lock };
+			schedule.Deactivate(state->timedTasks, clock);
+			stopped = true;
+		}
+
+		static void Start()
+		{
+			std::unique_lock l{ lock };
+			stopped = false;
+			lastTick = std::chrono::steady_clock::now();
+			schedule.Activate(state->timedTasks, clock);
+		}
+
+		static Metrics QMetrics()
+		{
+			std::unique_lock l{ lock };
+			Metrics result;
+			result.frames = frames;
+			result.runs = runs;
+			result.maxLateMs = maxLateMs;
+			return result;
+		}
+
+		static void Reset()
+		{
+			std::unique_lock l{ lock };
+			if (runs > 0) {
+				logger::info("Frame timer: {} task runs over {} frames, {:.2f}ms max lateness", runs, frames, maxLateMs);
+			}
+			state = std::make_unique<PersistentState>();
+			schedule = DeadlineSchedule();
+			clock = 0;
+			frames = 0;
+			runs = 0;
+			maxLateMs = 0.0;
+		}
+
+	private:
+		struct Expired
+		{
+			std::shared_ptr<TimedTask> task;
+			uint64_t generation;
+			double deadline;
+		};
+
+		inline static DeadlineSchedule schedule;
+		inline static double clock = 0;
+		inline static bool stopped = false;
+		inline static std::atomic<bool> paused = false;
+		inline static std::chrono::steady_clock::time_point lastTick = std::chrono::steady_clock::now();
+		inline static std::vector<Expired> expiredTasks;
+		inline static uint64_t frames = 0;
+		inline static uint64_t runs = 0;
+		inline static double maxLateMs = 0.0;
+	};
+}
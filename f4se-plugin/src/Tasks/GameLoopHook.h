@@ -9,6 +9,8 @@ namespace Tasks
 		static REL::Relocation<ProcessQueues> OriginalProcessQueues;
 
 		bool HookedGameLoop(void* qintfc, float unk01, uint32_t unk02) {
+			Misc::SyncInfoCache::NextFrame();
+			FaceAnimation::FaceUpdateHook::PreEvaluate();
 			bool res = OriginalProcessQueues(qintfc, unk01, unk02);
 			Scene::SceneManager::UpdateScenes();
 			Scene::OrderedActionQueue::Update();
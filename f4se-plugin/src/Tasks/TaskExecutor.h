@@ -0,0 +1,266 @@
+#pragma once
+#include <deque>
+#include "TaskFunctor.h"
+
+namespace Tasks
+{
+	//Small pool of worker threads that runs the bodies of expired timed tasks, so that a slow functor doesn't hold up
+	//the timer thread and every other timer with it.
+	//Jobs are queued in lanes by ordering key: the functor's QOrderingKey() (the scene UID for scene functors), or the
+	//task's own UID otherwise. A lane runs one job at a time in dispatch order, so a scene's tasks never run out of
+	//order or concurrently with each other, and a repeating task never overlaps itself.
+	//Cancel() drops a task's jobs that haven't started yet, and waits for one that already started to finish, unless it's
+	//called from that job's own body. Bodies therefore mustn't cancel each other's tasks from two workers at once.
+	class TaskExecutor
+	{
+	public:
+		//Upper bounds (ms) of the jitter histogram buckets, everything above the last one goes into an extra bucket.
+		//Jitter is the time between a task's deadline and its body starting, and can be negative by up to
+		//TIMER_COALESCE_WINDOW for tasks that were coalesced into an earlier wakeup.
+		static constexpr std::array<double, 9> JitterBucketsMs{ 0.0, 0.5, 1.0, 2.0, 5.0, 10.0, 20.0, 50.0, 100.0 };
+
+		struct Metrics
+		{
+			uint64_t dispatched = 0;
+			uint64_t runs = 0;
+			uint64_t cancelled = 0;
+			double totalJitterMs = 0.0;
+			double maxJitterMs = 0.0;
+			std::array<uint64_t, JitterBucketsMs.size() + 1> jitterHistogram{};
+
+			double QAverageJitterMs() const
+			{
+				return runs > 0 ? totalJitterMs / static_cast<double>(runs) : 0.0;
+			}
+		};
+
+		static TaskExecutor* GetSingleton()
+		{
+			static TaskExecutor singleton;
+			return &singleton;
+		}
+
+		~TaskExecutor()
+		{
+			Stop();
+		}
+
+		//Queues a run of a task's body, and its Finalize() right after if finalize is set.
+		//lateSeconds is how far past its deadline the task was when it was picked up by the timer thread.
+		void Dispatch(uint64_t taskUid, std::shared_ptr<TaskFunctor> task, bool finalize, double lateSeconds)
+		{
+			std::unique_lock l{ lock };
+			const uint64_t key = task->QOrderingKey().value_or(taskUid);
+			auto& lane = lanes[key];
+			lane.jobs.push_back({ taskUid, std::move(task), finalize, lateSeconds, std::chrono::steady_clock::now() });
+			auto& pending = pendingByTask[taskUid];
+			pending.key = key;
+			pending.count++;
+			metrics.dispatched++;
+
+			if (!lane.active) {
+				lane.active = true;
+				readyLanes.push_back(key);
+				StartWorkers_NonThreadSafe();
+				jobQueued.notify_one();
+			}
+		}
+
+		void Cancel(uint64_t taskUid)
+		{
+			std::unique_lock l{ lock };
+			Cancel_NonThreadSafe(taskUid);
+			jobFinished.wait(l, [&] { return !QRunningElsewhere_NonThreadSafe(taskUid); });
+		}
+
+		void Cancel(const std::vector<uint64_t>& taskUids)
+		{
+			std::unique_lock l{ lock };
+			for (auto& uid : taskUids) {
+				Cancel_NonThreadSafe(uid);
+			}
+			jobFinished.wait(l, [&] {
+				return std::none_of(taskUids.begin(), taskUids.end(), [&](uint64_t uid) { return QRunningElsewhere_NonThreadSafe(uid); });
+			});
+		}
+
+		//Drops every job that hasn't started yet and waits for the running ones to finish.
+		void CancelAll()
+		{
+			std::unique_lock l{ lock };
+			CancelAll_NonThreadSafe(l);
+		}
+
+		//Cancels every job like CancelAll() and logs the metrics so far.
+		void Clear()
+		{
+			std::unique_lock l{ lock };
+			CancelAll_NonThreadSafe(l);
+
+			if (metrics.dispatched > 0) {
+				logger::info("Timer task executor: {} runs, {} cancelled, {:.2f}ms avg jitter, {:.2f}ms max jitter",
+					metrics.runs, metrics.cancelled, metrics.QAverageJitterMs(), metrics.maxJitterMs);
+			}
+			metrics = Metrics();
+		}
+
+		void Stop()
+		{
+			std::unique_lock l{ lock };
+			stopping = true;
+			jobQueued.notify_all();
+			l.unlock();
+
+			for (auto& w : workers) {
+				if (w.joinable()) {
+					w.join();
+				}
+			}
+
+			l.lock();
+			workers.clear();
+			stopping = false;
+		}
+
+		Metrics QMetrics()
+		{
+			std::unique_lock l{ lock };
+			return metrics;
+		}
+
+	private:
+		struct Job
+		{
+			uint64_t taskUid;
+			std::shared_ptr<TaskFunctor> task;
+			bool finalize;
+			double lateSeconds;
+			std::chrono::steady_clock::time_point dispatchedAt;
+		};
+
+		struct Pending
+		{
+			uint64_t key = 0;
+			uint32_t count = 0;
+		};
+
+		struct Lane
+		{
+			std::deque<Job> jobs;
+			//Set while the lane is either waiting in readyLanes or has a job running.
+			bool active = false;
+		};
+
+		void Cancel_NonThreadSafe(uint64_t taskUid)
+		{
+			auto iter = pendingByTask.find(taskUid);
+			if (iter == pendingByTask.end()) {
+				return;
+			}
+			auto& lane = lanes[iter->second.key];
+			metrics.cancelled += std::erase_if(lane.jobs, [&](const Job& j) { return j.taskUid == taskUid; });
+			pendingByTask.erase(iter);
+		}
+
+		void CancelAll_NonThreadSafe(std::unique_lock<std::mutex>& l)
+		{
+			for (auto& lane : lanes) {
+				metrics.cancelled += lane.second.jobs.size();
+				lane.second.jobs.clear();
+			}
+			pendingByTask.clear();
+			jobFinished.wait(l, [&] {
+				return std::none_of(running.begin(), running.end(), [](auto& r) { return r.second != std::this_thread::get_id(); });
+			});
+		}
+
+		bool QRunningElsewhere_NonThreadSafe(uint64_t taskUid) const
+		{
+			auto iter = running.find(taskUid);
+			return iter != running.end() && iter->second != std::this_thread::get_id();
+		}
+
+		void RecordJitter_NonThreadSafe(const Job& job)
+		{
+			const double jitterMs = (job.lateSeconds + std::chrono::duration<double>(std::chrono::steady_clock::now() - job.dispatchedAt).count()) * 1000.0;
+			size_t bucket = 0;
+			while (bucket < JitterBucketsMs.size() && jitterMs > JitterBucketsMs[bucket]) {
+				bucket++;
+			}
+			metrics.jitterHistogram[bucket]++;
+			metrics.totalJitterMs += jitterMs;
+			metrics.maxJitterMs = std::max(metrics.maxJitterMs, jitterMs);
+		}
+
+		void StartWorkers_NonThreadSafe()
+		{
+			if (!workers.empty()) {
+				return;
+			}
+
+			for (size_t i = 0; i < TIMER_EXECUTOR_THREADS; i++) {
+				workers.emplace_back(&TaskExecutor::WorkerRoutine, this);
+			}
+		}
+
+		void WorkerRoutine()
+		{
+			std::unique_lock l{ lock };
+			while (true) {
+				jobQueued.wait(l, [&] { return stopping || !readyLanes.empty(); });
+				if (stopping) {
+					break;
+				}
+
+				const uint64_t key = readyLanes.front();
+				readyLanes.pop_front();
+				auto laneIter = lanes.find(key);
+				// The lane's jobs may have all been cancelled while it was waiting.
+				if (laneIter->second.jobs.empty()) {
+					lanes.erase(laneIter);
+					continue;
+				}
+
+				Job job = std::move(laneIter->second.jobs.front());
+				laneIter->second.jobs.pop_front();
+				if (auto iter = pendingByTask.find(job.taskUid); iter != pendingByTask.end() && --iter->second.count == 0) {
+					pendingByTask.erase(iter);
+				}
+				RecordJitter_NonThreadSafe(job);
+				metrics.runs++;
+				running[job.taskUid] = std::this_thread::get_id();
+				l.unlock();
+
+				job.task->Run();
+				if (job.finalize) {
+					job.task->Finalize();
+				}
+				job.task = nullptr;
+
+				l.lock();
+				running.erase(job.taskUid);
+				jobFinished.notify_all();
+				// Lanes are only erased by workers, and never while one of their jobs is running.
+				laneIter = lanes.find(key);
+				if (laneIter->second.jobs.empty()) {
+					lanes.erase(laneIter);
+				} else {
+					readyLanes.push_back(key);
+					jobQueued.notify_one();
+				}
+			}
+		}
+
+		std::mutex lock;
+		std::condition_variable jobQueued;
+		std::condition_variable jobFinished;
+		std::vector<std::thread> workers;
+		bool stopping = false;
+		std::unordered_map<uint64_t, Lane> lanes;
+		std::deque<uint64_t> readyLanes;
+		std::unordered_map<uint64_t, Pending> pendingByTask;
+		//Tasks with a job running, & the worker running it. A lane runs one job at a time, so a task only ever has one.
+		std::unordered_map<uint64_t, std::thread::id> running;
+		Metrics metrics;
+	};
+}
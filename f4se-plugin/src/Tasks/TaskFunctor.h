@@ -8,6 +8,10 @@ namespace Tasks
 		TaskFunctor(){}
 		virtual void Run() { logger::warn("Default TaskFunctor called."); }
 		virtual void Finalize(){}
+		//Called instead of Run() by FrameTimer, which already runs on the main thread.
+		virtual void RunOnMainThread() { Run(); }
+		//Functors with the same key are run one at a time, in the order their timers expired.
+		virtual std::optional<uint64_t> QOrderingKey() const { return std::nullopt; }
 		template <class Archive>
 		void serialize(Archive&) const{}
 	};
@@ -0,0 +1,233 @@
+#pragma once
+#include "TaskFunctor.h"
+#include "Data/Uid.h"
+
+namespace Tasks
+{
+	class TimedTask
+	{
+	public:
+		std::shared_ptr<TaskFunctor> task;
+		double duration = 0;
+		double initDuration = 0;
+		int64_t repeats = 0;
+		int64_t maxRepeats = 0;
+		uint64_t uid = 0;
+		bool initialized = false;
+		double timeScale = 1.0;
+
+		//Absolute expiry on the owning timer's clock while its schedule is active, not serialized.
+		//generation invalidates older schedule entries whenever the task is rescheduled.
+		double deadline = 0;
+		uint64_t generation = 0;
+
+		static std::shared_ptr<TimedTask> MakeTask(std::shared_ptr<TaskFunctor> _task, double _duration, int64_t _repeats) {
+			_duration = _duration / 1000;
+			auto tsk = std::make_shared<TimedTask>(_task, _duration, _repeats);
+			tsk->GetUid();
+			return tsk;
+		}
+
+		static std::shared_ptr<TimedTask> MakeTask(std::shared_ptr<TaskFunctor> _task, double _duration)
+		{
+			return MakeTask(_task, _duration, 0);
+		}
+
+		TimedTask(std::shared_ptr<TaskFunctor> _task, double _duration) :
+			task(_task), duration(_duration), initDuration(_duration)
+		{
+		}
+
+		TimedTask(std::shared_ptr<TaskFunctor> _task, double _duration, uint64_t _repeats) :
+			task(_task), duration(_duration), initDuration(_duration), maxRepeats(_repeats)
+		{
+		}
+
+		TimedTask()
+		{
+		}
+
+		template <class Archive>
+		void serialize(Archive& ar, const uint32_t)
+		{
+			ar(task, duration, initDuration, repeats, maxRepeats, uid, initialized, timeScale);
+		}
+
+		bool operator==(TimedTask tsk)
+		{
+			return uid == tsk.uid;
+		}
+
+		inline static std::atomic<uint64_t> nextUid = 1;
+	private:
+		void GetUid() {
+			uid = Data::Uid::Get();
+		}
+	};
+
+	// Min-heap of timed task deadlines on a timer's clock, shared by TimerThread and FrameTimer. Not thread safe, the owner locks.
+	// Removing a task from the owner's map or rescheduling it leaves its old entries behind, they're skipped once they
+	// come up and compacted away once they outnumber live ones.
+	// Only valid while active. While inactive (e.g. during saving & loading), each task's remaining duration is authoritative instead.
+	class DeadlineSchedule
+	{
+	public:
+		typedef std::unordered_map<uint64_t, std::shared_ptr<TimedTask>> TaskMap;
+
+		bool QActive() const {
+			return active;
+		}
+
+		uint64_t QStaleEntries() const {
+			return staleEntries;
+		}
+
+		// Schedules every task from its remaining duration.
+		void Activate(TaskMap& tasks, double now) {
+			entries.clear();
+			for (auto& t : tasks) {
+				Schedule(t.second.get(), now);
+			}
+			active = true;
+		}
+
+		// Copies every task with its remaining duration as of now, for saving without deactivating the schedule.
+		// Functors are shared with the live tasks, they aren't expected to change once started.
+		TaskMap Snapshot(const TaskMap& tasks, double now) const {
+			TaskMap result;
+			result.reserve(tasks.size());
+			for (auto& t : tasks) {
+				auto copy = std::make_shared<TimedTask>(*t.second);
+				if (active) {
+					SyncDuration(copy.get(), now);
+				}
+				result.emplace(t.first, std::move(copy));
+			}
+			return result;
+		}
+
+		// Writes remaining durations back to the tasks, so they can be saved & rescheduled on the next activation.
+		void Deactivate(TaskMap& tasks, double now) {
+			if (active) {
+				for (auto& t : tasks) {
+					SyncDuration(t.second.get(), now);
+				}
+			}
+			entries.clear();
+			active = false;
+		}
+
+		// Tasks with a time scale of 0 or less never expire, and stay unscheduled until their time scale changes.
+		void Schedule(TimedTask* tsk, double now) {
+			tsk->initialized = true;
+			tsk->generation++;
+			if (tsk->timeScale <= 0) {
+				return;
+			}
+			tsk->deadline = now + std::max(tsk->duration, 0.0) / tsk->timeScale;
+			Push(tsk);
+		}
+
+		static void SyncDuration(TimedTask* tsk, double now) {
+			if (tsk->timeScale > 0) {
+				tsk->duration = std::max(tsk->deadline - now, 0.0) * tsk->timeScale;
+			}
+		}
+
+		// Drops stale entries off the top, returns the soonest live deadline.
+		std::optional<double> QNextDeadline(TaskMap& tasks) {
+			DropStale(tasks);
+			if (entries.empty()) {
+				return std::nullopt;
+			}
+			return entries.front().deadline;
+		}
+
+		// Pops the soonest live task if it's due by the given time, leaving the task itself untouched.
+		std::shared_ptr<TimedTask> PopDue(TaskMap& tasks, double until) {
+			DropStale(tasks);
+			if (entries.empty() || entries.front().deadline > until) {
+				return nullptr;
+			}
+			auto tsk = FindLive(tasks, entries.front());
+			Pop();
+			return tsk;
+		}
+
+		// Called once per run of an expired task. If the task is set to repeat, schedules it one interval after its last
+		// deadline, or one interval from now if it has fallen more than an interval behind instead of running it repeatedly
+		// to catch up. Otherwise removes the task. Returns true if the task's Finalize() should run after this run.
+		// If maxRepeats is -1 or less (repeat until task is removed by other code), don't increase the repeats field.
+		bool Expire(TaskMap& tasks, TimedTask* tsk, double now) {
+			if (tsk->maxRepeats > tsk->repeats || tsk->maxRepeats < 0) {
+				tsk->duration = tsk->initDuration;
+				tsk->repeats = tsk->maxRepeats < 0 ? -1 : tsk->repeats + 1;
+
+				const double interval = tsk->initDuration / tsk->timeScale;
+				double deadline = tsk->deadline + interval;
+				if (deadline < now) {
+					deadline = now + interval;
+				}
+				tsk->deadline = deadline;
+				tsk->generation++;
+				Push(tsk);
+				return false;
+			}
+
+			const bool finalize = tsk->repeats > 0;
+			tasks.erase(tsk->uid);
+			return finalize;
+		}
+
+		// Drops stale entries once they outnumber live ones, so that cancelled tasks don't pile up in the heap.
+		void Compact(TaskMap& tasks) {
+			if (entries.size() < 64 || entries.size() < tasks.size() * 2) {
+				return;
+			}
+			staleEntries += std::erase_if(entries, [&](const Entry& e) { return FindLive(tasks, e) == nullptr; });
+			std::make_heap(entries.begin(), entries.end(), std::greater<>{});
+		}
+
+	private:
+		struct Entry
+		{
+			double deadline;
+			uint64_t uid;
+			uint64_t generation;
+
+			bool operator>(const Entry& other) const
+			{
+				return deadline > other.deadline;
+			}
+		};
+
+		static std::shared_ptr<TimedTask> FindLive(TaskMap& tasks, const Entry& e) {
+			auto iter = tasks.find(e.uid);
+			if (iter == tasks.end() || iter->second->generation != e.generation) {
+				return nullptr;
+			}
+			return iter->second;
+		}
+
+		void Push(TimedTask* tsk) {
+			entries.push_back({ tsk->deadline, tsk->uid, tsk->generation });
+			std::push_heap(entries.begin(), entries.end(), std::greater<>{});
+		}
+
+		void Pop() {
+			std::pop_heap(entries.begin(), entries.end(), std::greater<>{});
+			entries.pop_back();
+		}
+
+		void DropStale(TaskMap& tasks) {
+			while (!entries.empty() && FindLive(tasks, entries.front()) == nullptr) {
+				Pop();
+				staleEntries++;
+			}
+		}
+
+		std::vector<Entry> entries;
+		bool active = false;
+		uint64_t staleEntries = 0;
+	};
+}
@@ -1,65 +1,10 @@
-#include "TaskFunctor.h"
-#include "Data/Uid.h"
+#include "TimedTask.h"
+#include "TaskExecutor.h"
+#include "FrameTimer.h"
 #pragma once
 
 namespace Tasks
 {
-	class TimedTask
-	{
-	public:
-		std::shared_ptr<TaskFunctor> task;
-		double duration = 0;
-		double initDuration = 0;
-		int64_t repeats = 0;
-		int64_t maxRepeats = 0;
-		uint64_t uid = 0;
-		bool initialized = false;
-		double timeScale = 1.0;
-
-		static std::shared_ptr<TimedTask> MakeTask(std::shared_ptr<TaskFunctor> _task, double _duration, int64_t _repeats) {
-			_duration = _duration / 1000;
-			auto tsk = std::make_shared<TimedTask>(_task, _duration, _repeats);
-			tsk->GetUid();
-			return tsk;
-		}
-
-		static std::shared_ptr<TimedTask> MakeTask(std::shared_ptr<TaskFunctor> _task, double _duration)
-		{
-			return MakeTask(_task, _duration, 0);
-		}
-
-		TimedTask(std::shared_ptr<TaskFunctor> _task, double _duration) :
-			task(_task), duration(_duration), initDuration(_duration)
-		{
-		}
-
-		TimedTask(std::shared_ptr<TaskFunctor> _task, double _duration, uint64_t _repeats) :
-			task(_task), duration(_duration), initDuration(_duration), maxRepeats(_repeats)
-		{
-		}
-
-		TimedTask()
-		{
-		}
-
-		template <class Archive>
-		void serialize(Archive& ar, const uint32_t)
-		{
-			ar(task, duration, initDuration, repeats, maxRepeats, uid, initialized, timeScale);
-		}
-
-		bool operator==(TimedTask tsk)
-		{
-			return uid == tsk.uid;
-		}
-
-		inline static std::atomic<uint64_t> nextUid = 1;
-	private:
-		void GetUid() {
-			uid = Data::Uid::Get();
-		}
-	};	
-
 	class TimerThread : public RE::BSTEventSink<RE::MenuModeChangeEvent>
 	{
 	public:
@@ -75,6 +20,14 @@ namespace Tasks
 			}
 		};
 
+		struct Metrics
+		{
+			uint64_t wakeups = 0;
+			uint64_t dispatched = 0;
+			uint64_t coalesced = 0;
+			uint64_t staleEntries = 0;
+		};
+
 		std::unique_ptr<PersistentState> state;
 		
 		std::thread threadHandle;
@@ -97,7 +50,7 @@ namespace Tasks
 			StopThread();
 		}
 
-		// Timed tasks run on the timer thread when they expire.
+		// Timed tasks run on TaskExecutor's worker threads when they expire.
 		// If they affect game objects, they should be synced back to the main thread with F4SE's TaskInterface.
 		void AddTimedTask(std::shared_ptr<TimedTask> task) {
 			std::unique_lock l{ timerLock };
@@ -107,51 +60,72 @@ namespace Tasks
 				l.unlock();
 				StartThread();
 			} else {
+				if (schedule.QActive()) {
+					schedule.Schedule(task.get(), QClock_NonThreadSafe());
+				}
 				timerStateChanged.notify_one();
 			}
 		}
 		
+		// Removed tasks are only dropped from the map, their schedule entries are skipped once they come up.
+		// Runs that were already dispatched but haven't started are cancelled, even if the task itself already finished.
+		// Once this returns, the task's body isn't running anymore, unless this was called from the body itself.
 		bool RemoveTimedTask(uint64_t taskId) {
 			std::unique_lock l{ timerLock };
-			if (state->timedTasks.contains(taskId)) {
-				state->timedTasks.erase(taskId);
+			const bool removed = state->timedTasks.erase(taskId) > 0;
+			if (removed) {
 				timerStateChanged.notify_one();
-				return true;
-			} else {
-				return false;
 			}
+			// Not dispatched again once it's out of the map. Wait for a running body without timerLock, as it may need it.
+			l.unlock();
+			TaskExecutor::GetSingleton()->Cancel(taskId);
+			return removed;
 		}
 
 		void VisitTask(uint64_t taskId, std::function<void(TimedTask*)> func) {
 			std::unique_lock l{ timerLock };
 			auto iter = state->timedTasks.find(taskId);
 			if (iter != state->timedTasks.end()) {
-				func(iter->second.get());
+				auto tsk = iter->second.get();
+				if (schedule.QActive()) {
+					const double now = QClock_NonThreadSafe();
+					DeadlineSchedule::SyncDuration(tsk, now);
+					func(tsk);
+					schedule.Schedule(tsk, now);
+				} else {
+					func(tsk);
+				}
 				timerStateChanged.notify_one();
 			}
 		}
 
-		// Ensures synchronous removal of multiple tasks.
+		// Ensures synchronous removal of multiple tasks, same as RemoveTimedTask.
 		bool RemoveTimedTasks(std::vector<uint64_t> taskIds)
 		{
 			std::unique_lock l{ timerLock };
 			bool removedAll = true;
 
 			for (auto& id : taskIds) {
-				if (state->timedTasks.contains(id)) {
-					state->timedTasks.erase(id);
-				} else {
+				if (state->timedTasks.erase(id) < 1) {
 					removedAll = false;
 				}
 			}
-			
 			timerStateChanged.notify_one();
+
+			l.unlock();
+			TaskExecutor::GetSingleton()->Cancel(taskIds);
 			return removedAll;
 		}
 
 		void SetPaused(bool paused) {
 			std::scoped_lock l{ timerLock };
+			if (paused != timerPaused) {
+				//Freeze the clock while paused, so that deadlines don't move relative to it.
+				clockAtBase = QClock_NonThreadSafe();
+				clockBase = std::chrono::steady_clock::now();
+			}
 			timerPaused = paused;
+			FrameTimer::SetPaused(paused);
 			if (threadProcessingTasks) {
 				timerStateChanged.notify_one();
 			}
@@ -164,10 +138,26 @@ namespace Tasks
 			}
 
 			StopThread();
+			TaskExecutor::GetSingleton()->Clear();
 
+			std::scoped_lock l{ timerLock };
+			if (metrics.dispatched > 0) {
+				logger::info("Timer thread: {} tasks dispatched over {} wakeups, {} coalesced, {} stale schedule entries skipped",
+					metrics.dispatched, metrics.wakeups, metrics.coalesced, schedule.QStaleEntries());
+			}
+			metrics = Metrics();
+			schedule = DeadlineSchedule();
 			TimedTask::nextUid = 1;
 		}
 
+		// Point-in-time copy of all pending tasks for saving. Only blocks the timer for the copy, not while it's serialized.
+		std::unique_ptr<PersistentState> Snapshot() {
+			std::scoped_lock l{ timerLock };
+			auto result = std::make_unique<PersistentState>();
+			result->timedTasks = schedule.Snapshot(state->timedTasks, QClock_NonThreadSafe());
+			return result;
+		}
+
 		void Start() {
 			StartThread();
 		}
@@ -176,6 +166,13 @@ namespace Tasks
 			StopThread();
 		}
 
+		Metrics QMetrics() {
+			std::scoped_lock l{ timerLock };
+			Metrics result = metrics;
+			result.staleEntries = schedule.QStaleEntries();
+			return result;
+		}
+
 		virtual RE::BSEventNotifyControl ProcessEvent(const RE::MenuModeChangeEvent& a_event, RE::BSTEventSource<RE::MenuModeChangeEvent>*) override {
 			std::unique_lock l{ timerLock };
 			if (a_event.enteringMenuMode && !timerPaused) {
@@ -189,6 +186,19 @@ namespace Tasks
 			return RE::BSEventNotifyControl::kContinue;
 		}
 	private:
+		// Only active while the thread is running.
+		DeadlineSchedule schedule;
+		std::chrono::steady_clock::time_point clockBase = std::chrono::steady_clock::now();
+		double clockAtBase = 0;
+		Metrics metrics;
+
+		// Seconds of unpaused time, deadlines are absolute points on this clock.
+		double QClock_NonThreadSafe() {
+			if (timerPaused) {
+				return clockAtBase;
+			}
+			return clockAtBase + std::chrono::duration<double>(std::chrono::steady_clock::now() - clockBase).count();
+		}
 
 		void StartThread() {
 			StopThread();
@@ -217,121 +227,104 @@ namespace Tasks
 			logger::trace("Timer thread started.");
 			std::unique_lock l{ timerLock };
 			threadProcessingTasks = true;
-			auto lastTimestamp = std::chrono::steady_clock::now();
-			bool doWait = true;
-			double soonestExpiry = 0;
-			std::vector<std::shared_ptr<TimedTask>> expiredTasks;
+			schedule.Activate(state->timedTasks, QClock_NonThreadSafe());
+			auto executor = TaskExecutor::GetSingleton();
+			std::vector<std::pair<std::shared_ptr<TimedTask>, double>> expiredTasks;
 
 			while (true) {
-				if (doWait) {
-					// Go to sleep until time expires for the soonest task, or the timer's state changes.
-					// timerLock is released while thread is asleep, then re-acquired when awakened.
-					timerStateChanged.wait_for(l, std::chrono::duration<double>(soonestExpiry));
-				} else {
-					doWait = true;
+				if (threadPendingCancel) {
+					break;
 				}
 
-				double timeDelta = std::chrono::duration<double>(std::chrono::steady_clock::now() - lastTimestamp).count();
-				if (timeDelta < 0) {
-					timeDelta = 0;
+				if (timerPaused == true) {
+					// If timer is set to paused, put thread to sleep until state changes.
+					// The clock is frozen while paused, so deadlines are still valid once it resumes.
+					timerStateChanged.wait(l);
+					continue;
 				}
 
-				expiredTasks.clear();
-				soonestExpiry = 0;
-
-				for (auto it = state->timedTasks.begin(); it != state->timedTasks.end(); it++) {
-					auto tsk = it->second;
-
-					// If this TimedTask was just added (uninitialized), wait until next loop to begin subtracting time from it.
-					// The thread is immediately awakened when tasks are added, so this will safely set the task's start point.
-					if (tsk->initialized) {
-						tsk->duration -= timeDelta * tsk->timeScale;
-					} else {
-						tsk->initialized = true;
-					}
-
-					if ((soonestExpiry > tsk->duration || soonestExpiry == 0) && tsk->duration > 0) {
-						soonestExpiry = tsk->duration * tsk->timeScale;
-					}
-
-					if (tsk->duration <= 0) {
-						expiredTasks.push_back(tsk);
-					}
-				}
+				// Skips entries of removed or rescheduled tasks.
+				auto nextDeadline = schedule.QNextDeadline(state->timedTasks);
 
-				// After updating the remaining duration on all tasks, check if the thread should be stopped before running any expired tasks.
-				if (threadPendingCancel) {
+				// If there are no tasks remaining, exit the thread.
+				if (state->timedTasks.size() < 1) {
 					break;
 				}
 
-				if (timerPaused == true) {
-					// If timer is set to paused, put thread to sleep until state changes.
+				double now = QClock_NonThreadSafe();
+				if (!nextDeadline.has_value()) {
+					// Only tasks with a time scale of 0 remain, sleep until something changes.
 					timerStateChanged.wait(l);
-					// After state changes, zero-out time delta and run the loop again without waiting.
-					// If the timer is still set to paused, the thread will just go to sleep again when it reaches this point,
-					// or exit completely if threadPendingCancel is true.
-					lastTimestamp = std::chrono::steady_clock::now();
-					doWait = false;
+					continue;
+				} else if (nextDeadline.value() > now + TIMER_COALESCE_WINDOW) {
+					// Go to sleep until time expires for the soonest task, or the timer's state changes.
+					// timerLock is released while thread is asleep, then re-acquired when awakened.
+					timerStateChanged.wait_for(l, std::chrono::duration<double>(nextDeadline.value() - now));
 					continue;
 				}
 
-				for (size_t i = 0; i < expiredTasks.size(); i++) {
-					auto tsk = expiredTasks[i];
-
-					tsk->task->Run();
-
-					// If task is set to repeat, set duration back to initial duration, otherwise remove the task.
-					// If maxRepeats is -1 or less (repeat until task is removed by other code), don't increase the repeats field.
-					if (tsk->maxRepeats > tsk->repeats || tsk->maxRepeats < 0) {
-						tsk->duration = tsk->initDuration;
-						tsk->repeats = tsk->maxRepeats < 0 ? -1 : tsk->repeats + 1;
-
-						if ((soonestExpiry > tsk->duration || soonestExpiry == 0) && tsk->duration > 0) {
-							soonestExpiry = tsk->duration * tsk->timeScale;
-						}
-					} else {
-						if (tsk->repeats > 0) {
-							tsk->task->Finalize();
-						}
-						
-						state->timedTasks.erase(expiredTasks[i]->uid);
-					}
+				// Dispatch everything that is due within the coalescing window in one wakeup, in deadline order.
+				metrics.wakeups++;
+				expiredTasks.clear();
+				while (auto tsk = schedule.PopDue(state->timedTasks, now + TIMER_COALESCE_WINDOW)) {
+					metrics.coalesced += tsk->deadline > now;
+					expiredTasks.emplace_back(tsk, tsk->deadline);
 				}
 
-				// If there are no tasks remaining, exit the thread, otherwise set time delta and continue loop.
-				if (state->timedTasks.size() < 1) {
-					break;
-				} else {
-					lastTimestamp = std::chrono::steady_clock::now();
+				for (auto& [tsk, deadline] : expiredTasks) {
+					const bool finalize = schedule.Expire(state->timedTasks, tsk.get(), now);
+					executor->Dispatch(tsk->uid, tsk->task, finalize, now - deadline);
+					metrics.dispatched++;
 				}
+
+				schedule.Compact(state->timedTasks);
 			}
 			
+			schedule.Deactivate(state->timedTasks, QClock_NonThreadSafe());
 			threadProcessingTasks = false;
 			threadPendingCancel = false;
 			logger::trace("Timer thread stopped.");
 		}
 	};
 
+	enum class TimerDomain : uint8_t
+	{
+		kRealTime,
+		kGameFrame
+	};
+
 	// Container used for objects to take ownership of tasks.
 	// Provides a RAII-style mechanism that will ensure no tasks belonging to an object continue to run after the object has been destroyed.
+	// New tasks are started on the TimerThread (kRealTime) or the FrameTimer (kGameFrame), depending on the container's domain.
+	// Stopping a task checks both, since tasks from saves made before FrameTimer existed are still on the TimerThread.
 	class TaskContainer
 	{
 	public:
 		std::map<std::string, uint64_t> tasks;
+		// Not serialized, set by the owner.
+		TimerDomain domain = TimerDomain::kRealTime;
+
+		TaskContainer() {}
+
+		TaskContainer(TimerDomain _domain) :
+			domain(_domain) {}
 
 		~TaskContainer() {
 			StopAll();
 		}
 
 		void Start(const std::string_view _tskName, std::shared_ptr<TimedTask> task) {
-			auto tThread = TimerThread::GetSingleton();
 			std::string tskName(_tskName);
 
 			if (tasks.contains(tskName)) {
 				Stop(tskName);
 			}
 
-			tThread->AddTimedTask(task);
+			if (domain == TimerDomain::kGameFrame) {
+				FrameTimer::AddTimedTask(task);
+			} else {
+				TimerThread::GetSingleton()->AddTimedTask(task);
+			}
 			tasks.insert(std::make_pair(tskName, task->uid));
 		}
 
@@ -377,11 +370,12 @@ namespace Tasks
 
 		void Stop(const std::string& tskName)
 		{
-			auto tThread = TimerThread::GetSingleton();
 			auto tskIter = tasks.find(tskName);
 
 			if (tskIter != tasks.end()) {
-				tThread->RemoveTimedTask(tskIter->second);
+				if (!FrameTimer::RemoveTimedTask(tskIter->second)) {
+					TimerThread::GetSingleton()->RemoveTimedTask(tskIter->second);
+				}
 				tasks.erase(tskIter);
 			}
 		}
@@ -398,23 +392,27 @@ namespace Tasks
 			bool result = false;
 			auto tskIter = tasks.find(typeid(T).name());
 			if (tskIter != tasks.end()) {
-				TimerThread::GetSingleton()->VisitTask(tskIter->second, [&](TimedTask* tsk) {
+				auto visitor = [&](TimedTask* tsk) {
 					tsk->timeScale = s;
 					result = true;
-				});
+				};
+				FrameTimer::VisitTask(tskIter->second, visitor);
+				if (!result) {
+					TimerThread::GetSingleton()->VisitTask(tskIter->second, visitor);
+				}
 			}
 			return result;
 		}
 
 		void StopAll() {
-			auto tThread = TimerThread::GetSingleton();
-
 			std::vector<uint64_t> taskIds;
 			for (auto& tsk : tasks) {
 				taskIds.push_back(tsk.second);
 			}
 
-			tThread->RemoveTimedTasks(taskIds);
+			if (!FrameTimer::RemoveTimedTasks(taskIds)) {
+				TimerThread::GetSingleton()->RemoveTimedTasks(taskIds);
+			}
 			tasks.clear();
 		}
 
@@ -0,0 +1,123 @@
+#include "TestPCH.h"
+#include "Misc/AtomicPtrSet.h"
+
+namespace
+{
+	struct Face
+	{
+		char pad[512];
+	};
+
+	std::vector<Face> faces(2000);
+
+	void InsertContainsErase()
+	{
+		Misc::AtomicPtrSet<Face> set;
+		CHECK(!set.Contains(&faces[0]));
+		CHECK(set.Insert(&faces[0]));
+		CHECK(!set.Insert(&faces[0]));
+		CHECK(!set.Insert(nullptr));
+		CHECK(set.Contains(&faces[0]));
+		CHECK(!set.Contains(&faces[1]));
+		CHECK(set.size() == 1);
+
+		CHECK(set.Erase(&faces[0]));
+		CHECK(!set.Erase(&faces[0]));
+		CHECK(!set.Contains(&faces[0]));
+		CHECK(set.size() == 0);
+
+		CHECK(set.Insert(&faces[0]));
+		CHECK(set.Contains(&faces[0]));
+	}
+
+	void GrowsAndShrinks()
+	{
+		Misc::AtomicPtrSet<Face> set;
+		for (auto& f : faces) {
+			CHECK(set.Insert(&f));
+		}
+		CHECK(set.size() == faces.size());
+		for (size_t i = 0; i < faces.size(); i += 2) {
+			CHECK(set.Erase(&faces[i]));
+		}
+		for (size_t i = 0; i < faces.size(); i++) {
+			CHECK(set.Contains(&faces[i]) == (i % 2 == 1));
+		}
+
+		set.Clear();
+		CHECK(set.size() == 0);
+		CHECK(!set.Contains(&faces[1]));
+		CHECK(set.Insert(&faces[1]));
+		CHECK(set.Contains(&faces[1]));
+	}
+
+	//Erased slots are reused or rehashed away, so endless churn on a small set keeps working.
+	void ChurnKeepsWorking()
+	{
+		Misc::AtomicPtrSet<Face> set;
+		set.Insert(&faces[0]);
+		for (size_t k = 0; k < 5000; k++) {
+			for (size_t i = 1; i < 20; i++) {
+				set.Insert(&faces[(k + i) % 1999 + 1]);
+			}
+			for (size_t i = 1; i < 20; i++) {
+				set.Erase(&faces[(k + i) % 1999 + 1]);
+			}
+		}
+		CHECK(set.size() == 1);
+		CHECK(set.Contains(&faces[0]));
+	}
+
+	//A reader racing inserts, erases & rehashes must always find what stays in the set, & never what was never in it.
+	void ReadersNeverMissDuringChurn()
+	{
+		Misc::AtomicPtrSet<Face> set;
+		Face outsider;
+		set.Insert(&faces[0]);
+		std::atomic<bool> stop = false;
+		std::atomic<uint64_t> misses = 0;
+		std::atomic<uint64_t> falseHits = 0;
+		std::atomic<uint64_t> reads = 0;
+
+		std::vector<std::thread> readers;
+		for (int r = 0; r < 2; r++) {
+			readers.emplace_back([&] {
+				while (!stop) {
+					misses += !set.Contains(&faces[0]);
+					falseHits += set.Contains(&outsider);
+					reads++;
+				}
+			});
+		}
+
+		for (size_t k = 0; k < 4000; k++) {
+			for (size_t i = 1; i < 40; i++) {
+				set.Insert(&faces[(k + i) % 1999 + 1]);
+			}
+			for (size_t i = 1; i < 40; i++) {
+				set.Erase(&faces[(k + i) % 1999 + 1]);
+			}
+			if (k % 500 == 0) {
+				std::this_thread::yield();
+			}
+		}
+		stop = true;
+		for (auto& r : readers) {
+			r.join();
+		}
+
+		CHECK(misses == 0);
+		CHECK(falseHits == 0);
+		CHECK(reads > 0);
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "InsertContainsErase", InsertContainsErase },
+		{ "GrowsAndShrinks", GrowsAndShrinks },
+		{ "ChurnKeepsWorking", ChurnKeepsWorking },
+		{ "ReadersNeverMissDuringChurn", ReadersNeverMissDuringChurn },
+	});
+}
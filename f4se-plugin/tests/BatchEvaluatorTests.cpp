@@ -0,0 +1,135 @@
+#include "TestPCH.h"
+#include "FaceAnimation/BatchEvaluator.h"
+#include "FaceAnimCorpus.h"
+
+namespace
+{
+	using namespace FaceAnimation;
+
+	//Lerping in SIMD lanes may round differently from std::lerp.
+	constexpr double MaxBatchError = 1e-5;
+
+	//What the face update wrote for each morph timeline before batching.
+	void EvaluateEach(const AnimationData& anim, std::vector<TimelineCursor>& cursors, double t, float* exp)
+	{
+		for (size_t i = 0; i < anim.timelines.size(); i++) {
+			auto& tl = anim.timelines[i];
+			if (!tl.isEyes) {
+				exp[tl.morph] = std::clamp(tl.GetValueAtTime(t, cursors[i]), 0.001f, 0.999f);
+			}
+		}
+	}
+
+	void MatchesPerTimelineEvaluation()
+	{
+		BatchEvaluator evaluator;
+		for (auto& d : Corpus::MakeFaceAnims(100)) {
+			auto anim = d.ToRuntimeData();
+			std::vector<TimelineCursor> batchCursors(anim.timelines.size());
+			std::vector<TimelineCursor> eachCursors(anim.timelines.size());
+			double maxError = 0.0;
+			for (size_t f = 0; f <= 300; f++) {
+				const double t = static_cast<double>(f) / 300.0;
+				std::array<float, FACEANIM_MORPH_COUNT> batchExp{};
+				std::array<float, FACEANIM_MORPH_COUNT> eachExp{};
+				evaluator.Gather(anim, batchCursors, t);
+				evaluator.Evaluate();
+				evaluator.Write(batchExp.data());
+				EvaluateEach(anim, eachCursors, t, eachExp.data());
+				for (size_t m = 0; m < FACEANIM_MORPH_COUNT; m++) {
+					maxError = std::max(maxError, static_cast<double>(std::abs(batchExp[m] - eachExp[m])));
+				}
+			}
+			if (maxError > MaxBatchError) {
+				Test::Fail(__FILE__, __LINE__, std::format("batch off by {}", maxError));
+			}
+		}
+	}
+
+	void EyesAreLeftToTheCaller()
+	{
+		FrameBasedAnimData d;
+		d.GetTimeline(0, true)->keys[0].eyesValue = { 0.5, 0.5 };
+		d.GetTimeline(7)->keys[0].value = 0.5f;
+		d.GetTimeline(9)->keys[30].value = 0.25f;
+		auto anim = d.ToRuntimeData();
+
+		BatchEvaluator evaluator;
+		std::vector<TimelineCursor> cursors(anim.timelines.size());
+		auto eyes = evaluator.Gather(anim, cursors, 0.5);
+		evaluator.Evaluate();
+		CHECK(eyes == 0u);
+		CHECK(evaluator.size() == 2);
+		CHECK(evaluator.GetMorph(0) == 7 && evaluator.GetMorph(1) == 9);
+		CHECK(evaluator.GetResult(0) == 0.5f);
+	}
+
+	void ResultsAreClamped()
+	{
+		FrameBasedAnimData d;
+		d.GetTimeline(1)->keys[0].value = 0.0f;
+		d.GetTimeline(2)->keys[0].value = 1.0f;
+		auto anim = d.ToRuntimeData();
+
+		BatchEvaluator evaluator;
+		std::vector<TimelineCursor> cursors(anim.timelines.size());
+		evaluator.Gather(anim, cursors, 0.5);
+		evaluator.Evaluate();
+		CHECK(evaluator.GetResult(0) == 0.001f);
+		CHECK(evaluator.GetResult(1) == 0.999f);
+	}
+
+	void ChannelsPastTheLimitAreSkipped()
+	{
+		FrameBasedAnimData d;
+		for (size_t i = 0; i < BatchEvaluator::MaxChannels + 6; i++) {
+			d.MakeTimeline(static_cast<uint8_t>(i % FACEANIM_MORPH_COUNT))->keys[0].value = 0.5f;
+		}
+		auto anim = d.ToRuntimeData();
+
+		BatchEvaluator evaluator;
+		std::vector<TimelineCursor> cursors(anim.timelines.size());
+		evaluator.Gather(anim, cursors, 0.5);
+		evaluator.Evaluate();
+		CHECK(evaluator.size() == BatchEvaluator::MaxChannels);
+	}
+
+	//Baked timelines are read from their tables, which are within FACEANIM_BAKE_MAX_ERROR of exact evaluation.
+	void BakedTimelinesUseTables()
+	{
+		BatchEvaluator evaluator;
+		size_t bakedTimelines = 0;
+		for (auto& d : Corpus::MakeFaceAnims(20)) {
+			auto exact = d.ToRuntimeData();
+			auto baked = exact;
+			bakedTimelines += baked.BakeLUTs(60, FACEANIM_BAKE_MAX_ERROR).baked;
+
+			std::vector<TimelineCursor> bakedCursors(baked.timelines.size());
+			std::vector<TimelineCursor> exactCursors(exact.timelines.size());
+			for (size_t f = 0; f <= 100; f++) {
+				const double t = static_cast<double>(f) / 100.0;
+				std::array<float, FACEANIM_MORPH_COUNT> bakedExp{};
+				std::array<float, FACEANIM_MORPH_COUNT> exactExp{};
+				evaluator.Gather(baked, bakedCursors, t);
+				evaluator.Evaluate();
+				evaluator.Write(bakedExp.data());
+				EvaluateEach(exact, exactCursors, t, exactExp.data());
+				for (size_t m = 0; m < FACEANIM_MORPH_COUNT; m++) {
+					CHECK_NEAR(bakedExp[m], exactExp[m], FACEANIM_BAKE_MAX_ERROR + MaxBatchError);
+				}
+			}
+		}
+		CHECK(bakedTimelines > 0);
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "MatchesPerTimelineEvaluation", MatchesPerTimelineEvaluation },
+		{ "EyesAreLeftToTheCaller", EyesAreLeftToTheCaller },
+		{ "ResultsAreClamped", ResultsAreClamped },
+		{ "ChannelsPastTheLimitAreSkipped", ChannelsPastTheLimitAreSkipped },
+		{ "BakedTimelinesUseTables", BakedTimelinesUseTables },
+	});
+}
@@ -0,0 +1,66 @@
+#include "TestPCH.h"
+#include "Bench.h"
+#include "FaceAnimation/BatchEvaluator.h"
+#include "FaceAnimCorpus.h"
+
+using namespace FaceAnimation;
+
+namespace
+{
+	struct Face
+	{
+		const AnimationData* anim;
+		std::vector<TimelineCursor> cursors;
+		double offset;
+		std::array<float, FACEANIM_MORPH_COUNT> exp{};
+	};
+}
+
+//Cost per face per frame of evaluating every morph timeline one at a time, as before batching, and of the batch evaluator.
+int main()
+{
+	std::vector<AnimationData> anims;
+	for (auto& d : Corpus::MakeFaceAnims(50, 3)) {
+		anims.push_back(d.ToRuntimeData());
+	}
+
+	constexpr size_t frames = 2000;
+	std::printf("%-8s %14s %14s\n", "actors", "each ns/face", "batch ns/face");
+	for (size_t actors : { 1, 10, 50 }) {
+		std::vector<Face> faces;
+		for (size_t i = 0; i < actors; i++) {
+			auto& a = anims[i % anims.size()];
+			faces.push_back({ &a, std::vector<TimelineCursor>(a.timelines.size()), static_cast<double>(i) / static_cast<double>(actors) });
+		}
+
+		const double each = Bench::MeasureNs(frames, [&](size_t f) {
+			for (auto& face : faces) {
+				const double t = std::fmod(face.offset + static_cast<double>(f) / static_cast<double>(frames), 1.0);
+				for (size_t i = 0; i < face.anim->timelines.size(); i++) {
+					auto& tl = face.anim->timelines[i];
+					if (!tl.isEyes) {
+						face.exp[tl.morph] = std::clamp(tl.GetValueAtTime(t, face.cursors[i]), 0.001f, 0.999f);
+					}
+				}
+			}
+		});
+
+		BatchEvaluator evaluator;
+		const double batch = Bench::MeasureNs(frames, [&](size_t f) {
+			for (auto& face : faces) {
+				const double t = std::fmod(face.offset + static_cast<double>(f) / static_cast<double>(frames), 1.0);
+				evaluator.Gather(*face.anim, face.cursors, t);
+				evaluator.Evaluate();
+				evaluator.Write(face.exp.data());
+			}
+		});
+
+		double sum = 0.0;
+		for (auto& face : faces) {
+			sum += face.exp[0];
+		}
+		Bench::sink = sum;
+		std::printf("%-8zu %14.1f %14.1f\n", actors, each / static_cast<double>(actors), batch / static_cast<double>(actors));
+	}
+	return 0;
+}
@@ -0,0 +1,30 @@
+#include "TestPCH.h"
+#include "Bench.h"
+#include "Misc/Easing.h"
+
+//Per curve cost of the double precision reference, the single precision curves & the array entry point.
+int main()
+{
+	constexpr size_t count = 1 << 16;
+	std::vector<float> times(count);
+	for (size_t i = 0; i < count; i++) {
+		times[i] = static_cast<float>(i) / static_cast<float>(count - 1);
+	}
+	std::vector<float> values(count);
+
+	std::printf("%-6s %12s %12s %12s\n", "curve", "ref ns", "fast ns", "array ns");
+	for (size_t f = 0; f < Easing::EaseFunctions.size(); f++) {
+		const auto func = static_cast<Easing::Function>(f);
+		double sum = 0.0;
+		const double ref = Bench::MeasureNs(count, [&](size_t i) { sum += Easing::Ease(static_cast<double>(times[i]), func); });
+		const double fast = Bench::MeasureNs(count, [&](size_t i) { sum += Easing::Fast::Ease(times[i], func); });
+		Bench::sink = sum;
+		const double array = Bench::MeasureNs(1, [&](size_t) {
+			values = times;
+			Easing::Fast::EaseArray(func, values.data(), values.size());
+			Bench::sink = Bench::sink + values[count / 3];
+		}) / static_cast<double>(count);
+		std::printf("%-6zu %12.2f %12.2f %12.2f\n", f, ref, fast, array);
+	}
+	return 0;
+}
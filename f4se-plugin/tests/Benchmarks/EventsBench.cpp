@@ -0,0 +1,55 @@
+#include "TestPCH.h"
+#include "Bench.h"
+#include "Data/Events.h"
+
+using Data::Events;
+
+//Cost of a send by number of receivers, of sends from several threads at once & of subscribing & unsubscribing.
+int main()
+{
+	constexpr size_t sends = 1 << 20;
+	uint64_t calls = 0;
+
+	std::printf("%-28s %12s\n", "case", "ns/op");
+	for (size_t receivers : { 0, 1, 4, 16 }) {
+		std::vector<Events::EventRegistration> regs;
+		for (size_t i = 0; i < receivers; i++) {
+			regs.push_back(Events::Subscribe(Events::SCENE_ANIM_LOOP, [&calls](Events::event_type, Events::EventData&) { calls++; }));
+		}
+		const double ns = Bench::MeasureNs(sends, [](size_t i) { Events::Send(Events::SCENE_ANIM_LOOP, static_cast<uint64_t>(i)); });
+		std::printf("send, %2zu receivers %14s %12.2f\n", receivers, "", ns);
+		for (auto& r : regs) {
+			Events::Unsubscribe(r);
+		}
+	}
+
+	std::atomic<uint64_t> sharedCalls = 0;
+	auto reg = Events::Subscribe(Events::SCENE_ANIM_LOOP, [&sharedCalls](Events::event_type, Events::EventData&) {
+		sharedCalls.fetch_add(1, std::memory_order_relaxed);
+	});
+	for (size_t threads : { 2, 4 }) {
+		const auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> senders;
+		for (size_t t = 0; t < threads; t++) {
+			senders.emplace_back([] {
+				for (size_t i = 0; i < sends / 4; i++) {
+					Events::Send(Events::SCENE_ANIM_LOOP, static_cast<uint64_t>(i));
+				}
+			});
+		}
+		for (auto& t : senders) {
+			t.join();
+		}
+		const double ns = Bench::ElapsedMs(start) * 1000000.0 / static_cast<double>(threads * (sends / 4));
+		std::printf("send, %zu threads %17s %12.2f\n", threads, "", ns);
+	}
+	Events::Unsubscribe(reg);
+
+	const double churn = Bench::MeasureNs(1 << 14, [](size_t) {
+		Events::Unsubscribe(Events::Subscribe(Events::SCENE_SPEED_CHANGE, [](Events::event_type, Events::EventData&) {}));
+	});
+	std::printf("subscribe + unsubscribe %4s %12.2f\n", "", churn);
+
+	Bench::sink = static_cast<double>(calls + sharedCalls);
+	return 0;
+}
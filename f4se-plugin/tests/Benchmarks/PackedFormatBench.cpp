@@ -0,0 +1,60 @@
+#include "TestPCH.h"
+#include "Bench.h"
+#include "FaceAnimation/PackedFormat.h"
+#include "FaceAnimCorpus.h"
+
+using namespace FaceAnimation;
+
+//Cache size & decode time of the packed format against the cereal dumps of the std::map timelines it replaced.
+int main()
+{
+	const auto corpus = Corpus::MakeFaceAnims(2000);
+
+	std::vector<std::string> cerealFiles;
+	std::vector<std::string> packedFiles;
+	size_t keys = 0;
+	for (auto d : corpus) {
+		auto runtime = d.ToRuntimeData();
+		keys += runtime.QKeyCount();
+
+		//The old cache stored each timeline as morph, isEyes & a map of normalized time to Keyframe.
+		std::vector<std::tuple<uint8_t, bool, std::map<double, Keyframe>>> oldTimelines;
+		for (auto& tl : runtime.timelines) {
+			oldTimelines.emplace_back(tl.morph, tl.isEyes, Corpus::MapTimeline(tl).keys);
+		}
+		std::ostringstream buffer(std::ios::binary);
+		{
+			cereal::BinaryOutputArchive archive(buffer);
+			archive(oldTimelines, runtime.duration);
+		}
+		cerealFiles.push_back(buffer.str());
+		packedFiles.push_back(PackedFormat::Encode(d));
+	}
+
+	double cerealBytes = 0.0;
+	double packedBytes = 0.0;
+	for (size_t i = 0; i < corpus.size(); i++) {
+		cerealBytes += static_cast<double>(cerealFiles[i].size());
+		packedBytes += static_cast<double>(packedFiles[i].size());
+	}
+
+	const double cerealNs = Bench::MeasureNs(corpus.size(), [&](size_t i) {
+		std::istringstream in(cerealFiles[i], std::ios::binary);
+		cereal::BinaryInputArchive archive(in);
+		std::vector<std::tuple<uint8_t, bool, std::map<double, Keyframe>>> timelines;
+		double duration;
+		archive(timelines, duration);
+		Bench::sink = duration;
+	});
+	const double packedNs = Bench::MeasureNs(corpus.size(), [&](size_t i) {
+		AnimationData out;
+		PackedFormat::Decode(packedFiles[i], out);
+		Bench::sink = out.duration;
+	});
+
+	std::printf("%zu animations, %zu keys\n", corpus.size(), keys);
+	std::printf("%-8s %12s %12s %16s\n", "format", "total KB", "bytes/key", "decode us/anim");
+	std::printf("%-8s %12.1f %12.2f %16.2f\n", "cereal", cerealBytes / 1024.0, cerealBytes / static_cast<double>(keys), cerealNs / 1000.0);
+	std::printf("%-8s %12.1f %12.2f %16.2f\n", "packed", packedBytes / 1024.0, packedBytes / static_cast<double>(keys), packedNs / 1000.0);
+	return 0;
+}
@@ -0,0 +1,65 @@
+#include "TestPCH.h"
+#include "Bench.h"
+#include "Scene/SceneRegistry.h"
+
+namespace Scene
+{
+	class IScene
+	{
+	public:
+		safe_mutex lock;
+		uint64_t uid = 0;
+	};
+}
+
+using namespace Scene;
+
+//Per-frame overhead of getting to every attached scene & locking it, before any scene work:
+//a fresh snapshot vector copied under the scenes map lock, against the update list that is only refreshed
+//when the registry's version changes.
+int main()
+{
+	std::printf("%-8s %14s %14s\n", "scenes", "snapshot ns", "registry ns");
+	for (size_t count : { 1, 20, 100 }) {
+		std::shared_mutex scenesMapLock;
+		SceneRegistry registry;
+		for (size_t i = 0; i < count; i++) {
+			auto scn = std::make_shared<IScene>();
+			scn->uid = i;
+			registry.Insert(scn);
+		}
+
+		const double snapshotNs = Bench::MeasureNs(100000, [&](size_t) {
+			std::vector<std::shared_ptr<IScene>> localScenes;
+			{
+				std::shared_lock l{ scenesMapLock };
+				localScenes = registry.QScenes();
+			}
+			uint64_t sum = 0;
+			for (auto& scn : localScenes) {
+				std::unique_lock l{ scn->lock };
+				sum += scn->uid;
+			}
+			Bench::sink = static_cast<double>(sum);
+		});
+
+		std::vector<std::shared_ptr<IScene>> updateList;
+		uint64_t updateListVersion = UINT64_MAX;
+		const double registryNs = Bench::MeasureNs(100000, [&](size_t) {
+			if (registry.QVersion() != updateListVersion) {
+				std::shared_lock l{ scenesMapLock };
+				updateListVersion = registry.QVersion();
+				updateList.assign(registry.QScenes().begin(), registry.QScenes().end());
+			}
+			uint64_t sum = 0;
+			for (auto& scn : updateList) {
+				std::unique_lock l{ scn->lock };
+				sum += scn->uid;
+			}
+			Bench::sink = static_cast<double>(sum);
+		});
+
+		std::printf("%-8zu %14.1f %14.1f\n", count, snapshotNs, registryNs);
+	}
+	return 0;
+}
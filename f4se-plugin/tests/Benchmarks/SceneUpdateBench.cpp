@@ -0,0 +1,81 @@
+#include "TestPCH.h"
+#include "Bench.h"
+#include "Misc/Easing.h"
+#include "Misc/WorkerPool.h"
+#include "Scene/UpdatePlan.h"
+
+using namespace Scene;
+
+namespace
+{
+	struct BenchScene
+	{
+		std::vector<RE::Actor> actors;
+		std::vector<LocalSyncInfo> syncInfoVec;
+		UpdatePlan plan;
+	};
+
+	//Scenes of 2 to 4 actors with offsets, all of them smooth syncing, which is the most a scene's compute phase does.
+	std::vector<BenchScene> MakeScenes(size_t count)
+	{
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> coord(-5000.0f, 5000.0f);
+		std::vector<BenchScene> result(count);
+		for (auto& scn : result) {
+			scn.actors.resize(2 + rng() % 3);
+			scn.plan.location = { coord(rng), coord(rng), coord(rng) };
+			scn.plan.angle = { 0.0f, 0.0f, 1.0f };
+			scn.plan.smoothSync = true;
+			scn.plan.minTime = 0.5f;
+			scn.plan.baseTotalTime = 2.0f;
+			for (size_t i = 0; i < scn.actors.size(); i++) {
+				auto& info = scn.syncInfoVec.emplace_back();
+				info.actor.reset(&scn.actors[i]);
+				info.currentAnimTime = 0.5f + 0.01f * static_cast<float>(i);
+				info.totalAnimTime = 2.0f;
+				info.oldMult = 100.0f;
+
+				auto& p = scn.plan.placements.emplace_back();
+				p.actor.reset(&scn.actors[i]);
+				p.index = i;
+				p.currentLocation = RE::NiPoint3{ coord(rng), coord(rng), coord(rng) };
+				p.offset = std::pair<RE::NiPoint3, float>{ { 10.0f * static_cast<float>(i), 0.0f, 0.0f }, 0.5f };
+			}
+		}
+		return result;
+	}
+
+	void Compute(BenchScene& scn)
+	{
+		scn.plan.ComputeSmoothSync(scn.syncInfoVec);
+		scn.plan.ComputePlacements();
+	}
+}
+
+//Time per frame of the scene update compute phase, run on the main thread alone against splitting it across the
+//worker pool, at the scene counts a game could have. Gather & apply stay on the main thread either way.
+int main()
+{
+	std::printf("%-8s %14s %14s %14s %14s\n", "scenes", "main ns", "1 worker ns", "2 workers ns", "4 workers ns");
+	Misc::WorkerPool pool;
+	for (size_t count : { 8, 32, 128, 512 }) {
+		auto scenes = MakeScenes(count);
+		const std::function<void(size_t)> compute = [&](size_t i) { Compute(scenes[i]); };
+
+		const double mainNs = Bench::MeasureNs(2000, [&](size_t) {
+			for (auto& scn : scenes) {
+				Compute(scn);
+			}
+		});
+
+		double poolNs[3];
+		const size_t threads[3] = { 1, 2, 4 };
+		for (size_t t = 0; t < 3; t++) {
+			poolNs[t] = Bench::MeasureNs(2000, [&](size_t) { pool.ParallelFor(scenes.size(), compute, threads[t]); });
+		}
+
+		Bench::sink = scenes[0].plan.placements[0].targetLocation.x;
+		std::printf("%-8zu %14.0f %14.0f %14.0f %14.0f\n", count, mainNs, poolNs[0], poolNs[1], poolNs[2]);
+	}
+	return 0;
+}
@@ -0,0 +1,68 @@
+#include "TestPCH.h"
+#include "Bench.h"
+#include "FaceAnimation/AnimationData.h"
+#include "FaceAnimCorpus.h"
+
+using namespace FaceAnimation;
+
+//Per frame sampling cost & memory per keyframe of the flat timelines against the std::map layout they replaced.
+int main()
+{
+	std::vector<AnimationData> anims;
+	for (auto& d : Corpus::MakeFaceAnims(200)) {
+		anims.push_back(d.ToRuntimeData());
+	}
+
+	size_t keys = 0;
+	size_t flatBytes = 0;
+	size_t mapBytes = 0;
+	std::vector<std::vector<Corpus::MapTimeline>> maps;
+	for (auto& a : anims) {
+		keys += a.QKeyCount();
+		auto& m = maps.emplace_back();
+		for (auto& tl : a.timelines) {
+			flatBytes += tl.QMemoryUsage();
+			mapBytes += m.emplace_back(tl).QMemoryUsage();
+		}
+	}
+
+	//Every morph timeline of one animation per frame, as a face plays it at 60fps.
+	constexpr size_t frames = 600;
+	size_t samples = 0;
+	double sum = 0.0;
+	const double flatNs = Bench::MeasureNs(anims.size(), [&](size_t a) {
+		auto& anim = anims[a];
+		std::vector<TimelineCursor> cursors(anim.timelines.size());
+		for (size_t f = 0; f < frames; f++) {
+			const double t = static_cast<double>(f) / static_cast<double>(frames - 1);
+			for (size_t i = 0; i < anim.timelines.size(); i++) {
+				if (!anim.timelines[i].isEyes) {
+					sum += anim.timelines[i].GetValueAtTime(t, cursors[i]);
+				}
+			}
+		}
+	});
+	const double mapNs = Bench::MeasureNs(anims.size(), [&](size_t a) {
+		auto& anim = anims[a];
+		for (size_t f = 0; f < frames; f++) {
+			const double t = static_cast<double>(f) / static_cast<double>(frames - 1);
+			for (size_t i = 0; i < anim.timelines.size(); i++) {
+				if (!anim.timelines[i].isEyes) {
+					sum += maps[a][i].GetValueAtTime(t);
+				}
+			}
+		}
+	});
+	for (auto& a : anims) {
+		for (auto& tl : a.timelines) {
+			samples += !tl.isEyes;
+		}
+	}
+	Bench::sink = sum;
+
+	const double perSample = static_cast<double>(anims.size()) / static_cast<double>(samples * frames);
+	std::printf("%-10s %14s %14s\n", "layout", "ns/sample", "bytes/key");
+	std::printf("%-10s %14.2f %14.2f\n", "map", mapNs * perSample, static_cast<double>(mapBytes) / static_cast<double>(keys));
+	std::printf("%-10s %14.2f %14.2f\n", "flat", flatNs * perSample, static_cast<double>(flatBytes) / static_cast<double>(keys));
+	return 0;
+}
@@ -0,0 +1,90 @@
+#include "TestPCH.h"
+#include "Bench.h"
+#include "Data/Uid.h"
+#include "Tasks/TimerThread.h"
+
+using namespace Tasks;
+
+namespace
+{
+	class CountFunctor : public TaskFunctor
+	{
+	public:
+		CountFunctor(std::atomic<uint64_t>* a_count) :
+			count(a_count) {}
+
+		virtual void Run() override { count->fetch_add(1, std::memory_order_relaxed); }
+
+		std::atomic<uint64_t>* count;
+	};
+
+	//What every wakeup used to do: subtract the elapsed time from every task & find the soonest one.
+	double ScanWakeup(DeadlineSchedule::TaskMap& tasks, double elapsed)
+	{
+		double soonest = std::numeric_limits<double>::max();
+		for (auto& t : tasks) {
+			t.second->duration -= elapsed * t.second->timeScale;
+			soonest = std::min(soonest, t.second->duration);
+		}
+		return soonest;
+	}
+
+	DeadlineSchedule::TaskMap MakeTasks(size_t count, std::atomic<uint64_t>* runs)
+	{
+		std::mt19937 rng(3);
+		std::uniform_real_distribution<double> durationMs(50.0, 2000.0);
+		DeadlineSchedule::TaskMap tasks;
+		for (size_t i = 0; i < count; i++) {
+			auto tsk = TimedTask::MakeTask(std::make_shared<CountFunctor>(runs), durationMs(rng), -1);
+			tasks.emplace(tsk->uid, tsk);
+		}
+		return tasks;
+	}
+}
+
+//10k concurrent repeating timers: the cost of one wakeup with the deadline heap against the full scan it replaced,
+//then the real timer thread running them for a few seconds.
+int main()
+{
+	constexpr size_t timers = 10000;
+	std::atomic<uint64_t> runs = 0;
+
+	auto scanTasks = MakeTasks(timers, &runs);
+	const double scanNs = Bench::MeasureNs(1000, [&](size_t) {
+		Bench::sink = ScanWakeup(scanTasks, 0.0);
+	});
+
+	//Each wakeup pops the soonest task, expires it & pushes its next run, as a steady stream of repeating timers does.
+	auto heapTasks = MakeTasks(timers, &runs);
+	DeadlineSchedule schedule;
+	schedule.Activate(heapTasks, 0.0);
+	double now = 0.0;
+	const double heapNs = Bench::MeasureNs(100000, [&](size_t) {
+		now = schedule.QNextDeadline(heapTasks).value();
+		auto tsk = schedule.PopDue(heapTasks, now);
+		schedule.Expire(heapTasks, tsk.get(), now);
+	});
+
+	std::printf("%zu timers\n", timers);
+	std::printf("%-16s %14s\n", "wakeup", "ns");
+	std::printf("%-16s %14.1f\n", "scan", scanNs);
+	std::printf("%-16s %14.1f\n", "deadline heap", heapNs);
+
+	TimerThread timer;
+	auto liveTasks = MakeTasks(timers, &runs);
+	const auto start = std::chrono::steady_clock::now();
+	for (auto& t : liveTasks) {
+		timer.AddTimedTask(t.second);
+	}
+	const double addMs = Bench::ElapsedMs(start);
+	std::this_thread::sleep_for(std::chrono::seconds(3));
+	auto tm = timer.QMetrics();
+	auto em = TaskExecutor::GetSingleton()->QMetrics();
+	timer.Reset();
+
+	std::printf("\nthread: %.1f ms to add %zu timers, then in 3s\n", addMs, timers);
+	std::printf("%-12s %12s %12s %12s %14s %14s\n", "runs", "dispatched", "wakeups", "coalesced", "avg jitter ms", "max jitter ms");
+	std::printf("%-12llu %12llu %12llu %12llu %14.3f %14.3f\n", static_cast<unsigned long long>(em.runs), static_cast<unsigned long long>(tm.dispatched),
+		static_cast<unsigned long long>(tm.wakeups), static_cast<unsigned long long>(tm.coalesced), em.QAverageJitterMs(), em.maxJitterMs);
+	return 0;
+}
@@ -0,0 +1,86 @@
+#include "TestPCH.h"
+#include "Bench.h"
+#include "Serialization/General.h"
+#include "Data/Uid.h"
+#include "Tasks/TimerThread.h"
+
+namespace TimerSnapshotBench
+{
+	//Same shape as the scene timer functors: an ID & a timer number.
+	class SceneTimerFunctor : public Tasks::TaskFunctor
+	{
+	public:
+		uint64_t sceneId = 0;
+		uint16_t timerId = 0;
+
+		SceneTimerFunctor() {}
+
+		SceneTimerFunctor(uint64_t _sceneId, uint16_t _timerId) :
+			sceneId(_sceneId), timerId(_timerId) {}
+
+		virtual void Run() override {}
+
+		template <class Archive>
+		void serialize(Archive& ar, const uint32_t)
+		{
+			ar(cereal::base_class<Tasks::TaskFunctor>(this), sceneId, timerId);
+		}
+	};
+}
+
+CEREAL_REGISTER_TYPE(TimerSnapshotBench::SceneTimerFunctor);
+
+using namespace Tasks;
+
+namespace
+{
+	F4SE::SerializationInterface intfc;
+
+	template <typename F>
+	double BestMs(F&& func, size_t rounds = 5)
+	{
+		double best = std::numeric_limits<double>::max();
+		for (size_t r = 0; r < rounds; r++) {
+			const auto start = std::chrono::steady_clock::now();
+			func();
+			best = std::min(best, Bench::ElapsedMs(start));
+		}
+		return best;
+	}
+}
+
+//Save & load round trips of the timer thread's tasks. Timers are blocked only while Snapshot() copies the tasks,
+//where the old save stopped the timer thread for the whole serialization & restarted it afterwards.
+int main()
+{
+	Serialization::General::s_intfc = &intfc;
+	std::printf("%-8s %14s %14s %18s %12s\n", "tasks", "snapshot ms", "save ms", "stop & save ms", "load ms");
+	for (size_t count : { 100, 1000, 10000 }) {
+		TimerThread timer;
+		for (size_t i = 0; i < count; i++) {
+			timer.AddTimedTask(TimedTask::MakeTask(std::make_shared<TimerSnapshotBench::SceneTimerFunctor>(i / 4, static_cast<uint16_t>(i % 4)), 600000.0));
+		}
+
+		const double snapshotMs = BestMs([&] { Bench::sink = static_cast<double>(timer.Snapshot()->timedTasks.size()); });
+		const double saveMs = BestMs([&] {
+			intfc.record.clear();
+			Serialization::General::SaveRecord("task", timer.Snapshot());
+		});
+		const double stopSaveMs = BestMs([&] {
+			intfc.record.clear();
+			timer.Stop();
+			Serialization::General::SaveRecord("task", timer.state);
+			timer.Start();
+		});
+		const double loadMs = BestMs([&] {
+			intfc.readPos = 0;
+			auto loaded = std::make_unique<TimerThread::PersistentState>();
+			Serialization::General::LoadRecord("task", loaded);
+			Bench::sink = static_cast<double>(loaded->timedTasks.size());
+		});
+
+		std::printf("%-8zu %14.3f %14.3f %18.3f %12.3f\n", count, snapshotMs, saveMs, stopSaveMs, loadMs);
+		timer.Reset();
+	}
+	return 0;
+}
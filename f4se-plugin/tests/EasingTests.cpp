@@ -0,0 +1,72 @@
+#include "TestPCH.h"
+#include "Misc/Easing.h"
+
+namespace
+{
+	//Documented bound of the single precision curves against the double precision reference.
+	constexpr double MaxFastError = 4e-6;
+	constexpr size_t Samples = 1 << 16;
+
+	std::vector<float> SampleTimes()
+	{
+		std::vector<float> result(Samples + 1);
+		for (size_t i = 0; i <= Samples; i++) {
+			result[i] = static_cast<float>(i) / static_cast<float>(Samples);
+		}
+		return result;
+	}
+
+	void FastCurvesMatchReference()
+	{
+		const auto times = SampleTimes();
+		for (size_t f = 0; f < Easing::EaseFunctions.size(); f++) {
+			const auto func = static_cast<Easing::Function>(f);
+			double maxError = 0.0;
+			for (float t : times) {
+				const double error = std::abs(static_cast<double>(Easing::Fast::Ease(t, func)) - Easing::Ease(static_cast<double>(t), func));
+				maxError = std::max(maxError, error);
+			}
+			if (maxError > MaxFastError) {
+				Test::Fail(__FILE__, __LINE__, std::format("curve {} max error {} above {}", f, maxError, MaxFastError));
+			}
+		}
+	}
+
+	void ArraysMatchSingleValues()
+	{
+		const auto times = SampleTimes();
+		for (size_t f = 0; f < Easing::EaseFunctions.size(); f++) {
+			const auto func = static_cast<Easing::Function>(f);
+			auto values = times;
+			Easing::Fast::EaseArray(func, values.data(), values.size());
+			size_t mismatches = 0;
+			for (size_t i = 0; i < times.size(); i++) {
+				//The compiler may vectorize or contract the array loop differently, so allow for the same bound.
+				mismatches += std::abs(static_cast<double>(values[i]) - Easing::Ease(static_cast<double>(times[i]), func)) > MaxFastError;
+			}
+			if (mismatches > 0) {
+				Test::Fail(__FILE__, __LINE__, std::format("curve {}: {} array values off the reference", f, mismatches));
+			}
+		}
+	}
+
+	void UnknownCurvesAreLinear()
+	{
+		const auto unknown = static_cast<Easing::Function>(Easing::EaseFunctions.size());
+		CHECK(Easing::Ease(0.25, unknown) == 0.25);
+		CHECK(Easing::Fast::Ease(0.25f, unknown) == 0.25f);
+
+		std::array<float, 3> values{ 0.1f, 0.5f, 0.9f };
+		Easing::Fast::EaseArray(unknown, values.data(), values.size());
+		CHECK((values == std::array<float, 3>{ 0.1f, 0.5f, 0.9f }));
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "FastCurvesMatchReference", FastCurvesMatchReference },
+		{ "ArraysMatchSingleValues", ArraysMatchSingleValues },
+		{ "UnknownCurvesAreLinear", UnknownCurvesAreLinear },
+	});
+}
@@ -0,0 +1,288 @@
+#include "TestPCH.h"
+#include "Data/Events.h"
+
+namespace
+{
+	using Data::Events;
+
+	void TypedPayloads()
+	{
+		uint64_t received = 0;
+		std::string name;
+		auto idReg = Events::Subscribe(Events::SCENE_START, [&](Events::event_type, Events::EventData& data) {
+			if (auto id = std::get_if<uint64_t>(&data); id != nullptr) {
+				received = *id;
+			}
+		});
+		auto animReg = Events::Subscribe(Events::SCENE_ANIM_CHANGE, [&](Events::event_type, Events::EventData& data) {
+			if (auto d = std::get_if<std::pair<uint64_t, std::string>>(&data); d != nullptr) {
+				name = d->second;
+			}
+		});
+
+		Events::Send(Events::SCENE_START, uint64_t{ 42 });
+		Events::Send(Events::SCENE_ANIM_CHANGE, std::make_pair(uint64_t{ 42 }, "anim"s));
+		Events::Send(Events::SCENE_START);
+		CHECK(received == 42);
+		CHECK(name == "anim");
+
+		Events::Unsubscribe(idReg);
+		Events::Unsubscribe(animReg);
+	}
+
+	void ReceiversCanChangeMutableData()
+	{
+		auto reg = Events::Subscribe(Events::SHUD_TREE_ITEM_CHANGED, [](Events::event_type, Events::EventData& data) {
+			std::get<Events::SceneTreeItemData>(data).cancel = true;
+		});
+
+		Events::EventData data = Events::SceneTreeItemData{ "a", "b" };
+		Events::SendMutable(Events::SHUD_TREE_ITEM_CHANGED, data);
+		CHECK(std::get<Events::SceneTreeItemData>(data).cancel);
+
+		Events::Unsubscribe(reg);
+	}
+
+	void UnknownEventsAreIgnored()
+	{
+		auto reg = Events::Subscribe(Events::EVENT_TYPE_COUNT, [](Events::event_type, Events::EventData&) {});
+		CHECK(reg.sub == nullptr);
+		Events::Unsubscribe(reg);
+		Events::Send(Events::EVENT_TYPE_COUNT);
+	}
+
+	void UnsubscribeStopsCalls()
+	{
+		std::vector<int> calls(10, 0);
+		std::vector<Events::EventRegistration> regs;
+		for (size_t i = 0; i < calls.size(); i++) {
+			regs.push_back(Events::Subscribe(Events::SCENE_END, [&calls, i](Events::event_type, Events::EventData&) { calls[i]++; }));
+		}
+
+		Events::Send(Events::SCENE_END);
+		//Enough to compact the list, with some left over.
+		for (size_t i = 0; i < 7; i++) {
+			Events::Unsubscribe(regs[i]);
+		}
+		Events::Unsubscribe(regs[0]);
+		Events::Send(Events::SCENE_END);
+
+		for (size_t i = 0; i < calls.size(); i++) {
+			CHECK(calls[i] == (i < 7 ? 1 : 2));
+		}
+		for (size_t i = 7; i < regs.size(); i++) {
+			Events::Unsubscribe(regs[i]);
+		}
+	}
+
+	void SubscribingDuringSendStartsWithNextSend()
+	{
+		int inner = 0;
+		Events::EventRegistration innerReg;
+		auto outerReg = Events::Subscribe(Events::SCENE_POS_CHANGE, [&](Events::event_type, Events::EventData&) {
+			if (!innerReg.sub) {
+				innerReg = Events::Subscribe(Events::SCENE_POS_CHANGE, [&](Events::event_type, Events::EventData&) { inner++; });
+			}
+		});
+
+		Events::Send(Events::SCENE_POS_CHANGE);
+		CHECK(inner == 0);
+		Events::Send(Events::SCENE_POS_CHANGE);
+		CHECK(inner == 1);
+
+		Events::Unsubscribe(outerReg);
+		Events::Unsubscribe(innerReg);
+	}
+
+	//Would wait on its own send forever if unsubscribing didn't discount the current thread's sends.
+	void ReceiversCanUnsubscribeThemselves()
+	{
+		int calls = 0;
+		Events::EventRegistration reg;
+		reg = Events::Subscribe(Events::HUD_INIT, [&](Events::event_type, Events::EventData&) {
+			calls++;
+			Events::Unsubscribe(reg);
+		});
+
+		Events::Send(Events::HUD_INIT);
+		Events::Send(Events::HUD_INIT);
+		CHECK(calls == 1);
+	}
+
+	void NestedSendsCanUnsubscribeOuterReceivers()
+	{
+		int outerCalls = 0;
+		int innerCalls = 0;
+		Events::EventRegistration outerReg;
+		Events::EventRegistration innerReg;
+		outerReg = Events::Subscribe(Events::SCENE_SPEED_CHANGE, [&](Events::event_type, Events::EventData&) {
+			outerCalls++;
+			Events::Send(Events::SCENE_ANIM_LOOP);
+		});
+		innerReg = Events::Subscribe(Events::SCENE_ANIM_LOOP, [&](Events::event_type, Events::EventData&) {
+			innerCalls++;
+			Events::Unsubscribe(outerReg);
+			Events::Send(Events::SCENE_SPEED_CHANGE);
+		});
+
+		Events::Send(Events::SCENE_SPEED_CHANGE);
+		Events::Send(Events::SCENE_SPEED_CHANGE);
+		CHECK(outerCalls == 1);
+		CHECK(innerCalls == 1);
+
+		Events::Unsubscribe(innerReg);
+	}
+
+	void UnsubscribeWaitsForRunningReceiver()
+	{
+		std::atomic<bool> entered = false;
+		std::atomic<bool> finished = false;
+		std::atomic<int> calls = 0;
+		auto reg = Events::Subscribe(Events::SETTINGS_CHANGED, [&](Events::event_type, Events::EventData&) {
+			calls++;
+			entered = true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			finished = true;
+		});
+
+		std::thread sender([] { Events::Send(Events::SETTINGS_CHANGED); });
+		while (!entered) {
+			std::this_thread::yield();
+		}
+		Events::Unsubscribe(reg);
+		CHECK(finished);
+		sender.join();
+
+		Events::Send(Events::SETTINGS_CHANGED);
+		CHECK(calls == 1);
+	}
+
+	//A second unsubscribe from the same event, started while a first one still waits, must wait for its own receiver too.
+	void ConcurrentUnsubscribesBothWait()
+	{
+		std::atomic<bool> entered = false;
+		std::atomic<bool> finished = false;
+		auto slowReg = Events::Subscribe(Events::HUD_LEFT_KEY_DOWN, [&](Events::event_type, Events::EventData&) {
+			entered = true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			finished = true;
+		});
+		auto otherReg = Events::Subscribe(Events::HUD_LEFT_KEY_DOWN, [](Events::event_type, Events::EventData&) {});
+
+		std::thread sender([] { Events::Send(Events::HUD_LEFT_KEY_DOWN); });
+		while (!entered) {
+			std::this_thread::yield();
+		}
+		std::atomic<bool> otherDone = false;
+		std::thread first([&] {
+			Events::Unsubscribe(otherReg);
+			otherDone = true;
+		});
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		Events::Unsubscribe(slowReg);
+		CHECK(finished);
+
+		first.join();
+		sender.join();
+		CHECK(otherDone);
+	}
+
+	//Senders on other threads hammer the event while receivers come & go. No receiver may run once its unsubscribe returned.
+	void NoCallsAfterUnsubscribeUnderLoad()
+	{
+		std::atomic<bool> stop = false;
+		std::atomic<uint64_t> sends = 0;
+		std::vector<std::thread> senders;
+		for (int i = 0; i < 3; i++) {
+			senders.emplace_back([&] {
+				while (!stop) {
+					Events::Send(Events::GAME_DATA_READY);
+					sends++;
+				}
+			});
+		}
+
+		std::atomic<uint64_t> lateCalls = 0;
+		std::atomic<uint64_t> calls = 0;
+		for (int i = 0; i < 200; i++) {
+			auto unsubscribed = std::make_shared<std::atomic<bool>>(false);
+			auto reg = Events::Subscribe(Events::GAME_DATA_READY, [&, unsubscribed](Events::event_type, Events::EventData&) {
+				calls++;
+				if (*unsubscribed) {
+					lateCalls++;
+				}
+			});
+			const uint64_t target = sends + 2;
+			while (sends < target) {
+				std::this_thread::yield();
+			}
+			Events::Unsubscribe(reg);
+			*unsubscribed = true;
+		}
+
+		stop = true;
+		for (auto& t : senders) {
+			t.join();
+		}
+		CHECK(lateCalls == 0);
+		CHECK(calls > 0);
+	}
+
+	class Listener : public Data::EventListener<Listener>
+	{
+	public:
+		Listener(int& a_calls) :
+			calls(a_calls)
+		{
+			RegisterListener(Events::HUD_Q_KEY_DOWN, &Listener::OnKey);
+			RegisterListener(Events::HUD_E_KEY_DOWN, &Listener::OnKey);
+		}
+
+		void StopE()
+		{
+			UnregisterListener(Events::HUD_E_KEY_DOWN);
+		}
+
+	private:
+		void OnKey(Events::event_type, Events::EventData&)
+		{
+			calls++;
+		}
+
+		int& calls;
+	};
+
+	void ListenersUnsubscribeOnDestruction()
+	{
+		int calls = 0;
+		{
+			Listener l(calls);
+			Events::Send(Events::HUD_Q_KEY_DOWN);
+			Events::Send(Events::HUD_E_KEY_DOWN);
+			CHECK(calls == 2);
+
+			l.StopE();
+			Events::Send(Events::HUD_E_KEY_DOWN);
+			CHECK(calls == 2);
+		}
+		Events::Send(Events::HUD_Q_KEY_DOWN);
+		CHECK(calls == 2);
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "TypedPayloads", TypedPayloads },
+		{ "ReceiversCanChangeMutableData", ReceiversCanChangeMutableData },
+		{ "UnknownEventsAreIgnored", UnknownEventsAreIgnored },
+		{ "UnsubscribeStopsCalls", UnsubscribeStopsCalls },
+		{ "SubscribingDuringSendStartsWithNextSend", SubscribingDuringSendStartsWithNextSend },
+		{ "ReceiversCanUnsubscribeThemselves", ReceiversCanUnsubscribeThemselves },
+		{ "NestedSendsCanUnsubscribeOuterReceivers", NestedSendsCanUnsubscribeOuterReceivers },
+		{ "UnsubscribeWaitsForRunningReceiver", UnsubscribeWaitsForRunningReceiver },
+		{ "ConcurrentUnsubscribesBothWait", ConcurrentUnsubscribesBothWait },
+		{ "NoCallsAfterUnsubscribeUnderLoad", NoCallsAfterUnsubscribeUnderLoad },
+		{ "ListenersUnsubscribeOnDestruction", ListenersUnsubscribeOnDestruction },
+	});
+}
@@ -0,0 +1,160 @@
+#include "TestPCH.h"
+#include "Data/Events.h"
+#include "Data/Settings.h"
+#include "FaceAnimation/FaceLOD.h"
+
+namespace
+{
+	using namespace FaceAnimation;
+	using Data::Settings;
+
+	//Puts every face at a fixed distance, on or off screen.
+	class MockView : public ILODView
+	{
+	public:
+		MockView(std::optional<float> a_distance, bool a_onScreen = true) :
+			distance(a_distance), onScreen(a_onScreen) {}
+
+		virtual std::optional<float> QCameraDistance(RE::Actor*) override { return distance; }
+		virtual bool QOnScreen(RE::Actor*) override { return onScreen; }
+
+		std::optional<float> distance;
+		bool onScreen;
+	};
+
+	//Sets the LOD settings for one test, & puts the defaults & game view back afterwards.
+	struct LODSettings
+	{
+		LODSettings(uint32_t full, uint32_t frozen, uint32_t interval = 3)
+		{
+			Settings::Values.iFaceLODFullDistance = full;
+			Settings::Values.iFaceLODFrozenDistance = frozen;
+			Settings::Values.iFaceLODReducedInterval = interval;
+		}
+
+		~LODSettings()
+		{
+			Settings::SettingValues defaults;
+			Settings::Values.iFaceLODFullDistance = defaults.iFaceLODFullDistance.load();
+			Settings::Values.iFaceLODFrozenDistance = defaults.iFaceLODFrozenDistance.load();
+			Settings::Values.iFaceLODReducedInterval = defaults.iFaceLODReducedInterval.load();
+			FaceLOD::SetView(std::make_unique<GameLODView>());
+			RE::MockWorld::Clear();
+		}
+	};
+
+	LODBand BandAt(std::optional<float> distance, bool onScreen = true)
+	{
+		RE::Actor actor;
+		FaceLOD::SetView(std::make_unique<MockView>(distance, onScreen));
+		return FaceLOD::GetBand(&actor);
+	}
+
+	void BandsFollowDistance()
+	{
+		LODSettings s(1500, 6000);
+		CHECK(BandAt(0.0f) == LODBand::kFull);
+		CHECK(BandAt(1500.0f) == LODBand::kFull);
+		CHECK(BandAt(1501.0f) == LODBand::kReduced);
+		CHECK(BandAt(6000.0f) == LODBand::kReduced);
+		CHECK(BandAt(6001.0f) == LODBand::kFrozen);
+	}
+
+	void OffScreenFacesFreezeOutsideFullRange()
+	{
+		LODSettings s(1500, 6000);
+		CHECK(BandAt(100.0f, false) == LODBand::kFull);
+		CHECK(BandAt(2000.0f, false) == LODBand::kFrozen);
+		CHECK(BandAt(9000.0f, false) == LODBand::kFrozen);
+	}
+
+	void UnknownDistanceIsFullRate()
+	{
+		LODSettings s(1500, 6000);
+		CHECK(BandAt(std::nullopt) == LODBand::kFull);
+		CHECK(BandAt(std::nullopt, false) == LODBand::kFull);
+	}
+
+	void ZeroFullDistanceDisablesLOD()
+	{
+		LODSettings s(0, 6000);
+		CHECK(BandAt(9000.0f, false) == LODBand::kFull);
+	}
+
+	void ReducedIntervalIsAtLeastOne()
+	{
+		LODSettings s(1500, 6000, 0);
+		CHECK(FaceLOD::QReducedInterval() == 1);
+		Settings::Values.iFaceLODReducedInterval = 4;
+		CHECK(FaceLOD::QReducedInterval() == 4);
+	}
+
+	//The game view measures from the camera root & only rejects faces behind the camera.
+	void GameViewUsesCameraRoot()
+	{
+		LODSettings s(1500, 6000);
+		RE::NiNode root;
+		root.world.translate = { 100.0f, 0.0f, 0.0f };
+		RE::PlayerCamera camera;
+		camera.cameraRoot = &root;
+
+		RE::Actor ahead;
+		ahead.data.location = { 100.0f, 3000.0f, 0.0f };
+		RE::Actor behind;
+		behind.data.location = { 100.0f, -3000.0f, 0.0f };
+		RE::Actor beside;
+		beside.data.location = { 3100.0f, 0.0f, 0.0f };
+
+		GameLODView view;
+		CHECK(!view.QCameraDistance(&ahead).has_value());
+		CHECK(view.QOnScreen(&behind));
+
+		RE::MockWorld::camera = &camera;
+		CHECK_NEAR(view.QCameraDistance(&ahead).value(), 3000.0f, 1e-3);
+		CHECK(!view.QCameraDistance(nullptr).has_value());
+		CHECK(view.QOnScreen(&ahead));
+		CHECK(!view.QOnScreen(&behind));
+		CHECK(view.QOnScreen(&beside));
+
+		CHECK(FaceLOD::GetBand(&ahead) == LODBand::kReduced);
+		CHECK(FaceLOD::GetBand(&behind) == LODBand::kFrozen);
+
+		//Turned around, the camera looks down world -Y.
+		root.world.rotate.entry[1].y = -1.0f;
+		CHECK(!view.QOnScreen(&ahead));
+		CHECK(view.QOnScreen(&behind));
+	}
+
+	void MetricsCountFramesAndWrites()
+	{
+		FaceLOD::Reset();
+		FaceLOD::RecordFrame(LODBand::kFull, 40, 30);
+		FaceLOD::RecordFrame(LODBand::kFull, 40, 40);
+		FaceLOD::RecordFrame(LODBand::kReduced, 40, 10);
+		FaceLOD::RecordFrame(LODBand::kFrozen, 40, 0);
+
+		auto m = FaceLOD::QMetrics();
+		CHECK(m.fullFrames == 2);
+		CHECK(m.reducedFrames == 1);
+		CHECK(m.frozenFrames == 1);
+		CHECK(m.morphWrites == 80);
+		CHECK(m.morphWritesSkipped == 80);
+
+		FaceLOD::Reset();
+		m = FaceLOD::QMetrics();
+		CHECK(m.fullFrames + m.reducedFrames + m.frozenFrames + m.morphWrites + m.morphWritesSkipped == 0);
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "BandsFollowDistance", BandsFollowDistance },
+		{ "OffScreenFacesFreezeOutsideFullRange", OffScreenFacesFreezeOutsideFullRange },
+		{ "UnknownDistanceIsFullRate", UnknownDistanceIsFullRate },
+		{ "ZeroFullDistanceDisablesLOD", ZeroFullDistanceDisablesLOD },
+		{ "ReducedIntervalIsAtLeastOne", ReducedIntervalIsAtLeastOne },
+		{ "GameViewUsesCameraRoot", GameViewUsesCameraRoot },
+		{ "MetricsCountFramesAndWrites", MetricsCountFramesAndWrites },
+	});
+}
@@ -0,0 +1,224 @@
+#include "TestPCH.h"
+#include "Data/Events.h"
+#include "Data/Settings.h"
+#include "FaceAnimation/AnimationData.h"
+
+//Loading face animations by ID needs the XML data & the decoded anim cache, which these tests don't use.
+namespace Data
+{
+	struct FaceAnim
+	{
+		std::string fileName;
+	};
+
+	std::shared_ptr<const FaceAnim> GetFaceAnim(const std::string&) { return nullptr; }
+
+	struct DecodedAnimCache
+	{
+		static std::shared_ptr<const FaceAnimation::AnimationData> Get(const std::string&) { return nullptr; }
+	};
+}
+
+#include "FaceAnimation/FrameEvaluator.h"
+#include "FaceAnimCorpus.h"
+
+namespace
+{
+	using namespace FaceAnimation;
+
+	struct Face
+	{
+		RE::BSFaceGenAnimationData faceData;
+		std::unique_ptr<FaceAnimation::FaceAnimation> anim;
+	};
+
+	std::vector<std::shared_ptr<const AnimationData>> MakeData(size_t count)
+	{
+		std::vector<std::shared_ptr<const AnimationData>> result;
+		for (auto& d : Corpus::MakeFaceAnims(count, 3)) {
+			result.push_back(std::make_shared<const AnimationData>(d.ToRuntimeData()));
+		}
+		return result;
+	}
+
+	//A looping face playing data, a frame of delta seconds into it.
+	Face MakeFace(std::shared_ptr<const AnimationData> data, double elapsed, float delta = 1.0f / 60.0f)
+	{
+		Face f;
+		f.anim = std::make_unique<FaceAnimation::FaceAnimation>();
+		f.anim->SetData(std::move(data));
+		f.anim->loop = true;
+		f.anim->havokSync = true;
+		f.anim->timeElapsed = elapsed;
+		f.anim->lastTimeDelta = delta;
+		return f;
+	}
+
+	std::vector<FrameEvaluator::Job> MakeJobs(std::vector<Face>& faces)
+	{
+		std::vector<FrameEvaluator::Job> jobs;
+		for (auto& f : faces) {
+			jobs.push_back({ &f.faceData, f.anim.get() });
+		}
+		return jobs;
+	}
+
+	bool SameValues(const EvaluatedFace& a, const EvaluatedFace& b)
+	{
+		if (a.data != b.data || a.count != b.count || a.hasEyes != b.hasEyes || a.eyeU != b.eyeU || a.eyeV != b.eyeV) {
+			return false;
+		}
+		for (size_t i = 0; i < a.count; i++) {
+			if (a.morphs[i] != b.morphs[i] || a.values[i] != b.values[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//Synced faces playing the same data at the same time are evaluated once, & every one of them gets the same values
+	//as evaluating it on its own.
+	void SyncedFacesShareOneEvaluation()
+	{
+		auto data = MakeData(2);
+		std::vector<Face> faces;
+		for (size_t i = 0; i < 6; i++) {
+			faces.push_back(MakeFace(data[0], 1.0));
+		}
+		//Within FACEANIM_PREEVAL_SHARE_STEP of the others, but not exactly the same time.
+		faces.push_back(MakeFace(data[0], 1.0 + FACEANIM_PREEVAL_SHARE_STEP * 0.25));
+		faces.push_back(MakeFace(data[0], 1.5));
+		faces.push_back(MakeFace(data[1], 1.0));
+		faces.push_back(MakeFace(data[1], 1.0));
+
+		FrameEvaluator evaluator;
+		evaluator.Publish(MakeJobs(faces));
+		auto m = evaluator.QMetrics();
+		CHECK(m.ticks == 1);
+		CHECK(m.evaluated == 3);
+		CHECK(m.shared == 7);
+
+		FrameEvaluator::Reader reader(evaluator);
+		for (size_t i = 0; i < faces.size(); i++) {
+			auto result = reader.Find(&faces[i].faceData);
+			CHECK(result != nullptr);
+			if (i != 6) {
+				EvaluatedFace expected;
+				faces[i].anim->Evaluate(faces[i].anim->QPredictedTime().value(), expected);
+				CHECK(SameValues(*result, expected));
+			}
+		}
+		CHECK(SameValues(*reader.Find(&faces[0].faceData), *reader.Find(&faces[6].faceData)));
+	}
+
+	//Faces on a reduced LOD band or at the end of a non-looping animation aren't pre-evaluated, so the hook finds nothing for them.
+	void SkippedFacesArentPublished()
+	{
+		auto data = MakeData(1);
+		std::vector<Face> faces;
+		faces.push_back(MakeFace(data[0], 1.0));
+		faces.push_back(MakeFace(data[0], 1.0));
+		faces[1].anim->lodBand = LODBand::kReduced;
+		faces.push_back(MakeFace(data[0], data[0]->duration));
+		faces[2].anim->loop = false;
+		faces[2].anim->havokSync = false;
+
+		FrameEvaluator evaluator;
+		evaluator.Publish(MakeJobs(faces));
+		CHECK(evaluator.QMetrics().evaluated == 1);
+		CHECK(evaluator.QMetrics().shared == 0);
+		FrameEvaluator::Reader reader(evaluator);
+		CHECK(reader.Find(&faces[0].faceData) != nullptr);
+		CHECK(reader.Find(&faces[1].faceData) == nullptr);
+		CHECK(reader.Find(&faces[2].faceData) == nullptr);
+	}
+
+	//If the hook's frame ends up further than FACEANIM_PREEVAL_MAX_DRIFT from the predicted time, it evaluates the face
+	//itself, & writes the same values as without pre-evaluation.
+	void MismatchFallsBackToHook()
+	{
+		auto data = MakeData(1);
+		std::vector<Face> faces;
+		faces.push_back(MakeFace(data[0], 1.0));
+		faces.push_back(MakeFace(data[0], 1.0));
+
+		FrameEvaluator evaluator;
+		evaluator.Publish(MakeJobs(faces));
+		FrameEvaluator::Reader reader(evaluator);
+
+		//Same delta as predicted for the first face, a longer frame for the second.
+		faces[0].anim->Advance(1.0f / 60.0f);
+		faces[1].anim->Advance(1.0f / 60.0f + static_cast<float>(FACEANIM_PREEVAL_MAX_DRIFT) * 2.0f);
+		for (auto& f : faces) {
+			auto r = f.anim->UpdateNoDelta(&f.faceData, nullptr, LODBand::kFull, reader.Find(&f.faceData));
+			evaluator.RecordApply(r.preEvaluated);
+		}
+
+		for (auto& f : faces) {
+			RE::BSFaceGenAnimationData direct;
+			FaceAnimation::FaceAnimation self;
+			self.SetData(data[0]);
+			self.timeElapsed = f.anim->timeElapsed;
+			self.UpdateNoDelta(&direct, nullptr);
+			CHECK(std::equal(std::begin(direct.finalExp.exp), std::end(direct.finalExp.exp), std::begin(f.faceData.finalExp.exp)));
+		}
+
+		auto m = evaluator.QMetrics();
+		CHECK(m.applied == 1);
+		CHECK(m.fallbacks == 1);
+	}
+
+	//Frames like the game loop's: pre-evaluate, advance by the real frame time, then update in the hook. Predictions assume
+	//the last frame's delta, so a hitch & the frame after it fall back, & every face still shows the exact values.
+	void JitteryFramesCountHitsAndFallbacks()
+	{
+		auto data = MakeData(3);
+		std::vector<Face> faces;
+		for (size_t i = 0; i < 4; i++) {
+			faces.push_back(MakeFace(data[i % 3], 0.1 * static_cast<double>(i)));
+			faces.back().anim->SetDuration(60000.0);
+		}
+		auto jobs = MakeJobs(faces);
+
+		FrameEvaluator evaluator;
+		const float steady = 1.0f / 60.0f;
+		const float hitch = steady + static_cast<float>(FACEANIM_PREEVAL_MAX_DRIFT) * 3.0f;
+		float lastDelta = steady;
+		uint64_t expectedHits = 0;
+		bool allExact = true;
+		for (size_t frame = 0; frame < 300; frame++) {
+			evaluator.Publish(jobs);
+			const float delta = (frame % 10 == 9) ? hitch : steady;
+			const bool hit = delta == lastDelta;
+			lastDelta = delta;
+
+			FrameEvaluator::Reader reader(evaluator);
+			for (auto& f : faces) {
+				f.anim->Advance(delta);
+				auto r = f.anim->UpdateNoDelta(&f.faceData, nullptr, LODBand::kFull, reader.Find(&f.faceData));
+				evaluator.RecordApply(r.preEvaluated);
+				expectedHits += hit;
+
+				EvaluatedFace direct;
+				f.anim->Evaluate(f.anim->timeElapsed, direct);
+				allExact = allExact && SameValues(f.anim->shown, direct);
+			}
+		}
+		CHECK(allExact);
+
+		auto m = evaluator.QMetrics();
+		CHECK(m.applied == expectedHits);
+		CHECK(m.applied + m.fallbacks == 300 * faces.size());
+		CHECK_NEAR(m.QAppliedRate(), 0.8, 0.01);
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "SyncedFacesShareOneEvaluation", SyncedFacesShareOneEvaluation },
+		{ "SkippedFacesArentPublished", SkippedFacesArentPublished },
+		{ "MismatchFallsBackToHook", MismatchFallsBackToHook },
+		{ "JitteryFramesCountHitsAndFallbacks", JitteryFramesCountHitsAndFallbacks },
+	});
+}
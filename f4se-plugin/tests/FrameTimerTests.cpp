@@ -0,0 +1,257 @@
+#include "TestPCH.h"
+#include "Data/Uid.h"
+#include "Tasks/TimerThread.h"
+
+namespace
+{
+	using namespace Tasks;
+
+	//Main thread runs of every task, in the order they happened.
+	struct RunLog
+	{
+		std::vector<int> runs;
+		std::vector<int> finalized;
+		bool offMainThread = false;
+	};
+
+	class LogFunctor : public TaskFunctor
+	{
+	public:
+		LogFunctor(RunLog* a_log, int a_id, std::function<void()> a_onRun = nullptr) :
+			log(a_log), id(a_id), onRun(a_onRun) {}
+
+		virtual void Run() override { log->offMainThread = true; }
+
+		virtual void RunOnMainThread() override
+		{
+			log->runs.push_back(id);
+			if (onRun) {
+				onRun();
+			}
+		}
+
+		virtual void Finalize() override { log->finalized.push_back(id); }
+
+		RunLog* log;
+		int id;
+		std::function<void()> onRun;
+	};
+
+	std::shared_ptr<TimedTask> AddTask(RunLog& log, int id, double ms, int64_t repeats = 0, std::function<void()> onRun = nullptr)
+	{
+		auto tsk = TimedTask::MakeTask(std::make_shared<LogFunctor>(&log, id, onRun), ms, repeats);
+		FrameTimer::AddTimedTask(tsk);
+		return tsk;
+	}
+
+	//Runs frames of the given length, like the game loop hook does.
+	void RunFrames(size_t count, double frameSeconds = 1.0 / 60.0)
+	{
+		for (size_t i = 0; i < count; i++) {
+			FrameTimer::Update(frameSeconds);
+		}
+	}
+
+	struct FreshFrameTimer
+	{
+		FreshFrameTimer()
+		{
+			FrameTimer::Reset();
+			FrameTimer::Start();
+			FrameTimer::SetPaused(false);
+		}
+
+		~FreshFrameTimer()
+		{
+			FrameTimer::Reset();
+			FrameTimer::SetPaused(false);
+		}
+	};
+
+	void RunsOnUpdateInDeadlineOrder()
+	{
+		FreshFrameTimer f;
+		RunLog log;
+		AddTask(log, 30, 30);
+		AddTask(log, 10, 10);
+		AddTask(log, 20, 20);
+
+		FrameTimer::Update(0.005);
+		CHECK(log.runs.empty());
+		FrameTimer::Update(0.010);
+		CHECK((log.runs == std::vector<int>{ 10 }));
+		FrameTimer::Update(0.1);
+		CHECK((log.runs == std::vector<int>{ 10, 20, 30 }));
+		CHECK(!log.offMainThread);
+		CHECK(log.finalized.empty());
+
+		auto m = FrameTimer::QMetrics();
+		CHECK(m.frames == 3);
+		CHECK(m.runs == 3);
+		CHECK_NEAR(m.maxLateMs, 95.0, 1e-6);
+	}
+
+	//Opening a menu pauses the frame clock through TimerThread, like it pauses the timer thread's own clock.
+	void MenuModeFreezesFrameClock()
+	{
+		FreshFrameTimer f;
+		RunLog log;
+		TimerThread timer;
+		AddTask(log, 1, 500);
+
+		RunFrames(15);
+		timer.ProcessEvent(RE::MenuModeChangeEvent{ true }, nullptr);
+		RunFrames(600);
+		CHECK(log.runs.empty());
+		CHECK(FrameTimer::QMetrics().frames == 15);
+
+		timer.ProcessEvent(RE::MenuModeChangeEvent{ false }, nullptr);
+		RunFrames(14);
+		CHECK(log.runs.empty());
+		RunFrames(2);
+		CHECK(log.runs.size() == 1);
+		timer.Stop();
+	}
+
+	void RepeatsRunOncePerFrameAtMost()
+	{
+		FreshFrameTimer f;
+		RunLog log;
+		auto zero = AddTask(log, 0, 0, -1);
+		auto tenMs = AddTask(log, 10, 10, 3);
+
+		//A 100ms frame is far behind the 10ms task, it runs once & is rescheduled from now instead of catching up.
+		FrameTimer::Update(0.1);
+		CHECK(std::count(log.runs.begin(), log.runs.end(), 0) == 1);
+		CHECK(std::count(log.runs.begin(), log.runs.end(), 10) == 1);
+		CHECK_NEAR(tenMs->deadline, 0.11, 1e-9);
+
+		RunFrames(10, 0.01);
+		CHECK(std::count(log.runs.begin(), log.runs.end(), 0) == 11);
+		CHECK(std::count(log.runs.begin(), log.runs.end(), 10) == 4);
+		CHECK((log.finalized == std::vector<int>{ 10 }));
+		CHECK(FrameTimer::RemoveTimedTask(zero->uid));
+		CHECK(!FrameTimer::RemoveTimedTask(tenMs->uid));
+	}
+
+	//Tasks run with the lock released, so they can stop & start other tasks in the same frame.
+	void TasksCanChangeOtherTasks()
+	{
+		FreshFrameTimer f;
+		RunLog log;
+		std::shared_ptr<TimedTask> victim;
+		AddTask(log, 1, 10, 0, [&] {
+			FrameTimer::RemoveTimedTask(victim->uid);
+			AddTask(log, 3, 0);
+		});
+		victim = AddTask(log, 2, 20);
+
+		FrameTimer::Update(0.05);
+		CHECK((log.runs == std::vector<int>{ 1 }));
+		FrameTimer::Update(0.0);
+		CHECK((log.runs == std::vector<int>{ 1, 3 }));
+	}
+
+	void TimeScaleChangesKeepElapsedTime()
+	{
+		FreshFrameTimer f;
+		RunLog log;
+		auto tsk = AddTask(log, 1, 100);
+		FrameTimer::Update(0.05);
+		FrameTimer::VisitTask(tsk->uid, [](TimedTask* t) { t->timeScale = 0.5; });
+		CHECK_NEAR(tsk->duration, 0.05, 1e-9);
+
+		FrameTimer::Update(0.09);
+		CHECK(log.runs.empty());
+		FrameTimer::Update(0.02);
+		CHECK(log.runs.size() == 1);
+	}
+
+	//Stopping for a load writes remaining durations back, & the snapshot for a save sees the same.
+	void StopAndSnapshotKeepRemainingTime()
+	{
+		FreshFrameTimer f;
+		RunLog log;
+		auto tsk = AddTask(log, 1, 100);
+		FrameTimer::Update(0.03);
+
+		auto snapshot = FrameTimer::Snapshot();
+		CHECK_NEAR(snapshot->timedTasks.at(tsk->uid)->duration, 0.07, 1e-9);
+		CHECK_NEAR(tsk->duration, 0.1, 1e-9);
+
+		FrameTimer::Stop();
+		CHECK_NEAR(tsk->duration, 0.07, 1e-9);
+		FrameTimer::Update(1.0);
+		CHECK(log.runs.empty());
+
+		FrameTimer::Start();
+		FrameTimer::Update(0.06);
+		CHECK(log.runs.empty());
+		FrameTimer::Update(0.02);
+		CHECK(log.runs.size() == 1);
+	}
+
+	//Tick() measures wall time between calls, but time spent stopped or paused doesn't count & a long stall is clamped.
+	void TickSkipsStallsAndStoppedTime()
+	{
+		FreshFrameTimer f;
+		RunLog log;
+		AddTask(log, 1, 100);
+
+		FrameTimer::Stop();
+		std::this_thread::sleep_for(std::chrono::milliseconds(150));
+		FrameTimer::Start();
+		FrameTimer::Tick();
+		CHECK(log.runs.empty());
+
+		FrameTimer::SetPaused(true);
+		std::this_thread::sleep_for(std::chrono::milliseconds(150));
+		FrameTimer::SetPaused(false);
+		FrameTimer::Tick();
+		CHECK(log.runs.empty());
+
+		AddTask(log, 2, FRAME_TIMER_MAX_DELTA * 1000.0 + 100.0);
+		std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(FRAME_TIMER_MAX_DELTA * 1000.0) + 200));
+		FrameTimer::Tick();
+		CHECK((log.runs == std::vector<int>{ 1 }));
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(110));
+		FrameTimer::Tick();
+		CHECK((log.runs == std::vector<int>{ 1, 2 }));
+	}
+
+	void ContainersStartFrameTasksByDomain()
+	{
+		FreshFrameTimer f;
+		RunLog log;
+		{
+			TaskContainer container(TimerDomain::kGameFrame);
+			container.Start("a", TimedTask::MakeTask(std::make_shared<LogFunctor>(&log, 1), 10));
+			container.Start("b", TimedTask::MakeTask(std::make_shared<LogFunctor>(&log, 2), 10));
+			CHECK(FrameTimer::state->timedTasks.size() == 2);
+			CHECK(TimerThread::GetSingleton()->state->timedTasks.empty());
+			container.Stop("a");
+			FrameTimer::Update(0.02);
+			CHECK((log.runs == std::vector<int>{ 2 }));
+
+			container.Start("c", TimedTask::MakeTask(std::make_shared<LogFunctor>(&log, 3), 10));
+		}
+		CHECK(FrameTimer::state->timedTasks.empty());
+		FrameTimer::Update(0.02);
+		CHECK((log.runs == std::vector<int>{ 2 }));
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "RunsOnUpdateInDeadlineOrder", RunsOnUpdateInDeadlineOrder },
+		{ "MenuModeFreezesFrameClock", MenuModeFreezesFrameClock },
+		{ "RepeatsRunOncePerFrameAtMost", RepeatsRunOncePerFrameAtMost },
+		{ "TasksCanChangeOtherTasks", TasksCanChangeOtherTasks },
+		{ "TimeScaleChangesKeepElapsedTime", TimeScaleChangesKeepElapsedTime },
+		{ "StopAndSnapshotKeepRemainingTime", StopAndSnapshotKeepRemainingTime },
+		{ "TickSkipsStallsAndStoppedTime", TickSkipsStallsAndStoppedTime },
+		{ "ContainersStartFrameTasksByDomain", ContainersStartFrameTasksByDomain },
+	});
+}
@@ -0,0 +1,148 @@
+#include "TestPCH.h"
+#include "FaceAnimation/PackedFormat.h"
+#include "FaceAnimCorpus.h"
+
+namespace
+{
+	using namespace FaceAnimation;
+
+	bool SameRuntimeData(const AnimationData& a, const AnimationData& b)
+	{
+		if (a.duration != b.duration || a.timelines.size() != b.timelines.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < a.timelines.size(); i++) {
+			auto& x = a.timelines[i];
+			auto& y = b.timelines[i];
+			if (x.morph != y.morph || x.isEyes != y.isEyes || x.times != y.times || x.eases != y.eases || x.values != y.values || x.eyes != y.eyes) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	FrameBasedAnimData SingleTimeline(uint8_t morph)
+	{
+		FrameBasedAnimData d;
+		auto tl = d.MakeTimeline(morph);
+		tl->keys[0].value = 0.5f;
+		tl->keys[10].value = 0.25f;
+		return d;
+	}
+
+	//Decoding must give exactly what converting the frame data used to, including raw values & eyes.
+	void DecodeMatchesRuntimeData()
+	{
+		size_t mismatches = 0;
+		for (auto& d : Corpus::MakeFaceAnims(500)) {
+			AnimationData decoded;
+			mismatches += !PackedFormat::Decode(PackedFormat::Encode(d), decoded) || !SameRuntimeData(decoded, d.ToRuntimeData());
+		}
+		CHECK(mismatches == 0);
+	}
+
+	void ValuesAreQuantizedOnlyWhenExact()
+	{
+		auto d = SingleTimeline(3);
+		const size_t hundredths = PackedFormat::Encode(d).size();
+		d.timelines[0].keys[10].value = 0.123456f;
+		const size_t raw = PackedFormat::Encode(d).size();
+		CHECK(hundredths < raw);
+
+		AnimationData decoded;
+		CHECK(PackedFormat::Decode(PackedFormat::Encode(d), decoded));
+		CHECK(decoded.timelines[0].values[1] == 0.123456f);
+	}
+
+	void OutOfRangeMorphsAreRejected()
+	{
+		AnimationData decoded;
+		CHECK(PackedFormat::Decode(PackedFormat::Encode(SingleTimeline(FACEANIM_MORPH_COUNT - 1)), decoded));
+		CHECK(!PackedFormat::Decode(PackedFormat::Encode(SingleTimeline(FACEANIM_MORPH_COUNT)), decoded));
+		CHECK(!PackedFormat::Decode(PackedFormat::Encode(SingleTimeline(UINT8_MAX)), decoded));
+	}
+
+	void UnknownEasesAreRejected()
+	{
+		auto d = SingleTimeline(3);
+		d.timelines[0].keys[10].ease = static_cast<Easing::Function>(Easing::EaseFunctions.size() - 1);
+		AnimationData decoded;
+		CHECK(PackedFormat::Decode(PackedFormat::Encode(d), decoded));
+		d.timelines[0].keys[10].ease = static_cast<Easing::Function>(Easing::EaseFunctions.size());
+		CHECK(!PackedFormat::Decode(PackedFormat::Encode(d), decoded));
+	}
+
+	void TruncatedDataIsRejected()
+	{
+		for (auto& d : Corpus::MakeFaceAnims(50)) {
+			const std::string data = PackedFormat::Encode(d);
+			size_t accepted = 0;
+			for (size_t n = 0; n < data.size(); n++) {
+				AnimationData decoded;
+				accepted += PackedFormat::Decode(std::string_view(data).substr(0, n), decoded);
+			}
+			CHECK(accepted == 0);
+		}
+	}
+
+	//Corrupt data may decode to garbage, but only to in range morphs & eases, & never past the end of the data.
+	void CorruptDataStaysInRange()
+	{
+		std::mt19937 rng(5);
+		for (auto& d : Corpus::MakeFaceAnims(200)) {
+			std::string data = PackedFormat::Encode(d);
+			for (size_t k = 0; k < 8; k++) {
+				data[rng() % data.size()] = static_cast<char>(rng());
+			}
+			AnimationData decoded;
+			if (PackedFormat::Decode(data, decoded)) {
+				for (auto& tl : decoded.timelines) {
+					CHECK(tl.morph < FACEANIM_MORPH_COUNT);
+					CHECK(tl.eases.size() == tl.size());
+					CHECK(std::all_of(tl.eases.begin(), tl.eases.end(), [](auto e) { return e < Easing::EaseFunctions.size(); }));
+					CHECK((tl.isEyes ? tl.eyes.size() : tl.values.size()) == tl.size());
+				}
+			}
+		}
+	}
+
+	void VarintsRoundTrip()
+	{
+		PackedFormat::Writer w;
+		const std::array<uint64_t, 6> unsignedValues{ 0, 1, 127, 128, 1ull << 35, UINT64_MAX };
+		const std::array<int64_t, 6> signedValues{ 0, -1, 1, -64, 64, INT64_MIN };
+		for (auto v : unsignedValues) {
+			w.Varint(v);
+		}
+		for (auto v : signedValues) {
+			w.SignedVarint(v);
+		}
+
+		PackedFormat::Reader r(w.buffer);
+		for (auto v : unsignedValues) {
+			uint64_t out;
+			CHECK(r.Varint(out) && out == v);
+		}
+		for (auto v : signedValues) {
+			int64_t out;
+			CHECK(r.SignedVarint(out) && out == v);
+		}
+		CHECK(r.Remaining() == 0);
+
+		uint64_t out;
+		CHECK(!PackedFormat::Reader(std::string(11, '\xFF')).Varint(out));
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "DecodeMatchesRuntimeData", DecodeMatchesRuntimeData },
+		{ "ValuesAreQuantizedOnlyWhenExact", ValuesAreQuantizedOnlyWhenExact },
+		{ "OutOfRangeMorphsAreRejected", OutOfRangeMorphsAreRejected },
+		{ "UnknownEasesAreRejected", UnknownEasesAreRejected },
+		{ "TruncatedDataIsRejected", TruncatedDataIsRejected },
+		{ "CorruptDataStaysInRange", CorruptDataStaysInRange },
+		{ "VarintsRoundTrip", VarintsRoundTrip },
+	});
+}
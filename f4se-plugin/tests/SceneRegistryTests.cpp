@@ -0,0 +1,141 @@
+#include "TestPCH.h"
+#include "Scene/SceneRegistry.h"
+
+namespace Scene
+{
+	//Only its identity matters to the registry.
+	class IScene
+	{
+	public:
+		IScene(uint64_t a_uid) :
+			uid(a_uid) {}
+
+		uint64_t uid;
+	};
+}
+
+namespace
+{
+	using namespace Scene;
+
+	void InsertGetRemove()
+	{
+		SceneRegistry registry;
+		CHECK(!SceneHandle().QValid());
+		CHECK(registry.Get(SceneHandle()) == nullptr);
+
+		auto a = std::make_shared<IScene>(1);
+		auto b = std::make_shared<IScene>(2);
+		auto ha = registry.Insert(a);
+		auto hb = registry.Insert(b);
+		CHECK(ha.QValid() && hb.QValid());
+		CHECK(registry.Get(ha) == a.get());
+		CHECK(registry.Get(hb) == b.get());
+		CHECK(registry.QScenes().size() == 2);
+
+		CHECK(registry.Remove(ha) == a);
+		CHECK(registry.Get(ha) == nullptr);
+		CHECK(registry.Get(hb) == b.get());
+		CHECK((registry.QScenes() == std::vector<std::shared_ptr<IScene>>{ b }));
+	}
+
+	//A reused slot gets a new generation, so handles to the scene that used to be there stay dead.
+	void StaleHandlesStayDeadAfterReuse()
+	{
+		SceneRegistry registry;
+		auto a = std::make_shared<IScene>(1);
+		auto ha = registry.Insert(a);
+		registry.Remove(ha);
+
+		auto b = std::make_shared<IScene>(2);
+		auto hb = registry.Insert(b);
+		CHECK(hb.index == ha.index);
+		CHECK(hb.generation != ha.generation);
+		CHECK(registry.Get(ha) == nullptr);
+		CHECK(registry.Remove(ha) == nullptr);
+		CHECK(registry.Get(hb) == b.get());
+		CHECK(registry.Get({ 1000, 0 }) == nullptr);
+	}
+
+	//Random attaches & detaches keep the dense array holding exactly the live scenes, each reachable through its handle.
+	void DenseArrayTracksLiveScenes()
+	{
+		SceneRegistry registry;
+		std::mt19937 rng(11);
+		std::unordered_map<uint64_t, std::pair<SceneHandle, std::shared_ptr<IScene>>> live;
+		uint64_t nextUid = 1;
+		for (size_t step = 0; step < 5000; step++) {
+			if (live.empty() || rng() % 3 != 0) {
+				auto scn = std::make_shared<IScene>(nextUid);
+				live[nextUid++] = { registry.Insert(scn), scn };
+			} else {
+				auto iter = std::next(live.begin(), rng() % live.size());
+				CHECK(registry.Remove(iter->second.first) == iter->second.second);
+				live.erase(iter);
+			}
+		}
+
+		CHECK(registry.QScenes().size() == live.size());
+		std::unordered_set<uint64_t> dense;
+		for (auto& s : registry.QScenes()) {
+			dense.insert(s->uid);
+		}
+		CHECK(dense.size() == live.size());
+		for (auto& [uid, entry] : live) {
+			CHECK(dense.contains(uid));
+			CHECK(registry.Get(entry.first) == entry.second.get());
+		}
+	}
+
+	void VersionChangesOnlyWithScenes()
+	{
+		SceneRegistry registry;
+		auto v = registry.QVersion();
+		auto h = registry.Insert(std::make_shared<IScene>(1));
+		CHECK(registry.QVersion() > v);
+
+		v = registry.QVersion();
+		registry.Get(h);
+		registry.QScenes();
+		CHECK(registry.QVersion() == v);
+
+		registry.Remove(h);
+		CHECK(registry.QVersion() > v);
+		v = registry.QVersion();
+		registry.Remove(h);
+		CHECK(registry.QVersion() == v);
+
+		registry.Clear();
+		CHECK(registry.QVersion() > v);
+	}
+
+	void ClearKillsEveryHandle()
+	{
+		SceneRegistry registry;
+		std::vector<SceneHandle> handles;
+		for (uint64_t i = 0; i < 10; i++) {
+			handles.push_back(registry.Insert(std::make_shared<IScene>(i)));
+		}
+		registry.Remove(handles[3]);
+		registry.Clear();
+		CHECK(registry.QScenes().empty());
+		for (auto& h : handles) {
+			CHECK(registry.Get(h) == nullptr);
+		}
+
+		auto h = registry.Insert(std::make_shared<IScene>(20));
+		CHECK(registry.Get(h)->uid == 20);
+		CHECK(registry.QScenes().size() == 1);
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "InsertGetRemove", InsertGetRemove },
+		{ "StaleHandlesStayDeadAfterReuse", StaleHandlesStayDeadAfterReuse },
+		{ "DenseArrayTracksLiveScenes", DenseArrayTracksLiveScenes },
+		{ "VersionChangesOnlyWithScenes", VersionChangesOnlyWithScenes },
+		{ "ClearKillsEveryHandle", ClearKillsEveryHandle },
+	});
+}
@@ -0,0 +1,494 @@
+//The replaced operator delete frees with std::free, which GCC flags wherever it's inlined next to an operator new.
+#if defined(__GNUC__) && !defined(__clang__)
+#	pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+#include "TestPCH.h"
+#include "Misc/Easing.h"
+#include "Serialization/General.h"
+
+//The real ActionSet parses itself from XML, which isn't needed to store or serialize one.
+namespace Data
+{
+	struct ActionSet : public std::vector<std::string>
+	{
+	};
+}
+
+#include "Scene/Types.h"
+#include "Scene/UpdatePlan.h"
+
+//Counts heap allocations made while counting is set, to check which operations stay off the heap.
+namespace
+{
+	bool countAllocs = false;
+	size_t allocCount = 0;
+}
+
+void* operator new(size_t size)
+{
+	if (countAllocs) {
+		allocCount++;
+	}
+	if (void* p = std::malloc(size > 0 ? size : 1); p != nullptr) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+void* operator new(size_t size, std::align_val_t align)
+{
+	if (countAllocs) {
+		allocCount++;
+	}
+	const size_t alignment = static_cast<size_t>(align);
+	if (void* p = std::aligned_alloc(alignment, (std::max(size, alignment) + alignment - 1) & ~(alignment - 1)); p != nullptr) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+	std::free(p);
+}
+
+namespace
+{
+	using namespace Scene;
+
+	//The layouts ActorPropertyMap & SceneActorsMap replaced, as older co-saves contain them.
+	typedef std::unordered_map<PropType, ActorProperty> OldPropertyMap;
+	typedef std::unordered_map<SerializableActorHandle, OldPropertyMap> OldActorsMap;
+
+	F4SE::SerializationInterface intfc;
+	RE::TESIdleForm idle;
+	std::array<RE::Actor, 10> actors;
+
+	void SetupWorld()
+	{
+		Serialization::General::s_intfc = &intfc;
+		RE::MockWorld::Clear();
+		idle.formID = 0x100;
+		RE::MockWorld::Register(&idle);
+		for (size_t i = 0; i < actors.size(); i++) {
+			actors[i].formID = 0x200 + static_cast<uint32_t>(i);
+			RE::MockWorld::Register(&actors[i]);
+		}
+	}
+
+	SerializableActorHandle Handle(size_t actor)
+	{
+		return RE::BSPointerHandle<RE::Actor>(RE::BSUntypedPointerHandle(actors[actor].formID));
+	}
+
+	template <typename T>
+	std::string Save(const T& data)
+	{
+		intfc.record.clear();
+		Serialization::General::SaveRecord("test", data);
+		return intfc.record;
+	}
+
+	template <typename T>
+	bool Load(const std::string& record, T& dataOut)
+	{
+		intfc.record = record;
+		intfc.readPos = 0;
+		return Serialization::General::LoadRecord("test", dataOut);
+	}
+
+	//One property of every alternative, including the out of line ones.
+	std::vector<std::pair<PropType, ActorPropertyValue>> SampleProperties(uint64_t order)
+	{
+		Data::ActionSet actions;
+		actions.push_back("actionA");
+		actions.push_back("actionB");
+		return {
+			{ kIdle, SerializableIdle(&idle) },
+			{ kScale, 1.25f },
+			{ kSynced, true },
+			{ kFaceAnim, "face_happy"s },
+			{ kOrder, order },
+			{ kAction, actions },
+			{ kOffset, std::pair<RE::NiPoint3, float>{ { 1.0f, 2.0f, 3.0f }, 90.0f } },
+		};
+	}
+
+	void OldPropertiesLoad()
+	{
+		SetupWorld();
+		OldPropertyMap old;
+		for (auto& p : SampleProperties(3)) {
+			old[p.first] = ActorProperty{ p.second };
+		}
+
+		ActorPropertyMap loaded;
+		CHECK(Load(Save(old), loaded));
+		CHECK(loaded.size() == old.size());
+		for (auto& p : SampleProperties(3)) {
+			CHECK(loaded.contains(p.first));
+			CHECK(loaded.get(p.first) == p.second);
+		}
+		CHECK(loaded.get<SerializableIdle>(kIdle).value().get() == &idle);
+		CHECK(loaded.get<std::string>(kFaceAnim) == "face_happy"s);
+		CHECK(!loaded.contains(kStartEquipSet));
+	}
+
+	void NewPropertiesLoadAsOld()
+	{
+		SetupWorld();
+		ActorPropertyMap props;
+		for (auto& p : SampleProperties(1)) {
+			props.set(p.first, p.second);
+		}
+
+		OldPropertyMap old;
+		CHECK(Load(Save(props), old));
+		CHECK(old.size() == props.size());
+		for (auto& p : SampleProperties(1)) {
+			CHECK(old.contains(p.first) && old[p.first].value == p.second);
+		}
+	}
+
+	//Map order is unspecified, so only saves of a single property can be compared byte for byte.
+	void SinglePropertySavesMatch()
+	{
+		SetupWorld();
+		for (auto& p : SampleProperties(2)) {
+			OldPropertyMap old;
+			old[p.first] = ActorProperty{ p.second };
+			ActorPropertyMap props;
+			props.set(p.first, p.second);
+			CHECK(Save(old) == Save(props));
+		}
+		CHECK(Save(OldPropertyMap()) == Save(ActorPropertyMap()));
+	}
+
+	void UnknownPropertiesAreSkipped()
+	{
+		SetupWorld();
+		OldPropertyMap old;
+		old[kScale] = ActorProperty{ 0.5f };
+		old[static_cast<PropType>(PropTypeCount + 3)] = ActorProperty{ true };
+
+		ActorPropertyMap loaded;
+		CHECK(Load(Save(old), loaded));
+		CHECK(loaded.size() == 1);
+		CHECK(loaded.get<float>(kScale) == 0.5f);
+	}
+
+	void PropertyAccess()
+	{
+		ActorPropertyMap props;
+		props.set(kScale, 2.0f);
+		CHECK(props.get<float>(kScale) == 2.0f);
+		CHECK(!props.get<bool>(kScale).has_value());
+		CHECK(!props.get<float>(kSynced).has_value());
+
+		props.set(kScale, "text"s);
+		CHECK(props.get<std::string>(kScale) == "text"s);
+		CHECK(!props.get<float>(kScale).has_value());
+
+		props.erase(kScale);
+		CHECK(!props.contains(kScale));
+		CHECK(props.size() == 0);
+	}
+
+	void MovedFromPropertiesCopySafely()
+	{
+		ActorPropertyMap props;
+		props.set(kFaceAnim, "face"s);
+		props.set(kScale, 1.0f);
+
+		ActorPropertyMap moved(std::move(props));
+		CHECK(moved.get<std::string>(kFaceAnim) == "face"s);
+		CHECK(props.size() == 0);
+
+		ActorPropertyMap copy = props;
+		CHECK(copy.size() == 0);
+		copy.set(kFaceAnim, "other"s);
+		CHECK(copy.get<std::string>(kFaceAnim) == "other"s);
+
+		ActorPropertyMap assigned;
+		assigned = std::move(moved);
+		copy = moved;
+		CHECK(copy.size() == 0);
+		CHECK(assigned.get<std::string>(kFaceAnim) == "face"s);
+	}
+
+	OldActorsMap OldScene(size_t count)
+	{
+		OldActorsMap old;
+		for (size_t i = 0; i < count; i++) {
+			auto& props = old[Handle(i)];
+			props[kOrder] = ActorProperty{ static_cast<uint64_t>(i) };
+			props[kScale] = ActorProperty{ static_cast<float>(i) };
+		}
+		return old;
+	}
+
+	//Old saves list actors in hash order, loading must put them back in kOrder.
+	void OldActorsLoadInOrder()
+	{
+		SetupWorld();
+		for (size_t count : { 1, 4, SCENE_INLINE_ACTORS, SCENE_INLINE_ACTORS + 3 }) {
+			SceneActorsMap loaded;
+			CHECK(Load(Save(OldScene(count)), loaded));
+			CHECK(loaded.size() == count);
+
+			size_t i = 0;
+			for (auto& e : loaded) {
+				CHECK(e.first == Handle(i));
+				CHECK(e.second.get<uint64_t>(kOrder) == i);
+				CHECK(e.second.get<float>(kScale) == static_cast<float>(i));
+				i++;
+			}
+
+			auto inOrder = GetActorsInOrder(loaded);
+			for (size_t j = 0; j < count; j++) {
+				CHECK(inOrder[j].get() == &actors[j]);
+			}
+		}
+	}
+
+	void NewActorsLoadAsOld()
+	{
+		SetupWorld();
+		SceneActorsMap scene;
+		for (size_t i = 0; i < SCENE_INLINE_ACTORS + 2; i++) {
+			scene[Handle(i)].set(kOrder, static_cast<uint64_t>(i));
+		}
+
+		OldActorsMap old;
+		CHECK(Load(Save(scene), old));
+		CHECK(old.size() == scene.size());
+		for (size_t i = 0; i < scene.size(); i++) {
+			CHECK(old.contains(Handle(i)) && old[Handle(i)][kOrder].value == ActorPropertyValue(static_cast<uint64_t>(i)));
+		}
+
+		auto single = OldScene(1);
+		SceneActorsMap singleScene;
+		singleScene[Handle(0)].set(kOrder, uint64_t{ 0 });
+		singleScene[Handle(0)].set(kScale, 0.0f);
+		CHECK(Save(singleScene) == Save(single));
+	}
+
+	//Actors whose form is gone by the time of loading keep their slot with an empty handle, as before.
+	void MissingActorsLoadEmpty()
+	{
+		SetupWorld();
+		auto record = Save(OldScene(2));
+		intfc.remappedIDs[actors[1].formID] = 0;
+
+		SceneActorsMap loaded;
+		CHECK(Load(record, loaded));
+		CHECK(loaded.size() == 2);
+		CHECK(loaded.begin()->first == Handle(0));
+		CHECK(!(loaded.begin() + 1)->first);
+		intfc.remappedIDs.clear();
+	}
+
+	void ActorsSpillInOrder()
+	{
+		SetupWorld();
+		SceneActorsMap scene;
+		for (size_t i = 0; i < actors.size(); i++) {
+			auto [iter, inserted] = scene.insert({ Handle(i), ActorPropertyMap() });
+			CHECK(inserted);
+			iter->second.set(kOrder, static_cast<uint64_t>(i));
+		}
+		CHECK(!scene.insert({ Handle(3), ActorPropertyMap() }).second);
+		CHECK(scene.size() == actors.size());
+
+		size_t i = 0;
+		for (auto& e : scene) {
+			CHECK(e.first == Handle(i));
+			CHECK(e.second.get<uint64_t>(kOrder) == i);
+			i++;
+		}
+		CHECK(scene.find(Handle(8)) == scene.begin() + 8);
+		CHECK(scene[Handle(5)].get<uint64_t>(kOrder) == 5u);
+
+		SceneActorsMap copy = scene;
+		scene.clear();
+		CHECK(scene.empty() && scene.begin() == scene.end());
+		CHECK(copy.size() == actors.size());
+		CHECK(copy.contains(Handle(9)));
+
+		scene[Handle(0)].set(kScale, 1.0f);
+		CHECK(scene.size() == 1);
+		CHECK(scene.begin()->second.get<float>(kScale) == 1.0f);
+	}
+
+	void MovedFromActorsCopySafely()
+	{
+		SetupWorld();
+		SceneActorsMap scene;
+		scene[Handle(0)].set(kFaceAnim, "face"s);
+
+		SceneActorsMap moved(std::move(scene));
+		SceneActorsMap copy = scene;
+		CHECK(moved.begin()->second.get<std::string>(kFaceAnim) == "face"s);
+		for (auto& e : copy) {
+			CHECK(!e.second.get<std::string>(kFaceAnim).has_value());
+		}
+	}
+
+	//Lookups, iteration & adding actors while the scene fits inline shouldn't touch the heap, neither should properties
+	//that are stored inline.
+	void InlineOperationsDontAllocate()
+	{
+		SetupWorld();
+		SceneActorsMap scene;
+		std::array<SerializableActorHandle, SCENE_INLINE_ACTORS> handles;
+		for (size_t i = 0; i < handles.size(); i++) {
+			handles[i] = Handle(i);
+		}
+
+		allocCount = 0;
+		countAllocs = true;
+		for (size_t i = 0; i < handles.size(); i++) {
+			auto& props = scene[handles[i]];
+			props.set(kOrder, static_cast<uint64_t>(i));
+			props.set(kScale, 1.0f);
+			props.set(kSynced, false);
+		}
+		uint64_t total = 0;
+		for (auto& e : scene) {
+			total += e.second.get<uint64_t>(kOrder).value_or(0);
+		}
+		for (auto& h : handles) {
+			total += scene.find(h)->second.get<float>(kScale).has_value();
+			total += scene.contains(h);
+		}
+		countAllocs = false;
+
+		CHECK(allocCount == 0);
+		CHECK(total == 15 + 2 * SCENE_INLINE_ACTORS);
+
+		countAllocs = true;
+		scene[Handle(SCENE_INLINE_ACTORS)];
+		countAllocs = false;
+		CHECK(allocCount == 1);
+	}
+
+	//One frame of a scene update without the game calls: gathering walks the actors & reads their offsets into the plan's
+	//placements, computing works out targets & anim speeds, applying rechecks & clears them.
+	void RunUpdatePhases(SceneActorsMap& scene, UpdatePlan& plan, std::vector<LocalSyncInfo>& syncInfoVec)
+	{
+		plan.placements.clear();
+		size_t synced = 0;
+		for (size_t i = 0; i < scene.size(); i++) {
+			auto& a = scene.begin()[i];
+			auto actor = a.first.get();
+			if (actor == nullptr) {
+				continue;
+			}
+			auto& info = syncInfoVec[synced++];
+			info.actor = actor;
+			info.currentAnimTime = 0.5f + 0.1f * static_cast<float>(i);
+			info.totalAnimTime = 2.0f;
+			info.oldMult = 100.0f;
+
+			auto& p = plan.placements.emplace_back();
+			p.actor = actor;
+			p.index = i;
+			p.currentLocation = actor->data.location;
+			p.currentAngle = actor->data.angle;
+			p.offset = GetProperty<std::pair<RE::NiPoint3, float>>(a.second, kOffset);
+		}
+		plan.smoothSync = true;
+		plan.minTime = 0.5f;
+		plan.baseTotalTime = 2.0f;
+
+		plan.ComputeSmoothSync(syncInfoVec);
+		plan.ComputePlacements();
+
+		const bool sceneMoved = plan.MoveScene(plan.location, plan.angle);
+		for (auto& p : plan.placements) {
+			auto& a = scene.begin()[p.index];
+			plan.Recheck(p, sceneMoved, p.actor->data.location, p.actor->data.angle, GetProperty<std::pair<RE::NiPoint3, float>>(a.second, kOffset));
+			if (p.moveLocation) {
+				p.actor->data.location = p.targetLocation;
+			}
+		}
+		plan.placements.clear();
+	}
+
+	//Once the plan's vectors have grown to the scene's size, a frame of updates doesn't touch the heap.
+	void UpdatePhasesDontAllocate()
+	{
+		SetupWorld();
+		SceneActorsMap scene;
+		for (size_t i = 0; i < 4; i++) {
+			auto& props = scene[Handle(i)];
+			props.set(kOrder, static_cast<uint64_t>(i));
+			if (i % 2 == 0) {
+				props.set(kOffset, std::pair<RE::NiPoint3, float>{ { 10.0f * static_cast<float>(i), 0.0f, 0.0f }, 0.5f });
+			}
+		}
+		UpdatePlan plan;
+		plan.location = { 100.0f, 200.0f, 0.0f };
+		std::vector<LocalSyncInfo> syncInfoVec(scene.size());
+		RunUpdatePhases(scene, plan, syncInfoVec);
+
+		allocCount = 0;
+		countAllocs = true;
+		for (size_t f = 0; f < 100; f++) {
+			RunUpdatePhases(scene, plan, syncInfoVec);
+		}
+		countAllocs = false;
+		CHECK(allocCount == 0);
+		CHECK((actors[2].data.location == RE::NiPoint3{ 80.0f, 200.0f, 0.0f }));
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "OldPropertiesLoad", OldPropertiesLoad },
+		{ "NewPropertiesLoadAsOld", NewPropertiesLoadAsOld },
+		{ "SinglePropertySavesMatch", SinglePropertySavesMatch },
+		{ "UnknownPropertiesAreSkipped", UnknownPropertiesAreSkipped },
+		{ "PropertyAccess", PropertyAccess },
+		{ "MovedFromPropertiesCopySafely", MovedFromPropertiesCopySafely },
+		{ "OldActorsLoadInOrder", OldActorsLoadInOrder },
+		{ "NewActorsLoadAsOld", NewActorsLoadAsOld },
+		{ "MissingActorsLoadEmpty", MissingActorsLoadEmpty },
+		{ "ActorsSpillInOrder", ActorsSpillInOrder },
+		{ "MovedFromActorsCopySafely", MovedFromActorsCopySafely },
+		{ "InlineOperationsDontAllocate", InlineOperationsDontAllocate },
+		{ "UpdatePhasesDontAllocate", UpdatePhasesDontAllocate },
+	});
+}
@@ -0,0 +1,293 @@
+#include "TestPCH.h"
+#include "Misc/Easing.h"
+#include "Misc/WorkerPool.h"
+#include "Scene/UpdatePlan.h"
+
+namespace
+{
+	using namespace Scene;
+
+	struct MockActor
+	{
+		RE::Actor actor;
+		std::optional<std::pair<RE::NiPoint3, float>> offset;
+		float currentAnimTime = 0.0f;
+		float totalAnimTime = 0.0f;
+		float mult = 100.0f;
+	};
+
+	//The parts of a scene that its update reads & writes.
+	struct MockScene
+	{
+		RE::NiPoint3 location;
+		RE::NiPoint3 angle;
+		float animMult = 100.0f;
+		float diffLimit = 5.0f;
+		float basicallyFullSpeed = 99.99f;
+		bool synced = false;
+		std::vector<MockActor> actors;
+		std::vector<LocalSyncInfo> syncInfoVec;
+		UpdatePlan plan;
+	};
+
+	MockScene MakeScene(std::mt19937& rng, size_t actorCount)
+	{
+		std::uniform_real_distribution<float> coord(-5000.0f, 5000.0f);
+		std::uniform_real_distribution<float> radian(0.0f, 6.28f);
+		std::uniform_real_distribution<float> time(0.05f, 2.0f);
+		MockScene scn;
+		scn.location = { coord(rng), coord(rng), coord(rng) };
+		scn.angle = { 0.0f, 0.0f, radian(rng) };
+		scn.actors.resize(actorCount);
+		const float total = (rng() % 4 == 0) ? 3.0f : 2.0f;
+		for (auto& a : scn.actors) {
+			//Some actors are already in place, so that both sides of the within-error checks are covered.
+			if (rng() % 3 == 0) {
+				a.actor.data.location = scn.location;
+				a.actor.data.angle = scn.angle;
+			} else {
+				a.actor.data.location = RE::NiPoint3{ coord(rng), coord(rng), coord(rng) };
+				a.actor.data.angle = RE::NiPoint3{ 0.0f, 0.0f, radian(rng) };
+			}
+			if (rng() % 2 == 0) {
+				a.offset = std::pair<RE::NiPoint3, float>{ { coord(rng) / 50.0f, coord(rng) / 50.0f, 0.0f }, radian(rng) };
+			}
+			a.currentAnimTime = time(rng);
+			a.totalAnimTime = (rng() % 8 == 0) ? 3.0f : total;
+			a.mult = 95.0f + static_cast<float>(rng() % 10);
+		}
+		return scn;
+	}
+
+	//The update as it was before it was split into phases, all in one pass over the actors.
+	void SequentialUpdate(MockScene& scn)
+	{
+		float minTime = scn.actors[0].currentAnimTime;
+		const float baseTotalTime = scn.actors[0].totalAnimTime;
+		for (auto& a : scn.actors) {
+			minTime = std::min(minTime, a.currentAnimTime);
+		}
+
+		bool allFullSpeed = true;
+		for (auto& a : scn.actors) {
+			if (a.totalAnimTime != baseTotalTime) {
+				allFullSpeed = true;
+				break;
+			}
+			float mult = std::clamp(scn.animMult * (minTime / a.currentAnimTime), a.mult - scn.diffLimit, a.mult + scn.diffLimit);
+			a.mult = mult;
+			if (mult < scn.basicallyFullSpeed) {
+				allFullSpeed = false;
+			}
+		}
+		scn.synced = allFullSpeed;
+
+		for (auto& a : scn.actors) {
+			RE::NiPoint3 actorLoc = scn.location;
+			RE::NiPoint3 actorAngle = scn.angle;
+			if (a.offset.has_value()) {
+				MathUtil::ApplyOffsetToLocalSpace(actorLoc, a.offset->first, actorAngle.z);
+				actorAngle.z += a.offset->second;
+				MathUtil::ConstrainRadian(actorAngle.z);
+			}
+			if (!MathUtil::CoordsWithinError(a.actor.data.angle, actorAngle)) {
+				a.actor.data.angle = actorAngle;
+			}
+			if (!MathUtil::CoordsWithinError(a.actor.data.location, actorLoc)) {
+				a.actor.data.location = actorLoc;
+			}
+		}
+	}
+
+	//Copies what the compute phase needs, like SceneBase's GatherUpdate & GatherSmoothSync.
+	void Gather(MockScene& scn)
+	{
+		auto& plan = scn.plan;
+		plan.location = scn.location;
+		plan.angle = scn.angle;
+		plan.animMult = scn.animMult;
+		plan.diffLimit = scn.diffLimit;
+		plan.basicallyFullSpeed = scn.basicallyFullSpeed;
+
+		scn.syncInfoVec.clear();
+		plan.minTime = scn.actors[0].currentAnimTime;
+		plan.baseTotalTime = scn.actors[0].totalAnimTime;
+		for (auto& a : scn.actors) {
+			auto& info = scn.syncInfoVec.emplace_back();
+			info.actor.reset(&a.actor);
+			info.currentAnimTime = a.currentAnimTime;
+			info.totalAnimTime = a.totalAnimTime;
+			info.oldMult = a.mult;
+			plan.minTime = std::min(plan.minTime, a.currentAnimTime);
+		}
+		plan.smoothSync = true;
+
+		plan.placements.clear();
+		for (size_t i = 0; i < scn.actors.size(); i++) {
+			auto& a = scn.actors[i];
+			auto& p = plan.placements.emplace_back();
+			p.actor.reset(&a.actor);
+			p.index = i;
+			p.currentLocation = a.actor.data.location;
+			p.currentAngle = a.actor.data.angle;
+			p.offset = a.offset;
+		}
+	}
+
+	void Compute(MockScene& scn)
+	{
+		if (scn.plan.smoothSync) {
+			scn.plan.ComputeSmoothSync(scn.syncInfoVec);
+		}
+		scn.plan.ComputePlacements();
+	}
+
+	void Apply(MockScene& scn)
+	{
+		auto& plan = scn.plan;
+		for (size_t i = 0; i < plan.syncCount; i++) {
+			scn.actors[i].mult = scn.syncInfoVec[i].newMult;
+		}
+		scn.synced = plan.allFullSpeed;
+
+		const bool sceneMoved = plan.MoveScene(scn.location, scn.angle);
+		for (auto& p : plan.placements) {
+			auto& a = scn.actors[p.index];
+			plan.Recheck(p, sceneMoved, a.actor.data.location, a.actor.data.angle, a.offset);
+			if (p.moveAngle) {
+				a.actor.data.angle = p.targetAngle;
+			}
+			if (p.moveLocation) {
+				a.actor.data.location = p.targetLocation;
+			}
+		}
+		plan.placements.clear();
+	}
+
+	bool SameResult(const MockScene& a, const MockScene& b)
+	{
+		if (a.synced != b.synced || a.actors.size() != b.actors.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < a.actors.size(); i++) {
+			auto& x = a.actors[i];
+			auto& y = b.actors[i];
+			if (x.mult != y.mult || x.actor.data.location != y.actor.data.location || x.actor.data.angle != y.actor.data.angle) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<MockScene> MakeScenes(size_t count, uint32_t seed)
+	{
+		std::mt19937 rng(seed);
+		std::vector<MockScene> result;
+		for (size_t i = 0; i < count; i++) {
+			result.push_back(MakeScene(rng, 1 + rng() % 6));
+		}
+		return result;
+	}
+
+	//Gather, compute & apply give exactly the same anim speeds & positions as the single pass update did.
+	void PhasesMatchSequentialUpdate()
+	{
+		auto expected = MakeScenes(500, 3);
+		auto phased = expected;
+		for (auto& scn : expected) {
+			SequentialUpdate(scn);
+		}
+		for (auto& scn : phased) {
+			Gather(scn);
+			Compute(scn);
+			Apply(scn);
+		}
+		for (size_t i = 0; i < expected.size(); i++) {
+			CHECK(SameResult(expected[i], phased[i]));
+		}
+	}
+
+	//Computing every scene on the worker pool gives the same result as computing them one after another.
+	void ParallelComputeMatchesSequential()
+	{
+		auto expected = MakeScenes(300, 5);
+		auto parallel = expected;
+		for (auto& scn : expected) {
+			Gather(scn);
+			Compute(scn);
+			Apply(scn);
+		}
+
+		Misc::WorkerPool pool;
+		for (auto& scn : parallel) {
+			Gather(scn);
+		}
+		pool.ParallelFor(parallel.size(), [&](size_t i) { Compute(parallel[i]); }, 3);
+		for (auto& scn : parallel) {
+			Apply(scn);
+		}
+		for (size_t i = 0; i < expected.size(); i++) {
+			CHECK(SameResult(expected[i], parallel[i]));
+		}
+	}
+
+	//Changes made while the scene was unlocked for the compute phase are picked up before anything is applied.
+	void ApplyRechecksChangedInputs()
+	{
+		std::mt19937 rng(9);
+		for (int change = 0; change < 3; change++) {
+			auto scn = MakeScene(rng, 4);
+			scn.actors[1].offset = std::pair<RE::NiPoint3, float>{ { 10.0f, 0.0f, 0.0f }, 0.5f };
+			Gather(scn);
+			Compute(scn);
+
+			switch (change) {
+			case 0:
+				scn.location.x += 100.0f;
+				scn.angle.z += 0.25f;
+				break;
+			case 1:
+				scn.actors[1].offset = std::pair<RE::NiPoint3, float>{ { -20.0f, 5.0f, 1.0f }, 1.5f };
+				scn.actors[2].offset.reset();
+				break;
+			case 2:
+				scn.actors[3].actor.data.location = scn.location;
+				scn.actors[3].actor.data.angle = scn.angle;
+				scn.actors[3].offset.reset();
+				break;
+			}
+
+			auto expected = scn;
+			expected.plan = UpdatePlan();
+			SequentialUpdate(expected);
+			Apply(scn);
+			CHECK(SameResult(expected, scn));
+		}
+	}
+
+	void UnchangedPlacementsAreKept()
+	{
+		std::mt19937 rng(21);
+		auto scn = MakeScene(rng, 3);
+		Gather(scn);
+		Compute(scn);
+		auto& p = scn.plan.placements[0];
+		p.targetLocation = { 1.0f, 2.0f, 3.0f };
+
+		CHECK(!scn.plan.MoveScene(scn.location, scn.angle));
+		scn.plan.Recheck(p, false, scn.actors[0].actor.data.location, scn.actors[0].actor.data.angle, scn.actors[0].offset);
+		CHECK((p.targetLocation == RE::NiPoint3{ 1.0f, 2.0f, 3.0f }));
+		scn.plan.Recheck(p, true, scn.actors[0].actor.data.location, scn.actors[0].actor.data.angle, scn.actors[0].offset);
+		CHECK(!(p.targetLocation == RE::NiPoint3{ 1.0f, 2.0f, 3.0f }));
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "PhasesMatchSequentialUpdate", PhasesMatchSequentialUpdate },
+		{ "ParallelComputeMatchesSequential", ParallelComputeMatchesSequential },
+		{ "ApplyRechecksChangedInputs", ApplyRechecksChangedInputs },
+		{ "UnchangedPlacementsAreKept", UnchangedPlacementsAreKept },
+	});
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+//Timing helpers for the benchmark executables. Results are printed, never checked, so they don't fail on slow machines.
+namespace Bench
+{
+	inline volatile double sink = 0.0;
+
+	//Best average nanoseconds per iteration over a few rounds, so that one preempted round doesn't skew the result.
+	template <typename F>
+	double MeasureNs(size_t iterations, F&& func, int rounds = 5)
+	{
+		double best = std::numeric_limits<double>::max();
+		for (int r = 0; r < rounds; r++) {
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < iterations; i++) {
+				func(i);
+			}
+			const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+			best = std::min(best, ns / static_cast<double>(iterations));
+		}
+		return best;
+	}
+
+	inline double ElapsedMs(std::chrono::steady_clock::time_point since)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+//Minimal test runner. Each test executable lists its cases in main() & returns non-zero if any check failed.
+namespace Test
+{
+	inline int failures = 0;
+
+	inline void Fail(const char* file, int line, const std::string& what)
+	{
+		failures++;
+		std::fprintf(stderr, "%s(%d): check failed: %s\n", file, line, what.c_str());
+	}
+
+	inline int Run(std::initializer_list<std::pair<const char*, void (*)()>> cases)
+	{
+		for (auto& c : cases) {
+			const int before = failures;
+			try {
+				c.second();
+			} catch (std::exception& e) {
+				failures++;
+				std::fprintf(stderr, "%s: threw %s\n", c.first, e.what());
+			}
+			std::printf("%-48s %s\n", c.first, failures == before ? "ok" : "FAILED");
+		}
+		return failures == 0 ? 0 : 1;
+	}
+}
+
+#define CHECK(cond)                                     \
+	do {                                                \
+		if (!(cond)) {                                  \
+			Test::Fail(__FILE__, __LINE__, #cond);      \
+		}                                               \
+	} while (false)
+
+#define CHECK_NEAR(a, b, tolerance)                                                                                \
+	do {                                                                                                           \
+		const double checkA = static_cast<double>(a);                                                              \
+		const double checkB = static_cast<double>(b);                                                              \
+		if (!(std::abs(checkA - checkB) <= static_cast<double>(tolerance))) {                                      \
+			Test::Fail(__FILE__, __LINE__, std::format("{} == {} within {} ({} vs {})", #a, #b, #tolerance, checkA, checkB)); \
+		}                                                                                                          \
+	} while (false)
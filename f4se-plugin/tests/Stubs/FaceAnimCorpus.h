@@ -0,0 +1,104 @@
+#pragma once
+
+//Random face animations shaped like the ones the framework ships, for the face animation tests & benchmarks.
+//Include after FaceAnimation/AnimationData.h.
+namespace Corpus
+{
+	//Keyed on frames 0..duration at 30fps, with a few to a few dozen keys on up to FACEANIM_MORPH_COUNT morphs.
+	//Values are whole percentages, like the XML format stores them, except for an occasional raw float. Some have eyes.
+	inline std::vector<FaceAnimation::FrameBasedAnimData> MakeFaceAnims(size_t count, uint32_t seed = 7)
+	{
+		std::mt19937 rng(seed);
+		std::vector<FaceAnimation::FrameBasedAnimData> result;
+		result.reserve(count);
+		for (size_t a = 0; a < count; a++) {
+			FaceAnimation::FrameBasedAnimData d;
+			d.frameRate = 30;
+			d.duration = 30 + rng() % 600;
+			const size_t timelines = 4 + rng() % 20;
+			for (size_t t = 0; t < timelines; t++) {
+				FaceAnimation::FrameBasedTimeline tl;
+				tl.morph = static_cast<uint8_t>((t * 7 + a) % FACEANIM_MORPH_COUNT);
+				tl.isEyes = (t == 0 && rng() % 2 == 0);
+				const size_t keys = 2 + rng() % 30;
+				for (size_t k = 0; k < keys; k++) {
+					FaceAnimation::Keyframe kf;
+					kf.value = static_cast<float>(rng() % 101) * 0.01f;
+					kf.ease = static_cast<Easing::Function>(rng() % 4 == 0 ? rng() % Easing::EaseFunctions.size() : 0);
+					if (tl.isEyes) {
+						kf.eyesValue = { (rng() % 200) / 100.0 - 1.0, (rng() % 200) / 100.0 - 1.0 };
+					}
+					tl.keys[rng() % (d.duration + 1)] = kf;
+				}
+				if (a % 50 == 0 && t == 1) {
+					tl.keys.begin()->second.value = 0.123456f;
+				}
+				d.timelines.push_back(std::move(tl));
+			}
+			result.push_back(std::move(d));
+		}
+		return result;
+	}
+
+	//The std::map based timeline that AnimationTimeline replaced, evaluated the way it used to be, except for two float
+	//precision choices of the flat layout: keys are found by float time, with a key exactly at t starting the next segment
+	//(the map version ended the previous one there, with its curve at 1, which the Expo curves don't quite reach), and
+	//curves are evaluated at float normalized times, which only matters where the Circ curves are vertical.
+	class MapTimeline
+	{
+	public:
+		MapTimeline(const FaceAnimation::AnimationTimeline& tl)
+		{
+			for (size_t i = 0; i < tl.size(); i++) {
+				keys[tl.times[i]] = tl.GetKey(i);
+			}
+		}
+
+		float GetValueAtTime(double t) const
+		{
+			auto next = Next(t);
+			if (next == keys.end()) {
+				return std::prev(next)->second.value;
+			} else if (next == keys.begin() || keys.size() < 2) {
+				return next->second.value;
+			}
+			auto prev = std::prev(next);
+			return static_cast<float>(std::lerp(prev->second.value, next->second.value, Ease(t, prev, next)));
+		}
+
+		FaceAnimation::EyeVector GetEyesValueAtTime(double t) const
+		{
+			auto next = Next(t);
+			if (next == keys.end()) {
+				return std::prev(next)->second.eyesValue;
+			} else if (next == keys.begin() || keys.size() < 2) {
+				return next->second.eyesValue;
+			}
+			auto prev = std::prev(next);
+			const double e = Ease(t, prev, next);
+			return { std::lerp(prev->second.eyesValue.u, next->second.eyesValue.u, e), std::lerp(prev->second.eyesValue.v, next->second.eyesValue.v, e) };
+		}
+
+		//The estimate the old timeline reported, each map node holds 3 pointers & 2 flags alongside the value.
+		size_t QMemoryUsage() const
+		{
+			return keys.size() * (sizeof(std::pair<const double, FaceAnimation::Keyframe>) + (sizeof(void*) * 4));
+		}
+
+		std::map<double, FaceAnimation::Keyframe> keys;
+
+	private:
+		typedef std::map<double, FaceAnimation::Keyframe>::const_iterator KeyIter;
+
+		KeyIter Next(double t) const
+		{
+			return keys.upper_bound(static_cast<double>(static_cast<float>(t)));
+		}
+
+		static double Ease(double t, KeyIter prev, KeyIter next)
+		{
+			const float normalizedTime = static_cast<float>(std::clamp((t - prev->first) / (next->first - prev->first), 0.0, 1.0));
+			return Easing::Ease(static_cast<double>(normalizedTime), prev->second.ease);
+		}
+	};
+}
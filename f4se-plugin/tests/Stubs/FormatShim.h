@@ -0,0 +1,66 @@
+#pragma once
+
+//std::format for standard libraries that don't have <format> yet (libstdc++ before 13).
+//Only handles what the headers under test use: {} & {:<spec>} with an optional precision and an f or x type.
+#if __has_include(<format>)
+#	include <format>
+#else
+namespace std
+{
+	namespace FormatShim
+	{
+		template <typename T>
+		void Write(std::ostringstream& out, std::string_view spec, const T& arg)
+		{
+			out.unsetf(std::ios::floatfield);
+			out.unsetf(std::ios::basefield);
+			out.precision(6);
+			if (auto dot = spec.find('.'); dot != std::string_view::npos) {
+				out.precision(std::stoi(std::string(spec.substr(dot + 1))));
+			}
+			if (spec.ends_with('f')) {
+				out.setf(std::ios::fixed, std::ios::floatfield);
+			} else if (spec.ends_with('x')) {
+				out.setf(std::ios::hex, std::ios::basefield);
+			}
+
+			if constexpr (std::is_same_v<T, bool>) {
+				out << (arg ? "true" : "false");
+			} else if constexpr (std::is_integral_v<T> && sizeof(T) == 1) {
+				out << static_cast<int>(arg);
+			} else {
+				out << arg;
+			}
+		}
+	}
+
+	template <class... Args>
+	std::string format(std::string_view fmt, const Args&... args)
+	{
+		std::ostringstream out;
+		std::vector<std::function<void(std::string_view)>> writers{ [&](std::string_view spec) { FormatShim::Write(out, spec, args); }... };
+
+		size_t next = 0;
+		for (size_t i = 0; i < fmt.size(); i++) {
+			if (fmt[i] == '{' && i + 1 < fmt.size() && fmt[i + 1] == '{') {
+				out << '{';
+				i++;
+			} else if (fmt[i] == '}' && i + 1 < fmt.size() && fmt[i + 1] == '}') {
+				out << '}';
+				i++;
+			} else if (fmt[i] == '{') {
+				const size_t close = fmt.find('}', i);
+				std::string_view field = fmt.substr(i + 1, close - i - 1);
+				const size_t colon = field.find(':');
+				if (next < writers.size()) {
+					writers[next++](colon != std::string_view::npos ? field.substr(colon + 1) : std::string_view());
+				}
+				i = close;
+			} else {
+				out << fmt[i];
+			}
+		}
+		return out.str();
+	}
+}
+#endif
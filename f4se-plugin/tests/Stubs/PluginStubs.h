@@ -0,0 +1,85 @@
+#pragma once
+
+//Stand-ins for the parts of Misc/Utility.h & Misc/GameUtil.h used by the headers under test.
+//Those headers pull in Windows.h, ppl.h & Papyrus, so the few helpers needed are repeated here with the same behaviour.
+
+class Utility
+{
+public:
+	//Milliseconds, like the QueryPerformanceCounter based versions.
+	static int64_t CreatePerfCounter()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	static double QueryPerfCounterTime(int64_t counter)
+	{
+		return static_cast<double>(CreatePerfCounter() - counter) / 1000000.0;
+	}
+
+	static void StartPerformanceCounter()
+	{
+		CounterStart = CreatePerfCounter();
+	}
+
+	static double GetPerformanceCounter()
+	{
+		return QueryPerfCounterTime(CounterStart);
+	}
+
+	static void TransformStringToLower(std::string& str)
+	{
+		std::transform(str.begin(), str.end(), str.begin(),
+			[](unsigned char c) { return (char)std::tolower(c); });
+	}
+
+	static std::string StringToLower(std::string str)
+	{
+		TransformStringToLower(str);
+		return str;
+	}
+
+	inline static int64_t CounterStart = 0;
+};
+
+class safe_mutex : public std::recursive_mutex
+{
+public:
+	~safe_mutex()
+	{
+		lock();
+
+		while (count > 0) {
+			unlock();
+		}
+	}
+
+	void lock()
+	{
+		std::recursive_mutex::lock();
+		count += 1;
+	}
+
+	void unlock()
+	{
+		count -= 1;
+		std::recursive_mutex::unlock();
+	}
+
+private:
+	std::atomic<uint64_t> count = 0;
+};
+
+class GameUtil
+{
+public:
+	static double GetDistance(RE::NiPoint3 pt1, RE::NiPoint3 pt2)
+	{
+		return sqrt(pow(pt2.x - pt1.x, 2) + pow(pt2.y - pt1.y, 2) + pow(pt2.z - pt1.z, 2) * 1.0);
+	}
+
+	static bool SetEyeCoords(RE::BSGeometry* eyeGeo, float, float)
+	{
+		return eyeGeo != nullptr;
+	}
+};
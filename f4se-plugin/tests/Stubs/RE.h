@@ -0,0 +1,314 @@
+#pragma once
+
+//Stand-ins for the CommonLibF4 & F4SE types used by the headers under test, with the same names & shapes.
+//Only what those headers touch is declared. Forms & handles resolve through a mock world that tests fill themselves.
+namespace RE
+{
+	enum class BSEventNotifyControl
+	{
+		kContinue,
+		kStop
+	};
+
+	template <class Event>
+	class BSTEventSource
+	{
+	};
+
+	template <class Event>
+	class BSTEventSink
+	{
+	public:
+		virtual ~BSTEventSink() = default;
+		virtual BSEventNotifyControl ProcessEvent(const Event& a_event, BSTEventSource<Event>* a_source) = 0;
+	};
+
+	struct MenuModeChangeEvent
+	{
+		bool enteringMenuMode = false;
+	};
+
+	struct NiPoint3
+	{
+		float x = 0.0f;
+		float y = 0.0f;
+		float z = 0.0f;
+
+		NiPoint3() {}
+
+		NiPoint3(float a_x, float a_y, float a_z) :
+			x(a_x), y(a_y), z(a_z) {}
+
+		bool operator==(const NiPoint3&) const = default;
+
+		template <class Archive>
+		void serialize(Archive& ar)
+		{
+			ar(x, y, z);
+		}
+	};
+
+	//Padded to 16 bytes in the game.
+	struct NiPoint3A : public NiPoint3
+	{
+		using NiPoint3::NiPoint3;
+
+		NiPoint3A() {}
+
+		NiPoint3A(const NiPoint3& a_point) :
+			NiPoint3(a_point) {}
+
+		float pad = 0.0f;
+	};
+
+	struct NiMatrix3
+	{
+		NiPoint3 entry[3]{ { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+	};
+
+	struct NiTransform
+	{
+		NiMatrix3 rotate;
+		NiPoint3 translate;
+		float scale = 1.0f;
+	};
+
+	//Doesn't count references, everything it points to is owned by the test.
+	template <class T>
+	class NiPointer
+	{
+	public:
+		NiPointer() {}
+
+		NiPointer(T* a_ptr) :
+			ptr(a_ptr) {}
+
+		T* get() const { return ptr; }
+		void reset(T* a_ptr = nullptr) { ptr = a_ptr; }
+		T* operator->() const { return ptr; }
+		T& operator*() const { return *ptr; }
+		explicit operator bool() const { return ptr != nullptr; }
+		bool operator==(const NiPointer&) const = default;
+		bool operator==(std::nullptr_t) const { return ptr == nullptr; }
+
+	private:
+		T* ptr = nullptr;
+	};
+
+	class NiNode
+	{
+	public:
+		NiTransform world;
+	};
+
+	class BSGeometry
+	{
+	};
+
+	struct Expression
+	{
+		float exp[54]{};
+	};
+
+	class BSFaceGenAnimationData
+	{
+	public:
+		Expression finalExp;
+	};
+
+	class TESForm
+	{
+	public:
+		virtual ~TESForm() = default;
+
+		template <class T>
+		T* As()
+		{
+			return dynamic_cast<T*>(this);
+		}
+
+		static TESForm* GetFormByID(uint32_t a_formID);
+
+		template <class T>
+		static T* GetFormByID(uint32_t a_formID)
+		{
+			return dynamic_cast<T*>(GetFormByID(a_formID));
+		}
+
+		uint32_t formID = 0;
+	};
+
+	class TESIdleForm : public TESForm
+	{
+	};
+
+	class BSUntypedPointerHandle
+	{
+	public:
+		BSUntypedPointerHandle() {}
+
+		explicit BSUntypedPointerHandle(uint32_t a_handle) :
+			handle(a_handle) {}
+
+		uint32_t value() const { return handle; }
+
+	private:
+		uint32_t handle = 0;
+	};
+
+	//Handles are the form ID of the reference they point to.
+	template <class T>
+	class BSPointerHandle
+	{
+	public:
+		BSPointerHandle() {}
+
+		explicit BSPointerHandle(BSUntypedPointerHandle a_handle) :
+			handle(a_handle.value()) {}
+
+		NiPointer<T> get() const
+		{
+			return TESForm::GetFormByID<T>(handle);
+		}
+
+		uint32_t native_handle() { return handle; }
+		uint32_t native_handle_const() const { return handle; }
+
+	private:
+		uint32_t handle = 0;
+	};
+
+	class TESObjectREFR : public TESForm
+	{
+	public:
+		struct Data
+		{
+			NiPoint3A angle;
+			NiPoint3A location;
+		};
+
+		BSPointerHandle<TESObjectREFR> GetHandle()
+		{
+			return BSPointerHandle<TESObjectREFR>(BSUntypedPointerHandle(formID));
+		}
+
+		Data data;
+	};
+
+	class Actor : public TESObjectREFR
+	{
+	};
+
+	class PlayerCamera
+	{
+	public:
+		static PlayerCamera* GetSingleton();
+
+		NiPointer<NiNode> cameraRoot;
+	};
+
+	namespace BGSAnimationSystemUtils
+	{
+		struct ActiveSyncInfo
+		{
+			std::vector<std::pair<std::string, float>> otherSyncInfo;
+			float currentAnimTime = 0.0f;
+			float animSpeedMult = 1.0f;
+			float totalAnimTime = 0.0f;
+		};
+
+		bool GetActiveSyncInfo(const Actor* a_actor, ActiveSyncInfo& a_infoOut);
+		bool IsActiveGraphInTransition(const TESObjectREFR* a_refr);
+	}
+
+	//The game world as the stubs above see it. Tests register the forms they use & set up the camera & graphs.
+	class MockWorld
+	{
+	public:
+		struct Graph
+		{
+			bool hasSyncInfo = false;
+			float currentAnimTime = 0.0f;
+			float totalAnimTime = 0.0f;
+			bool inTransition = false;
+		};
+
+		static void Register(TESForm* a_form)
+		{
+			forms[a_form->formID] = a_form;
+		}
+
+		static void Clear()
+		{
+			forms.clear();
+			graphs.clear();
+			camera = nullptr;
+		}
+
+		inline static std::unordered_map<uint32_t, TESForm*> forms;
+		inline static std::unordered_map<const TESObjectREFR*, Graph> graphs;
+		inline static PlayerCamera* camera = nullptr;
+	};
+
+	inline TESForm* TESForm::GetFormByID(uint32_t a_formID)
+	{
+		auto iter = MockWorld::forms.find(a_formID);
+		return iter != MockWorld::forms.end() ? iter->second : nullptr;
+	}
+
+	inline PlayerCamera* PlayerCamera::GetSingleton()
+	{
+		return MockWorld::camera;
+	}
+
+	inline bool BGSAnimationSystemUtils::GetActiveSyncInfo(const Actor* a_actor, ActiveSyncInfo& a_infoOut)
+	{
+		auto iter = MockWorld::graphs.find(a_actor);
+		if (iter == MockWorld::graphs.end() || !iter->second.hasSyncInfo) {
+			return false;
+		}
+		a_infoOut.currentAnimTime = iter->second.currentAnimTime;
+		a_infoOut.totalAnimTime = iter->second.totalAnimTime;
+		return true;
+	}
+
+	inline bool BGSAnimationSystemUtils::IsActiveGraphInTransition(const TESObjectREFR* a_refr)
+	{
+		auto iter = MockWorld::graphs.find(a_refr);
+		return iter != MockWorld::graphs.end() && iter->second.inTransition;
+	}
+}
+
+namespace F4SE
+{
+	//Co-save records are written to & read from an in-memory buffer. Form IDs can be remapped, as if the load order changed.
+	class SerializationInterface
+	{
+	public:
+		std::optional<uint32_t> ResolveFormID(uint32_t a_formID) const
+		{
+			if (auto iter = remappedIDs.find(a_formID); iter != remappedIDs.end()) {
+				return iter->second != 0 ? std::optional<uint32_t>(iter->second) : std::nullopt;
+			}
+			return a_formID;
+		}
+
+		bool WriteRecordData(const void* a_buf, uint32_t a_length) const
+		{
+			record.append(static_cast<const char*>(a_buf), a_length);
+			return true;
+		}
+
+		uint32_t ReadRecordData(void* a_buf, uint32_t a_length) const
+		{
+			const uint32_t length = static_cast<uint32_t>(std::min<size_t>(a_length, record.size() - readPos));
+			std::memcpy(a_buf, record.data() + readPos, length);
+			readPos += length;
+			return length;
+		}
+
+		std::unordered_map<uint32_t, uint32_t> remappedIDs;
+		mutable std::string record;
+		mutable size_t readPos = 0;
+	};
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+//Stand-in for src/PCH.h. Includes the same libraries, with RE.h in place of CommonLibF4 & a stderr logger in place of
+//spdlog, followed by the plugin's constants & the stubbed Utility helpers. Every test includes this first.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <math.h>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <set>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "FormatShim.h"
+#include "RE.h"
+
+#define FMT_STRING(s) s
+
+//Set NAF_TEST_LOG to see the plugin's log output.
+namespace logger
+{
+	template <class... Args>
+	void Print(const char* level, std::string_view fmt, const Args&... args)
+	{
+		static const bool enabled = std::getenv("NAF_TEST_LOG") != nullptr;
+		if (enabled) {
+#if __cpp_lib_format
+			std::fprintf(stderr, "[%s] %s\n", level, std::vformat(fmt, std::make_format_args(args...)).c_str());
+#else
+			std::fprintf(stderr, "[%s] %s\n", level, std::format(fmt, args...).c_str());
+#endif
+		}
+	}
+
+	template <class... Args>
+	void trace(std::string_view fmt, const Args&... args) { Print("trace", fmt, args...); }
+	template <class... Args>
+	void debug(std::string_view fmt, const Args&... args) { Print("debug", fmt, args...); }
+	template <class... Args>
+	void info(std::string_view fmt, const Args&... args) { Print("info", fmt, args...); }
+	template <class... Args>
+	void warn(std::string_view fmt, const Args&... args) { Print("warning", fmt, args...); }
+	template <class... Args>
+	void error(std::string_view fmt, const Args&... args) { Print("error", fmt, args...); }
+	template <class... Args>
+	void critical(std::string_view fmt, const Args&... args) { Print("critical", fmt, args...); }
+}
+
+using namespace std::literals;
+
+#include "cereal/archives/binary.hpp"
+#include "cereal/types/polymorphic.hpp"
+#include "cereal/types/base_class.hpp"
+#include "cereal/types/vector.hpp"
+#include "cereal/types/unordered_map.hpp"
+#include "cereal/types/memory.hpp"
+#include "cereal/types/variant.hpp"
+#include "cereal/types/string.hpp"
+#include "cereal/types/tuple.hpp"
+#include "cereal/types/unordered_set.hpp"
+#include "cereal/types/set.hpp"
+#include "cereal/types/optional.hpp"
+#include "cereal/types/atomic.hpp"
+#include "cereal/types/utility.hpp"
+#include "cereal/types/array.hpp"
+#include "pugixml/pugixml.hpp"
+
+#include "Data/Constants.h"
+#include "PluginStubs.h"
+#include "Check.h"
@@ -0,0 +1,203 @@
+#include "TestPCH.h"
+#include "Misc/SyncInfoCache.h"
+
+namespace
+{
+	using Misc::SyncInfoCache;
+
+	//Counts graph queries per actor, every actor is at the same time.
+	class MockSource : public Misc::ISyncInfoSource
+	{
+	public:
+		virtual std::optional<Misc::SyncTime> QActiveSyncTime(RE::Actor* actor) override
+		{
+			syncQueries[actor]++;
+			return time;
+		}
+
+		virtual bool QInTransition(RE::Actor* actor) override
+		{
+			transitionQueries[actor]++;
+			return inTransition;
+		}
+
+		std::optional<Misc::SyncTime> time = Misc::SyncTime{ 1.0f, 4.0f };
+		bool inTransition = false;
+		std::unordered_map<RE::Actor*, size_t> syncQueries;
+		std::unordered_map<RE::Actor*, size_t> transitionQueries;
+	};
+
+	//Installs a fresh mock source with empty metrics, & puts the game source back afterwards.
+	struct MockedCache
+	{
+		MockedCache()
+		{
+			SyncInfoCache::Clear();
+			auto s = std::make_unique<MockSource>();
+			source = s.get();
+			SyncInfoCache::SetSource(std::move(s));
+		}
+
+		~MockedCache()
+		{
+			SyncInfoCache::SetSource(std::make_unique<Misc::GameSyncInfoSource>());
+			SyncInfoCache::Clear();
+			RE::MockWorld::Clear();
+		}
+
+		MockSource* source;
+	};
+
+	void OneQueryPerActorPerFrame()
+	{
+		MockedCache c;
+		std::array<RE::Actor, 3> actors;
+		for (size_t f = 0; f < 5; f++) {
+			SyncInfoCache::NextFrame();
+			for (size_t i = 0; i < 10; i++) {
+				for (auto& a : actors) {
+					CHECK(SyncInfoCache::GetSyncTime(&a)->total == 4.0f);
+					CHECK(!SyncInfoCache::IsInTransition(&a));
+				}
+			}
+		}
+
+		for (auto& a : actors) {
+			CHECK(c.source->syncQueries[&a] == 5);
+			CHECK(c.source->transitionQueries[&a] == 5);
+		}
+		auto m = SyncInfoCache::QMetrics();
+		CHECK(m.frames == 5);
+		CHECK(m.lookups == 5 * 10 * actors.size() * 2);
+		CHECK(m.graphQueries == 5 * actors.size() * 2);
+		CHECK(m.maxQueriesPerFrame == actors.size() * 2);
+	}
+
+	void NewFramesSeeGraphChanges()
+	{
+		MockedCache c;
+		RE::Actor actor;
+		SyncInfoCache::NextFrame();
+		CHECK(SyncInfoCache::GetSyncTime(&actor)->current == 1.0f);
+
+		c.source->time = Misc::SyncTime{ 2.0f, 4.0f };
+		c.source->inTransition = true;
+		CHECK(SyncInfoCache::GetSyncTime(&actor)->current == 1.0f);
+
+		SyncInfoCache::NextFrame();
+		CHECK(SyncInfoCache::GetSyncTime(&actor)->current == 2.0f);
+		CHECK(SyncInfoCache::IsInTransition(&actor));
+
+		c.source->time = std::nullopt;
+		SyncInfoCache::NextFrame();
+		CHECK(!SyncInfoCache::GetSyncTime(&actor).has_value());
+	}
+
+	void InvalidateRequeriesWithinFrame()
+	{
+		MockedCache c;
+		RE::Actor actor;
+		RE::Actor other;
+		SyncInfoCache::NextFrame();
+		SyncInfoCache::GetSyncTime(&actor);
+		SyncInfoCache::GetSyncTime(&other);
+
+		c.source->time = Misc::SyncTime{ 0.0f, 8.0f };
+		SyncInfoCache::Invalidate(&actor);
+		CHECK(SyncInfoCache::GetSyncTime(&actor)->total == 8.0f);
+		CHECK(SyncInfoCache::GetSyncTime(&other)->total == 4.0f);
+		CHECK(c.source->syncQueries[&actor] == 2);
+		CHECK(c.source->syncQueries[&other] == 1);
+
+		//Invalidating an actor that was never looked up isn't counted.
+		RE::Actor unknown;
+		SyncInfoCache::Invalidate(&unknown);
+		CHECK(SyncInfoCache::QMetrics().invalidations == 1);
+	}
+
+	void NullActorsAreNotQueried()
+	{
+		MockedCache c;
+		SyncInfoCache::NextFrame();
+		CHECK(!SyncInfoCache::GetSyncTime(nullptr).has_value());
+		CHECK(!SyncInfoCache::IsInTransition(nullptr));
+		CHECK(c.source->syncQueries.empty());
+		CHECK(c.source->transitionQueries.empty());
+		CHECK(SyncInfoCache::QMetrics().lookups == 0);
+	}
+
+	//Pruned entries are gone, so invalidating them no longer counts.
+	void StaleEntriesArePruned()
+	{
+		MockedCache c;
+		RE::Actor stale;
+		RE::Actor active;
+		SyncInfoCache::NextFrame();
+		SyncInfoCache::GetSyncTime(&stale);
+		for (size_t f = 0; f < 1300; f++) {
+			SyncInfoCache::NextFrame();
+			SyncInfoCache::IsInTransition(&active);
+		}
+
+		SyncInfoCache::Invalidate(&stale);
+		CHECK(SyncInfoCache::QMetrics().invalidations == 0);
+		SyncInfoCache::Invalidate(&active);
+		CHECK(SyncInfoCache::QMetrics().invalidations == 1);
+	}
+
+	void ConcurrentLookupsShareOneQuery()
+	{
+		MockedCache c;
+		std::array<RE::Actor, 4> actors;
+		for (size_t f = 0; f < 50; f++) {
+			SyncInfoCache::NextFrame();
+			std::vector<std::thread> threads;
+			for (size_t t = 0; t < 4; t++) {
+				threads.emplace_back([&] {
+					for (auto& a : actors) {
+						SyncInfoCache::GetSyncTime(&a);
+						SyncInfoCache::IsInTransition(&a);
+					}
+				});
+			}
+			for (auto& t : threads) {
+				t.join();
+			}
+		}
+
+		for (auto& a : actors) {
+			CHECK(c.source->syncQueries[&a] == 50);
+			CHECK(c.source->transitionQueries[&a] == 50);
+		}
+	}
+
+	void GameSourceReadsActiveGraph()
+	{
+		MockedCache c;
+		SyncInfoCache::SetSource(std::make_unique<Misc::GameSyncInfoSource>());
+		RE::Actor synced;
+		RE::Actor unsynced;
+		RE::MockWorld::graphs[&synced] = { true, 1.5f, 3.0f, true };
+		RE::MockWorld::graphs[&unsynced] = { false, 1.5f, 3.0f, false };
+
+		SyncInfoCache::NextFrame();
+		auto t = SyncInfoCache::GetSyncTime(&synced);
+		CHECK(t.has_value() && t->current == 1.5f && t->total == 3.0f);
+		CHECK(SyncInfoCache::IsInTransition(&synced));
+		CHECK(!SyncInfoCache::GetSyncTime(&unsynced).has_value());
+		CHECK(!SyncInfoCache::IsInTransition(&unsynced));
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "OneQueryPerActorPerFrame", OneQueryPerActorPerFrame },
+		{ "NewFramesSeeGraphChanges", NewFramesSeeGraphChanges },
+		{ "InvalidateRequeriesWithinFrame", InvalidateRequeriesWithinFrame },
+		{ "NullActorsAreNotQueried", NullActorsAreNotQueried },
+		{ "StaleEntriesArePruned", StaleEntriesArePruned },
+		{ "ConcurrentLookupsShareOneQuery", ConcurrentLookupsShareOneQuery },
+		{ "GameSourceReadsActiveGraph", GameSourceReadsActiveGraph },
+	});
+}
@@ -0,0 +1,197 @@
+#include "TestPCH.h"
+#include "Tasks/TaskExecutor.h"
+
+namespace
+{
+	using namespace Tasks;
+
+	class FuncFunctor : public TaskFunctor
+	{
+	public:
+		FuncFunctor(std::function<void()> a_run, std::optional<uint64_t> a_key = std::nullopt) :
+			run(a_run), key(a_key) {}
+
+		virtual void Run() override { run(); }
+		virtual void Finalize() override { finalized++; }
+		virtual std::optional<uint64_t> QOrderingKey() const override { return key; }
+
+		std::function<void()> run;
+		std::optional<uint64_t> key;
+		std::atomic<int> finalized = 0;
+	};
+
+	std::shared_ptr<FuncFunctor> MakeFunctor(std::function<void()> run, std::optional<uint64_t> key = std::nullopt)
+	{
+		return std::make_shared<FuncFunctor>(run, key);
+	}
+
+	template <typename F>
+	bool WaitFor(F&& condition, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+	{
+		const auto end = std::chrono::steady_clock::now() + timeout;
+		while (!condition()) {
+			if (std::chrono::steady_clock::now() > end) {
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	//Jobs sharing an ordering key run one at a time, in dispatch order, while other lanes run alongside.
+	void LanesRunInOrderOneAtATime()
+	{
+		TaskExecutor executor;
+		constexpr size_t lanes = 3;
+		constexpr size_t jobs = 50;
+		std::mutex lock;
+		std::array<std::vector<size_t>, lanes> order;
+		std::array<std::atomic<int>, lanes> active{};
+		std::atomic<int> overlaps = 0;
+		std::atomic<size_t> done = 0;
+
+		uint64_t uid = 1;
+		for (size_t j = 0; j < jobs; j++) {
+			for (size_t k = 0; k < lanes; k++) {
+				executor.Dispatch(uid++, MakeFunctor([&, k, j] {
+					overlaps += active[k]++ != 0;
+					std::this_thread::yield();
+					{
+						std::unique_lock l{ lock };
+						order[k].push_back(j);
+					}
+					active[k]--;
+					done++;
+				}, 100 + k), false, 0.0);
+			}
+		}
+
+		CHECK(WaitFor([&] { return done == lanes * jobs; }));
+		CHECK(overlaps == 0);
+		for (auto& o : order) {
+			CHECK(o.size() == jobs && std::is_sorted(o.begin(), o.end()));
+		}
+		CHECK(executor.QMetrics().runs == lanes * jobs);
+	}
+
+	void SlowBodyDoesntHoldUpOtherLanes()
+	{
+		TaskExecutor executor;
+		std::atomic<bool> release = false;
+		std::atomic<bool> fastRan = false;
+		executor.Dispatch(1, MakeFunctor([&] { WaitFor([&] { return release.load(); }); }), false, 0.0);
+		executor.Dispatch(2, MakeFunctor([&] { fastRan = true; }), false, 0.0);
+		CHECK(WaitFor([&] { return fastRan.load(); }));
+		release = true;
+	}
+
+	void CancelDropsQueuedJobs()
+	{
+		TaskExecutor executor;
+		std::atomic<bool> started = false;
+		std::atomic<bool> release = false;
+		std::atomic<int> cancelledRuns = 0;
+		executor.Dispatch(1, MakeFunctor([&] {
+			started = true;
+			WaitFor([&] { return release.load(); });
+		}, 7), false, 0.0);
+		auto f = MakeFunctor([&] { cancelledRuns++; }, 7);
+		for (int i = 0; i < 5; i++) {
+			executor.Dispatch(2, f, true, 0.0);
+		}
+		CHECK(WaitFor([&] { return started.load(); }));
+		executor.Cancel(2);
+		release = true;
+		executor.Cancel(1);
+
+		CHECK(cancelledRuns == 0);
+		CHECK(f->finalized == 0);
+		auto m = executor.QMetrics();
+		CHECK(m.dispatched == 6);
+		CHECK(m.cancelled == 5);
+	}
+
+	//Once Cancel() returns, the task's body has finished & won't run again.
+	void CancelWaitsForRunningBody()
+	{
+		TaskExecutor executor;
+		std::atomic<bool> started = false;
+		std::atomic<bool> finished = false;
+		executor.Dispatch(1, MakeFunctor([&] {
+			started = true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			finished = true;
+		}), false, 0.0);
+
+		CHECK(WaitFor([&] { return started.load(); }));
+		executor.Cancel(std::vector<uint64_t>{ 1, 2 });
+		CHECK(finished);
+	}
+
+	void BodiesCanCancelThemselves()
+	{
+		TaskExecutor executor;
+		std::atomic<bool> finished = false;
+		executor.Dispatch(1, MakeFunctor([&] {
+			executor.Cancel(1);
+			finished = true;
+		}), false, 0.0);
+		CHECK(WaitFor([&] { return finished.load(); }));
+	}
+
+	void CancelAllWaitsForEveryBody()
+	{
+		TaskExecutor executor;
+		std::atomic<int> started = 0;
+		std::atomic<int> finished = 0;
+		std::atomic<int> queuedRuns = 0;
+		for (uint64_t uid = 1; uid <= 2; uid++) {
+			executor.Dispatch(uid, MakeFunctor([&] {
+				started++;
+				std::this_thread::sleep_for(std::chrono::milliseconds(30));
+				finished++;
+			}, uid), false, 0.0);
+			executor.Dispatch(uid + 10, MakeFunctor([&] { queuedRuns++; }, uid), false, 0.0);
+		}
+
+		CHECK(WaitFor([&] { return started == 2; }));
+		executor.CancelAll();
+		CHECK(finished == 2);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		CHECK(queuedRuns == 0);
+	}
+
+	//Every run lands in exactly one histogram bucket, late runs in the buckets past their lateness.
+	void JitterHistogramCountsEveryRun()
+	{
+		TaskExecutor executor;
+		std::atomic<int> done = 0;
+		const std::array<double, 4> late{ -0.0005, 0.003, 0.03, 0.5 };
+		for (size_t i = 0; i < 40; i++) {
+			executor.Dispatch(i + 1, MakeFunctor([&] { done++; }), true, late[i % late.size()]);
+		}
+		CHECK(WaitFor([&] { return done == 40; }));
+		executor.Stop();
+
+		auto m = executor.QMetrics();
+		CHECK(m.runs == 40);
+		CHECK(std::accumulate(m.jitterHistogram.begin(), m.jitterHistogram.end(), uint64_t{ 0 }) == m.runs);
+		CHECK(m.jitterHistogram.back() == 10);
+		CHECK(std::accumulate(m.jitterHistogram.begin() + 4, m.jitterHistogram.end(), uint64_t{ 0 }) >= 30);
+		CHECK(m.maxJitterMs >= 500.0);
+		CHECK(m.QAverageJitterMs() > 0.0);
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "LanesRunInOrderOneAtATime", LanesRunInOrderOneAtATime },
+		{ "SlowBodyDoesntHoldUpOtherLanes", SlowBodyDoesntHoldUpOtherLanes },
+		{ "CancelDropsQueuedJobs", CancelDropsQueuedJobs },
+		{ "CancelWaitsForRunningBody", CancelWaitsForRunningBody },
+		{ "BodiesCanCancelThemselves", BodiesCanCancelThemselves },
+		{ "CancelAllWaitsForEveryBody", CancelAllWaitsForEveryBody },
+		{ "JitterHistogramCountsEveryRun", JitterHistogramCountsEveryRun },
+	});
+}
@@ -0,0 +1,161 @@
+#include "TestPCH.h"
+#include "FaceAnimation/AnimationData.h"
+#include "FaceAnimCorpus.h"
+
+namespace
+{
+	using namespace FaceAnimation;
+
+	//The single precision curves are within 4e-6 of the reference, the rest is float interpolation.
+	constexpr double MaxSampleError = 1e-5;
+
+	std::vector<AnimationData> RuntimeCorpus()
+	{
+		std::vector<AnimationData> result;
+		for (auto& d : Corpus::MakeFaceAnims(100)) {
+			result.push_back(d.ToRuntimeData());
+		}
+		return result;
+	}
+
+	void LayoutIsFlat()
+	{
+		for (auto& anim : RuntimeCorpus()) {
+			for (auto& tl : anim.timelines) {
+				CHECK(tl.eases.size() == tl.size());
+				CHECK(tl.values.size() == (tl.isEyes ? 0 : tl.size()));
+				CHECK(tl.eyes.size() == (tl.isEyes ? tl.size() : 0));
+				CHECK(std::is_sorted(tl.times.begin(), tl.times.end()));
+			}
+		}
+	}
+
+	//Playing forward at 60fps, with one cursor per timeline, must give what the map layout gave.
+	void SamplesMatchMapLayout()
+	{
+		for (auto& anim : RuntimeCorpus()) {
+			const size_t frames = static_cast<size_t>(anim.duration * 60.0) + 2;
+			for (auto& tl : anim.timelines) {
+				Corpus::MapTimeline ref(tl);
+				TimelineCursor c;
+				double maxError = 0.0;
+				for (size_t f = 0; f <= frames; f++) {
+					const double t = static_cast<double>(f) / static_cast<double>(frames - 1);
+					if (tl.isEyes) {
+						auto v = tl.GetEyesValueAtTime(t, c);
+						auto r = ref.GetEyesValueAtTime(t);
+						maxError = std::max({ maxError, std::abs(v.u - r.u), std::abs(v.v - r.v) });
+					} else {
+						maxError = std::max(maxError, static_cast<double>(std::abs(tl.GetValueAtTime(t, c) - ref.GetValueAtTime(t))));
+					}
+				}
+				if (maxError > MaxSampleError) {
+					Test::Fail(__FILE__, __LINE__, std::format("timeline of morph {} off by {}", tl.morph, maxError));
+				}
+			}
+		}
+	}
+
+	//Jumping around must give the same values as a fresh cursor, whichever way the cursor has to move.
+	void SeeksMatchFreshCursor()
+	{
+		std::mt19937 rng(11);
+		std::uniform_real_distribution<double> dist(-0.1, 1.1);
+		for (auto& anim : RuntimeCorpus()) {
+			for (auto& tl : anim.timelines) {
+				if (tl.isEyes) {
+					continue;
+				}
+				TimelineCursor c;
+				for (size_t i = 0; i < 200; i++) {
+					//Mostly small steps, sometimes a seek anywhere.
+					const double t = i % 8 == 0 ? dist(rng) : std::clamp(static_cast<double>(i % 64) / 63.0, 0.0, 1.0);
+					TimelineCursor fresh;
+					CHECK(tl.GetValueAtTime(t, c) == tl.GetValueAtTime(t, fresh));
+				}
+			}
+		}
+	}
+
+	void OutOfRangeHoldsEndValues()
+	{
+		FrameBasedAnimData d;
+		d.duration = 30;
+		auto tl = d.MakeTimeline(3);
+		tl->keys[6].value = 0.25f;
+		tl->keys[24].value = 0.75f;
+		auto single = d.MakeTimeline(4);
+		single->keys[15].value = 0.5f;
+		auto anim = d.ToRuntimeData();
+
+		TimelineCursor c;
+		CHECK(anim.timelines[0].GetValueAtTime(0.0, c) == 0.25f);
+		CHECK(anim.timelines[0].GetValueAtTime(1.0, c) == 0.75f);
+		CHECK(anim.timelines[0].GetValueAtTime(0.1, c) == 0.25f);
+		CHECK(anim.timelines[1].GetValueAtTime(0.0, c) == 0.5f);
+		CHECK(anim.timelines[1].GetValueAtTime(1.0, c) == 0.5f);
+	}
+
+	void FrameDataRoundTrips()
+	{
+		for (auto& d : Corpus::MakeFaceAnims(100)) {
+			auto back = FrameBasedAnimData::FromRuntimeData(d.ToRuntimeData(), d.frameRate);
+			//Durations are truncated to whole frames on the way back, as they always were.
+			CHECK(std::abs(back.duration - d.duration) <= 1);
+			CHECK(back.timelines.size() == d.timelines.size());
+			for (size_t i = 0; i < d.timelines.size() && i < back.timelines.size(); i++) {
+				auto& a = d.timelines[i];
+				auto& b = back.timelines[i];
+				CHECK(a.morph == b.morph && a.isEyes == b.isEyes && a.keys.size() == b.keys.size());
+				for (auto ai = a.keys.begin(), bi = b.keys.begin(); ai != a.keys.end() && bi != b.keys.end(); ai++, bi++) {
+					CHECK(ai->first == bi->first);
+					CHECK(ai->second.ease == bi->second.ease);
+					if (a.isEyes) {
+						CHECK_NEAR(ai->second.eyesValue.u, bi->second.eyesValue.u, 1e-6);
+						CHECK_NEAR(ai->second.eyesValue.v, bi->second.eyesValue.v, 1e-6);
+					} else {
+						CHECK(ai->second.value == bi->second.value);
+					}
+				}
+			}
+		}
+	}
+
+	//Baked values are lerped between table entries, so check them against exact evaluation at more points than BuildLUT does.
+	void LUTsStayWithinBakeError()
+	{
+		size_t baked = 0;
+		for (auto& anim : RuntimeCorpus()) {
+			auto report = anim.BakeLUTs(60, FACEANIM_BAKE_MAX_ERROR);
+			baked += report.baked;
+			CHECK(report.maxError <= FACEANIM_BAKE_MAX_ERROR);
+			for (auto& tl : anim.timelines) {
+				if (!tl.HasLUT()) {
+					continue;
+				}
+				TimelineCursor c;
+				const size_t points = (tl.lut.size() - 1) * FACEANIM_BAKE_CHECK_STEPS * 4;
+				for (size_t p = 0; p <= points; p++) {
+					const double t = static_cast<double>(p) / static_cast<double>(points);
+					float fraction;
+					const size_t i = tl.LocateLUT(t, fraction);
+					const float sampled = std::lerp(tl.GetLUTValue(i), tl.GetLUTValue(i + 1), fraction);
+					CHECK_NEAR(sampled, tl.GetValueAtTime(t, c), FACEANIM_BAKE_MAX_ERROR);
+				}
+			}
+		}
+		CHECK(baked > 0);
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "LayoutIsFlat", LayoutIsFlat },
+		{ "SamplesMatchMapLayout", SamplesMatchMapLayout },
+		{ "SeeksMatchFreshCursor", SeeksMatchFreshCursor },
+		{ "OutOfRangeHoldsEndValues", OutOfRangeHoldsEndValues },
+		{ "FrameDataRoundTrips", FrameDataRoundTrips },
+		{ "LUTsStayWithinBakeError", LUTsStayWithinBakeError },
+	});
+}
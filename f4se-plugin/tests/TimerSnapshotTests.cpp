@@ -0,0 +1,203 @@
+#include "TestPCH.h"
+#include "Serialization/General.h"
+#include "Data/Uid.h"
+#include "Tasks/TimerThread.h"
+
+namespace TimerSnapshotTests
+{
+	//Counts runs per ID, & is saved with its ID like the plugin's scene timer functors.
+	class CountFunctor : public Tasks::TaskFunctor
+	{
+	public:
+		inline static std::mutex lock;
+		inline static std::unordered_map<int, int> runs;
+
+		int id = 0;
+
+		CountFunctor() {}
+
+		CountFunctor(int _id) :
+			id(_id) {}
+
+		static int QRuns(int id)
+		{
+			std::unique_lock l{ lock };
+			return runs[id];
+		}
+
+		virtual void Run() override
+		{
+			std::unique_lock l{ lock };
+			runs[id]++;
+		}
+
+		virtual void RunOnMainThread() override { Run(); }
+
+		template <class Archive>
+		void serialize(Archive& ar, const uint32_t)
+		{
+			ar(cereal::base_class<Tasks::TaskFunctor>(this), id);
+		}
+	};
+}
+
+CEREAL_REGISTER_TYPE(TimerSnapshotTests::CountFunctor);
+
+namespace
+{
+	using namespace Tasks;
+	using TimerSnapshotTests::CountFunctor;
+
+	F4SE::SerializationInterface intfc;
+
+	template <typename F>
+	bool WaitFor(F&& condition, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+	{
+		const auto end = std::chrono::steady_clock::now() + timeout;
+		while (!condition()) {
+			if (std::chrono::steady_clock::now() > end) {
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	template <typename T>
+	std::string Save(const T& data)
+	{
+		Serialization::General::s_intfc = &intfc;
+		intfc.record.clear();
+		Serialization::General::SaveRecord("task", data);
+		return intfc.record;
+	}
+
+	template <typename T>
+	bool Load(const std::string& record, T& dataOut)
+	{
+		Serialization::General::s_intfc = &intfc;
+		intfc.record = record;
+		intfc.readPos = 0;
+		return Serialization::General::LoadRecord("task", dataOut);
+	}
+
+	std::shared_ptr<TimedTask> MakeTask(int id, double ms, int64_t repeats = 0)
+	{
+		return TimedTask::MakeTask(std::make_shared<CountFunctor>(id), ms, repeats);
+	}
+
+	//Saves a running timer & loads it into a fresh one, the way the co-save callbacks do.
+	void RoundTripKeepsRemainingTime()
+	{
+		TimerThread timer;
+		auto soon = MakeTask(1, 1000);
+		auto later = MakeTask(2, 5000);
+		auto repeating = MakeTask(3, 10, -1);
+		auto held = MakeTask(4, 50);
+		held->timeScale = 0.0;
+		for (auto& t : { soon, later, repeating, held }) {
+			timer.AddTimedTask(t);
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		const std::string record = Save(timer.Snapshot());
+		CHECK(timer.threadProcessingTasks);
+
+		auto loaded = std::make_unique<TimerThread::PersistentState>();
+		CHECK(Load(record, loaded));
+		auto& tasks = loaded->timedTasks;
+		CHECK(tasks.size() == 4);
+		CHECK(tasks.at(soon->uid)->duration < 0.955 && tasks.at(soon->uid)->duration > 0.0);
+		CHECK(tasks.at(later->uid)->duration > 4.5);
+		CHECK(tasks.at(repeating->uid)->repeats == -1);
+		CHECK(tasks.at(repeating->uid)->initDuration == 0.01);
+		CHECK(tasks.at(held->uid)->duration == 0.05 && tasks.at(held->uid)->timeScale == 0.0);
+		CHECK(std::dynamic_pointer_cast<CountFunctor>(tasks.at(later->uid)->task)->id == 2);
+
+		timer.Reset();
+		const int repeatRuns = CountFunctor::QRuns(3);
+		CHECK(repeatRuns > 0);
+
+		TimerThread restored;
+		restored.state.reset(loaded.release());
+		restored.Start();
+		CHECK(WaitFor([] { return CountFunctor::QRuns(1) == 1; }));
+		CHECK(WaitFor([&] { return CountFunctor::QRuns(3) > repeatRuns; }));
+		CHECK(CountFunctor::QRuns(2) == 0);
+		CHECK(CountFunctor::QRuns(4) == 0);
+		restored.Reset();
+	}
+
+	//The snapshot owns its copies, so the live tasks keep their own durations & later changes don't leak into the save.
+	void SnapshotIsIndependentOfLiveTasks()
+	{
+		TimerThread timer;
+		auto tsk = MakeTask(5, 5000);
+		timer.AddTimedTask(tsk);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+		auto snapshot = timer.Snapshot();
+		auto& copy = snapshot->timedTasks.at(tsk->uid);
+		CHECK(copy.get() != tsk.get());
+		CHECK(copy->task == tsk->task);
+		CHECK(copy->duration < 4.99);
+		CHECK(tsk->duration == 5.0);
+
+		timer.VisitTask(tsk->uid, [](TimedTask* t) { t->timeScale = 2.0; });
+		CHECK(copy->timeScale == 1.0);
+		timer.Reset();
+	}
+
+	//Taking a snapshot only holds the timer for the copy, a repeating task keeps running around saves.
+	void SavingDoesntPauseTimers()
+	{
+		TimerThread timer;
+		for (int i = 0; i < 2000; i++) {
+			timer.AddTimedTask(MakeTask(100, 60000));
+		}
+		timer.AddTimedTask(MakeTask(6, 2, -1));
+
+		for (int s = 0; s < 5; s++) {
+			const int before = CountFunctor::QRuns(6);
+			Save(timer.Snapshot());
+			CHECK(timer.threadProcessingTasks && !timer.timerPaused);
+			CHECK(WaitFor([&] { return CountFunctor::QRuns(6) > before; }));
+		}
+		timer.Reset();
+	}
+
+	void FrameTimerRoundTrip()
+	{
+		FrameTimer::Reset();
+		FrameTimer::Start();
+		auto tsk = MakeTask(7, 100, 2);
+		FrameTimer::AddTimedTask(tsk);
+		FrameTimer::Update(0.1);
+		FrameTimer::Update(0.04);
+		CHECK(CountFunctor::QRuns(7) == 1);
+
+		auto loaded = std::make_unique<FrameTimer::PersistentState>();
+		CHECK(Load(Save(FrameTimer::Snapshot()), loaded));
+		CHECK_NEAR(loaded->timedTasks.at(tsk->uid)->duration, 0.06, 1e-9);
+		CHECK(loaded->timedTasks.at(tsk->uid)->repeats == 1);
+
+		FrameTimer::Stop();
+		FrameTimer::state.reset(loaded.release());
+		FrameTimer::Start();
+		FrameTimer::Update(0.05);
+		CHECK(CountFunctor::QRuns(7) == 1);
+		FrameTimer::Update(0.02);
+		CHECK(CountFunctor::QRuns(7) == 2);
+		FrameTimer::Reset();
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "RoundTripKeepsRemainingTime", RoundTripKeepsRemainingTime },
+		{ "SnapshotIsIndependentOfLiveTasks", SnapshotIsIndependentOfLiveTasks },
+		{ "SavingDoesntPauseTimers", SavingDoesntPauseTimers },
+		{ "FrameTimerRoundTrip", FrameTimerRoundTrip },
+	});
+}
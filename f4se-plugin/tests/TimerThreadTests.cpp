@@ -0,0 +1,187 @@
+#include "TestPCH.h"
+#include "Data/Uid.h"
+#include "Tasks/TimerThread.h"
+
+namespace
+{
+	using namespace Tasks;
+
+	//Runs of every task, in the order they happened.
+	struct RunLog
+	{
+		std::mutex lock;
+		std::vector<int> runs;
+		std::vector<int> finalized;
+
+		size_t QRuns()
+		{
+			std::unique_lock l{ lock };
+			return runs.size();
+		}
+	};
+
+	class LogFunctor : public TaskFunctor
+	{
+	public:
+		LogFunctor(std::shared_ptr<RunLog> a_log, int a_id, std::optional<uint64_t> a_key = std::nullopt) :
+			log(a_log), id(a_id), key(a_key) {}
+
+		virtual void Run() override
+		{
+			std::unique_lock l{ log->lock };
+			log->runs.push_back(id);
+		}
+
+		virtual void Finalize() override
+		{
+			std::unique_lock l{ log->lock };
+			log->finalized.push_back(id);
+		}
+
+		virtual std::optional<uint64_t> QOrderingKey() const override { return key; }
+
+		std::shared_ptr<RunLog> log;
+		int id;
+		std::optional<uint64_t> key;
+	};
+
+	//Polls until the condition holds, up to a generous timeout for slow & single core machines.
+	template <typename F>
+	bool WaitFor(F&& condition, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+	{
+		const auto end = std::chrono::steady_clock::now() + timeout;
+		while (!condition()) {
+			if (std::chrono::steady_clock::now() > end) {
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	void Settle(TimerThread& timer)
+	{
+		timer.Stop();
+		TaskExecutor::GetSingleton()->CancelAll();
+	}
+
+	//Tasks share a lane, so they also run in the order they were dispatched.
+	void FiresInDeadlineOrder()
+	{
+		TimerThread timer;
+		auto log = std::make_shared<RunLog>();
+		for (int ms : { 50, 10, 40, 20, 30 }) {
+			timer.AddTimedTask(TimedTask::MakeTask(std::make_shared<LogFunctor>(log, ms, 1), ms));
+		}
+		CHECK(WaitFor([&] { return log->QRuns() == 5; }));
+		CHECK((log->runs == std::vector<int>{ 10, 20, 30, 40, 50 }));
+		Settle(timer);
+	}
+
+	void RemovedTasksNeverRun()
+	{
+		TimerThread timer;
+		auto log = std::make_shared<RunLog>();
+		std::vector<uint64_t> removed;
+		for (int i = 0; i < 100; i++) {
+			auto tsk = TimedTask::MakeTask(std::make_shared<LogFunctor>(log, i), 30);
+			timer.AddTimedTask(tsk);
+			if (i % 2 == 0) {
+				removed.push_back(tsk->uid);
+			}
+		}
+		CHECK(timer.RemoveTimedTask(removed.back()));
+		CHECK(!timer.RemoveTimedTask(removed.back()));
+		removed.pop_back();
+		CHECK(timer.RemoveTimedTasks(removed));
+
+		CHECK(WaitFor([&] { return log->QRuns() == 50; }));
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		CHECK(log->QRuns() == 50);
+		CHECK(std::all_of(log->runs.begin(), log->runs.end(), [](int id) { return id % 2 == 1; }));
+		CHECK(timer.QMetrics().dispatched == 50);
+		Settle(timer);
+	}
+
+	void RepeatsThenFinalizesOnce()
+	{
+		TimerThread timer;
+		auto log = std::make_shared<RunLog>();
+		timer.AddTimedTask(TimedTask::MakeTask(std::make_shared<LogFunctor>(log, 1), 5, 3));
+		CHECK(WaitFor([&] {
+			std::unique_lock l{ log->lock };
+			return log->finalized.size() == 1;
+		}));
+		CHECK(log->QRuns() == 4);
+		CHECK(WaitFor([&] { return !timer.threadProcessingTasks; }));
+		Settle(timer);
+	}
+
+	void ZeroTimeScaleHoldsTask()
+	{
+		TimerThread timer;
+		auto log = std::make_shared<RunLog>();
+		auto tsk = TimedTask::MakeTask(std::make_shared<LogFunctor>(log, 1), 20);
+		timer.AddTimedTask(tsk);
+		timer.VisitTask(tsk->uid, [](TimedTask* t) { t->timeScale = 0.0; });
+		std::this_thread::sleep_for(std::chrono::milliseconds(80));
+		CHECK(log->QRuns() == 0);
+
+		timer.VisitTask(tsk->uid, [](TimedTask* t) { t->timeScale = 1.0; });
+		CHECK(WaitFor([&] { return log->QRuns() == 1; }));
+		Settle(timer);
+	}
+
+	//Menu mode freezes the clock, so a task's remaining time is kept across the pause.
+	void MenuModeFreezesClock()
+	{
+		TimerThread timer;
+		auto log = std::make_shared<RunLog>();
+		timer.AddTimedTask(TimedTask::MakeTask(std::make_shared<LogFunctor>(log, 1), 60));
+		timer.ProcessEvent(RE::MenuModeChangeEvent{ true }, nullptr);
+		CHECK(timer.timerPaused);
+		std::this_thread::sleep_for(std::chrono::milliseconds(120));
+		CHECK(log->QRuns() == 0);
+
+		const auto resumed = std::chrono::steady_clock::now();
+		timer.ProcessEvent(RE::MenuModeChangeEvent{ false }, nullptr);
+		CHECK(!timer.timerPaused);
+		CHECK(WaitFor([&] { return log->QRuns() == 1; }));
+		CHECK(std::chrono::steady_clock::now() - resumed >= std::chrono::milliseconds(50));
+		Settle(timer);
+	}
+
+	//Tasks due within TIMER_COALESCE_WINDOW of each other are dispatched by one wakeup.
+	void CoalescesNearDeadlines()
+	{
+		TimerThread timer;
+		auto log = std::make_shared<RunLog>();
+		std::vector<std::shared_ptr<TimedTask>> tasks;
+		for (int i = 0; i < 100; i++) {
+			tasks.push_back(TimedTask::MakeTask(std::make_shared<LogFunctor>(log, i), 30));
+		}
+		timer.SetPaused(true);
+		for (auto& t : tasks) {
+			timer.AddTimedTask(t);
+		}
+		timer.SetPaused(false);
+
+		CHECK(WaitFor([&] { return log->QRuns() == 100; }));
+		auto m = timer.QMetrics();
+		CHECK(m.dispatched == 100);
+		CHECK(m.wakeups < 10);
+		Settle(timer);
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "FiresInDeadlineOrder", FiresInDeadlineOrder },
+		{ "RemovedTasksNeverRun", RemovedTasksNeverRun },
+		{ "RepeatsThenFinalizesOnce", RepeatsThenFinalizesOnce },
+		{ "ZeroTimeScaleHoldsTask", ZeroTimeScaleHoldsTask },
+		{ "MenuModeFreezesClock", MenuModeFreezesClock },
+		{ "CoalescesNearDeadlines", CoalescesNearDeadlines },
+	});
+}
@@ -0,0 +1,84 @@
+#include "TestPCH.h"
+#include "Misc/WorkerPool.h"
+
+namespace
+{
+	using Misc::WorkerPool;
+
+	void EveryIndexRunsOnce()
+	{
+		WorkerPool pool;
+		for (size_t count : { 0, 1, 7, 1000 }) {
+			std::vector<std::atomic<int>> runs(count);
+			pool.ParallelFor(count, [&](size_t i) { runs[i]++; }, 3);
+			for (auto& r : runs) {
+				CHECK(r == 1);
+			}
+		}
+	}
+
+	//With no workers the caller runs the whole batch itself.
+	void ZeroThreadsRunsOnCaller()
+	{
+		WorkerPool pool;
+		const auto caller = std::this_thread::get_id();
+		bool allOnCaller = true;
+		pool.ParallelFor(50, [&](size_t) { allOnCaller = allOnCaller && std::this_thread::get_id() == caller; }, 0);
+		CHECK(allOnCaller);
+	}
+
+	//Slow items keep workers busy past the caller's own share, ParallelFor still only returns once all of them are done.
+	void ReturnsOnceAllWorkersAreDone()
+	{
+		WorkerPool pool;
+		std::atomic<int> done = 0;
+		pool.ParallelFor(8, [&](size_t) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			done++;
+		}, 4);
+		CHECK(done == 8);
+	}
+
+	//Back to back batches never mix, a worker that wakes up late can't run indices of a batch that already finished.
+	void BatchesDontOverlap()
+	{
+		WorkerPool pool;
+		std::atomic<size_t> currentBatch = 0;
+		std::atomic<bool> mixed = false;
+		for (size_t b = 1; b <= 2000; b++) {
+			currentBatch = b;
+			std::vector<std::atomic<int>> runs(16);
+			pool.ParallelFor(runs.size(), [&](size_t i) {
+				if (currentBatch != b) {
+					mixed = true;
+				}
+				runs[i]++;
+			}, 2);
+			for (auto& r : runs) {
+				CHECK(r == 1);
+			}
+		}
+		CHECK(!mixed);
+	}
+
+	void StopAndReuse()
+	{
+		WorkerPool pool;
+		std::atomic<int> total = 0;
+		pool.ParallelFor(10, [&](size_t) { total++; }, 2);
+		pool.Stop();
+		pool.ParallelFor(10, [&](size_t) { total++; }, 2);
+		CHECK(total == 20);
+	}
+}
+
+int main()
+{
+	return Test::Run({
+		{ "EveryIndexRunsOnce", EveryIndexRunsOnce },
+		{ "ZeroThreadsRunsOnCaller", ZeroThreadsRunsOnCaller },
+		{ "ReturnsOnceAllWorkersAreDone", ReturnsOnceAllWorkersAreDone },
+		{ "BatchesDontOverlap", BatchesDontOverlap },
+		{ "StopAndReuse", StopAndReuse },
+	});
+}